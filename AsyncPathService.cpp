@@ -0,0 +1,224 @@
+#include "AsyncPathService.h"
+#include "CellGrid.h"
+#include "Pathfinding.h"
+#include "PathCache.h"
+#include "HierarchicalPathfinding.h"
+#include <algorithm>
+
+AsyncPathService* g_AsyncPathService = nullptr;
+
+// Results nobody polls (e.g. the unit died) are dropped after this many ticks
+const uint64_t UNCLAIMED_RESULT_TICKS = 600;
+
+AsyncPathService::CompletionQueue::CompletionQueue() : head(&stub), tail(&stub) {
+}
+
+void AsyncPathService::CompletionQueue::push(Completion* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Completion* prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+AsyncPathService::Completion* AsyncPathService::CompletionQueue::pop() {
+    Completion* first = tail;
+    Completion* next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (!next) return nullptr;
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail = next;
+        return first;
+    }
+    // first is the last node; a producer may be between its exchange and its store
+    if (first != head.load(std::memory_order_acquire)) return nullptr;
+    push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+AsyncPathService::AsyncPathService(int workerCount, int maxResultsPerTick)
+    : maxResultsPerTick(maxResultsPerTick) {
+    if (workerCount <= 0) {
+        // Leave a core for the main thread
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = std::max(1, std::min(4, cores - 1));
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&AsyncPathService::workerLoop, this);
+    }
+}
+
+AsyncPathService::~AsyncPathService() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stopping = true;
+    }
+    requestReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    while (Completion* node = completions.pop()) {
+        delete node;
+    }
+}
+
+void AsyncPathService::workerLoop() {
+    // This worker's own hierarchical planner, moved from snapshot to snapshot
+    // (it only reads the grid during findPath, after setGrid with the job's)
+    std::unique_ptr<HierarchicalPathfinder> hierarchical;
+    int plannedWidth = 0, plannedHeight = 0;
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestReady.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            job = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        const CellGrid& grid = *job.snapshot;
+        if (!hierarchical || plannedWidth != grid.getWidthInCells() || plannedHeight != grid.getHeightInCells()) {
+            hierarchical = std::make_unique<HierarchicalPathfinder>(grid);
+            plannedWidth = grid.getWidthInCells();
+            plannedHeight = grid.getHeightInCells();
+        }
+        hierarchical->setGrid(grid);
+
+        Completion* node = new Completion();
+        if (hierarchical->getRegionIndexAt(job.startX, job.startY) != hierarchical->getRegionIndexAt(job.goalX, job.goalY)) {
+            node->path = hierarchical->findPath(job.startX, job.startY, job.goalX, job.goalY, 3, &node->complete);
+        } else {
+            node->path = findPath(job.startX, job.startY, job.goalX, job.goalY, grid);
+        }
+        node->job = std::move(job);
+        completedCount.fetch_add(1, std::memory_order_relaxed);
+        completions.push(node);
+    }
+}
+
+PathTicket AsyncPathService::submit(int startX, int startY, int goalX, int goalY, const CellGrid& grid) {
+    liveGrid = &grid;
+    if (!snapshot || snapshotVersion != grid.getWalkabilityVersion()) {
+        snapshot = std::make_shared<const CellGrid>(grid.makeWalkabilitySnapshot());
+        snapshotVersion = grid.getWalkabilityVersion();
+    }
+
+    PathTicket ticket = nextTicket++;
+    if (nextTicket == 0) nextTicket = 1;
+
+    Job job{ ticket, startX, startY, goalX, goalY, snapshot, snapshotVersion, tick, Clock::now() };
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.push_back(std::move(job));
+    }
+    requestReady.notify_one();
+    inFlight.insert(ticket);
+    ++submittedCount;
+    return ticket;
+}
+
+PathPollStatus AsyncPathService::poll(PathTicket ticket, std::vector<std::pair<int, int>>& outPath, uint64_t* outSnapshotVersion) {
+    auto it = ready.find(ticket);
+    if (it == ready.end()) {
+        bool pending = inFlight.count(ticket) && !cancelled.count(ticket);
+        return pending ? PathPollStatus::Pending : PathPollStatus::Unknown;
+    }
+    outPath = std::move(it->second.path);
+    if (outSnapshotVersion) *outSnapshotVersion = it->second.snapshotVersion;
+    ready.erase(it);
+    return PathPollStatus::Ready;
+}
+
+void AsyncPathService::cancel(PathTicket ticket) {
+    if (ready.erase(ticket)) {
+        ++cancelledCount;
+        return;
+    }
+    // Collected, expired or never ours: nothing left to throw away
+    if (!inFlight.count(ticket)) return;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        auto it = std::find_if(requests.begin(), requests.end(), [ticket](const Job& job) {
+            return job.ticket == ticket;
+        });
+        if (it != requests.end()) {
+            requests.erase(it);
+            inFlight.erase(ticket);
+            ++cancelledCount;
+            return;
+        }
+    }
+    // Already running or waiting in the completion queue
+    cancelled.insert(ticket);
+}
+
+void AsyncPathService::beginTick() {
+    ++tick;
+
+    for (int taken = 0; taken < maxResultsPerTick; ) {
+        Completion* node = completions.pop();
+        if (!node) break;
+        ++drainedCount;
+
+        const Job& job = node->job;
+        inFlight.erase(job.ticket);
+        if (cancelled.erase(job.ticket)) {
+            ++cancelledCount;
+            delete node;
+            continue;
+        }
+
+        double latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - job.submitTime).count();
+        totalLatencyMs += latencyMs;
+        maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+        totalLatencyTicks += tick - job.submitTick;
+        ++integratedCount;
+
+        // Share the result with other units if it reaches the goal and the
+        // grid hasn't moved on since the snapshot
+        if (g_PathCache && liveGrid && node->complete && job.snapshotVersion == liveGrid->getWalkabilityVersion()) {
+            g_PathCache->store(job.startX, job.startY, job.goalX, job.goalY, node->path);
+        }
+
+        ready[job.ticket] = Result{ std::move(node->path), job.snapshotVersion, tick };
+        delete node;
+        ++taken;
+    }
+
+    // Drop results whose owner never came back for them
+    for (auto it = ready.begin(); it != ready.end(); ) {
+        if (tick - it->second.integratedTick > UNCLAIMED_RESULT_TICKS) {
+            it = ready.erase(it);
+            ++cancelledCount;
+        } else {
+            ++it;
+        }
+    }
+}
+
+AsyncPathStats AsyncPathService::getStats() const {
+    AsyncPathStats stats;
+    stats.submitted = submittedCount;
+    stats.integrated = integratedCount;
+    stats.cancelled = cancelledCount;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stats.queuedRequests = requests.size();
+    }
+    stats.awaitingIntegration = completedCount.load(std::memory_order_relaxed) - drainedCount;
+    if (integratedCount > 0) {
+        stats.averageLatencyMs = totalLatencyMs / integratedCount;
+        stats.averageLatencyTicks = static_cast<double>(totalLatencyTicks) / integratedCount;
+    }
+    stats.maxLatencyMs = maxLatencyMs;
+    return stats;
+}
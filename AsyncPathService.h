@@ -0,0 +1,148 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+class CellGrid; // Forward declaration
+
+// Ticket returned by AsyncPathService::submit; 0 is never a valid ticket
+typedef uint32_t PathTicket;
+
+enum class PathPollStatus {
+    Pending, // Still queued or being searched
+    Ready,   // outPath holds the result
+    Unknown  // Never submitted, cancelled, already collected or expired; submit again
+};
+
+struct AsyncPathStats {
+    size_t submitted = 0;           // Requests handed to the workers
+    size_t integrated = 0;          // Results handed back to the game
+    size_t cancelled = 0;           // Results dropped because nobody wanted them any more
+    size_t queuedRequests = 0;      // Waiting for a worker
+    size_t awaitingIntegration = 0; // Finished, held back by the per-tick cap
+    double averageLatencyMs = 0.0;  // Submit -> integrated
+    double maxLatencyMs = 0.0;
+    double averageLatencyTicks = 0.0;
+};
+
+// Off-thread path searches.
+//
+// Units submit a request and get a ticket back, then carry on with their
+// current action and poll the ticket on later ticks. Worker threads run the
+// search against an immutable walkability snapshot of the CellGrid taken when
+// the request was submitted (a new one is made only after walkability
+// changes), so they never touch live game state. Trips that cross a region
+// border go through a hierarchical planner each worker keeps for itself, and
+// may come back covering only the first few region hops; the rest through
+// findPath(). Finished searches are pushed onto a lock-free completion queue;
+// beginTick() moves at most maxResultsPerTick of them into the ready table at
+// the start of each tick, where poll() picks them up.
+class AsyncPathService {
+public:
+    explicit AsyncPathService(int workerCount = 0, int maxResultsPerTick = 16);
+    ~AsyncPathService();
+
+    AsyncPathService(const AsyncPathService&) = delete;
+    AsyncPathService& operator=(const AsyncPathService&) = delete;
+
+    PathTicket submit(int startX, int startY, int goalX, int goalY, const CellGrid& grid);
+
+    // Returns Ready once the result is in and fills outPath (empty = unreachable).
+    // outSnapshotVersion receives the walkability version the search ran
+    // against; a path from an older version may cross cells blocked since.
+    // A ticket can be collected only once, and a result nobody collects
+    // expires; both then report Unknown.
+    PathPollStatus poll(PathTicket ticket, std::vector<std::pair<int, int>>& outPath, uint64_t* outSnapshotVersion = nullptr);
+
+    // Give up on a ticket; its result is thrown away when it arrives
+    void cancel(PathTicket ticket);
+
+    // Integrate finished searches; call once at the start of every tick
+    void beginTick();
+
+    AsyncPathStats getStats() const;
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job {
+        PathTicket ticket;
+        int startX, startY, goalX, goalY;
+        std::shared_ptr<const CellGrid> snapshot;
+        uint64_t snapshotVersion;
+        uint64_t submitTick;
+        Clock::time_point submitTime;
+    };
+
+    // Node of the completion queue. Workers allocate it, the main thread frees it.
+    struct Completion {
+        std::atomic<Completion*> next{ nullptr };
+        Job job;
+        std::vector<std::pair<int, int>> path;
+        bool complete = true; // False if the path stops short of the goal (hierarchical trips)
+    };
+
+    // Multi-producer, single-consumer intrusive queue (Vyukov). Producers
+    // only do one atomic exchange and one store, so a worker never waits on
+    // the main thread or on another worker to hand a result back.
+    class CompletionQueue {
+    public:
+        CompletionQueue();
+        void push(Completion* node);
+        Completion* pop(); // Main thread only; nullptr if empty (or a push is mid-flight)
+    private:
+        std::atomic<Completion*> head;
+        Completion* tail;
+        Completion stub;
+    };
+
+    struct Result {
+        std::vector<std::pair<int, int>> path;
+        uint64_t snapshotVersion;
+        uint64_t integratedTick;
+    };
+
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    int maxResultsPerTick;
+
+    // Request queue (workers block on it when idle)
+    mutable std::mutex requestMutex;
+    std::condition_variable requestReady;
+    std::deque<Job> requests;
+    bool stopping = false;
+
+    CompletionQueue completions;
+    std::atomic<size_t> completedCount{ 0 };
+
+    // Main thread only
+    const CellGrid* liveGrid = nullptr;
+    std::shared_ptr<const CellGrid> snapshot;
+    uint64_t snapshotVersion = 0;
+    PathTicket nextTicket = 1;
+    uint64_t tick = 0;
+    std::unordered_map<PathTicket, Result> ready;
+    std::unordered_set<PathTicket> inFlight;  // Submitted, not yet drained from the completion queue
+    std::unordered_set<PathTicket> cancelled; // In flight, result to be thrown away
+    size_t submittedCount = 0;
+    size_t integratedCount = 0;
+    size_t cancelledCount = 0;
+    size_t drainedCount = 0;
+    double totalLatencyMs = 0.0;
+    double maxLatencyMs = 0.0;
+    uint64_t totalLatencyTicks = 0;
+};
+
+// Global async path service (created with the cell grid)
+extern AsyncPathService* g_AsyncPathService;
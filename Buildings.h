@@ -235,6 +235,7 @@ public:
     std::vector<House> houses;
 
     void addHouse(const House& s) { houses.push_back(s); }
+
     // Add more as needed
 };
 
@@ -1,6 +1,7 @@
 #include "CellGrid.h"
 
 #include <SDL.h>
+#include <algorithm>
 
 
 void CellGrid::gridToPixel(int gridX, int gridY, int& pixelX, int& pixelY) const {
@@ -8,17 +9,543 @@ pixelX = gridX * GRID_SIZE;
 pixelY = gridY * GRID_SIZE;
 }
 
+CellGrid::CellGrid(const CellGrid& source, WalkabilityOnly)
+    : widthInCells(source.widthInCells), heightInCells(source.heightInCells),
+      walkableBits(source.walkableBits),
+      widthInChunks(source.widthInChunks), heightInChunks(source.heightInChunks),
+      walkabilityLogBase(source.walkabilityLogBase), walkabilityLog(source.walkabilityLog),
+      componentLabels(source.componentLabels) {
+    // Every chunk reads as the shared empty one
+    chunkTable.assign(source.chunkTable.size(), 0);
+    chunks.push_back(std::make_shared<CellChunk>());
+    layerVersions[static_cast<int>(GridLayer::Walkability)] = source.getWalkabilityVersion();
+    chunkLayerVersions.assign(source.chunkLayerVersions.size(), 0);
+    for (size_t stamp = static_cast<int>(GridLayer::Walkability); stamp < chunkLayerVersions.size(); stamp += GRID_LAYER_COUNT) {
+        chunkLayerVersions[stamp] = source.chunkLayerVersions[stamp];
+    }
+}
+
+CellGrid CellGrid::makeWalkabilitySnapshot() const {
+    return CellGrid(*this, WalkabilityOnly());
+}
+
+CellGrid::CellChunk& CellGrid::writableChunkAt(int gridX, int gridY) {
+    int& slot = chunkTable[(gridY >> CHUNK_SHIFT) * widthInChunks + (gridX >> CHUNK_SHIFT)];
+    if (slot == 0) {
+        if (!freeChunks.empty()) {
+            slot = freeChunks.back();
+            freeChunks.pop_back();
+        } else {
+            slot = static_cast<int>(chunks.size());
+            chunks.push_back(std::make_shared<CellChunk>());
+        }
+        if (chunks[slot].use_count() > 1) {
+            chunks[slot] = std::make_shared<CellChunk>();
+        }
+        chunks[slot]->chunkX = gridX >> CHUNK_SHIFT;
+        chunks[slot]->chunkY = gridY >> CHUNK_SHIFT;
+        ++residentChunkCount;
+    } else if (chunks[slot].use_count() > 1) {
+        chunks[slot] = std::make_shared<CellChunk>(*chunks[slot]);
+    }
+    return *chunks[slot];
+}
+
+void CellGrid::releaseChunkIfEmpty(int gridX, int gridY) {
+    int& slot = chunkTable[(gridY >> CHUNK_SHIFT) * widthInChunks + (gridX >> CHUNK_SHIFT)];
+    if (slot == 0 || chunks[slot]->contentCount > 0) {
+        return;
+    }
+    // Every entry is back at its default, so the chunk can be reused as is
+    freeChunks.push_back(slot);
+    slot = 0;
+    --residentChunkCount;
+}
+
+void CellGrid::setCellTile(int gridX, int gridY, bool placed) {
+    if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells || hasTile(gridX, gridY) == placed) {
+        return;
+    }
+    CellChunk& chunk = writableChunkAt(gridX, gridY);
+    chunk.tileFlags[chunkCellIndex(gridX, gridY)] = placed ? 1 : 0;
+    chunk.contentCount += placed ? 1 : -1;
+    releaseChunkIfEmpty(gridX, gridY);
+    markChanged(GridLayer::Tiles, gridX, gridY);
+}
+
+void CellGrid::clearAll() {
+    std::vector<ChunkArea> resident;
+    forEachResidentChunk([&](const ChunkArea& area) { resident.push_back(area); });
+    // One version step per layer for the whole clear, stamped on the chunks it touched
+    uint64_t walkabilityVersion = ++layerVersions[static_cast<int>(GridLayer::Walkability)];
+    uint64_t tilesVersion = ++layerVersions[static_cast<int>(GridLayer::Tiles)];
+    for (const ChunkArea& area : resident) {
+        CellChunk& chunk = writableChunkAt(area.gridX, area.gridY);
+        int tiles = 0, blocked = 0;
+        for (int y = area.gridY; y < area.gridY + area.height; ++y) {
+            for (int x = area.gridX; x < area.gridX + area.width; ++x) {
+                int index = chunkCellIndex(x, y);
+                tiles += chunk.tileFlags[index];
+                blocked += walkableBits.isOpen(x, y) ? 0 : 1;
+                chunk.tileFlags[index] = 0;
+            }
+        }
+        chunk.contentCount -= tiles + blocked;
+        releaseChunkIfEmpty(area.gridX, area.gridY);
+        size_t stamps = static_cast<size_t>(area.chunkY * widthInChunks + area.chunkX) * GRID_LAYER_COUNT;
+        if (blocked > 0) chunkLayerVersions[stamps + static_cast<int>(GridLayer::Walkability)] = walkabilityVersion;
+        if (tiles > 0) chunkLayerVersions[stamps + static_cast<int>(GridLayer::Tiles)] = tilesVersion;
+    }
+    walkableBits.reset(widthInCells, heightInCells, true);
+    relabelAllComponents();
+    // The cell log cannot describe this; consumers fall back to the changed chunks
+    walkabilityLog.clear();
+    walkabilityLogBase = walkabilityVersion + 1;
+}
+
+void CellGrid::setCellWalkable(int gridX, int gridY, bool walkable) {
+    if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells ||
+        walkableBits.isOpen(gridX, gridY) == walkable) {
+        return;
+    }
+    walkableBits.set(gridX, gridY, walkable);
+    // Blocked cells keep their chunk resident, so chunk walks see the walls
+    writableChunkAt(gridX, gridY).contentCount += walkable ? -1 : 1;
+    releaseChunkIfEmpty(gridX, gridY);
+
+    int index = gridY * widthInCells + gridX;
+    if (walkable) {
+        onCellOpened(index);
+    } else {
+        onCellBlocked(index);
+    }
+
+    markChanged(GridLayer::Walkability, gridX, gridY);
+    if (walkabilityLog.size() >= WALKABILITY_LOG_LIMIT) {
+        // Drop the older half; consumers that far behind will do a full resync
+        size_t dropped = walkabilityLog.size() / 2;
+        walkabilityLog.erase(walkabilityLog.begin(), walkabilityLog.begin() + dropped);
+        walkabilityLogBase += dropped;
+    }
+    walkabilityLog.push_back(gridY * widthInCells + gridX);
+}
+
+bool CellGrid::getWalkabilityChangesSince(uint64_t sinceVersion, std::vector<int>& outCells) const {
+    if (sinceVersion >= getWalkabilityVersion()) {
+        return true;
+    }
+    if (sinceVersion + 1 < walkabilityLogBase) {
+        return false;
+    }
+    size_t first = static_cast<size_t>(sinceVersion + 1 - walkabilityLogBase);
+    outCells.insert(outCells.end(), walkabilityLog.begin() + first, walkabilityLog.end());
+    return true;
+}
+
+void CellGrid::getChangedChunksSince(GridLayer layer, uint64_t sinceVersion, std::vector<int>& outChunks) const {
+    if (sinceVersion >= getLayerVersion(layer)) {
+        return;
+    }
+    size_t chunkCount = chunkTable.size();
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        if (chunkLayerVersions[chunk * GRID_LAYER_COUNT + static_cast<int>(layer)] > sinceVersion) {
+            outChunks.push_back(static_cast<int>(chunk));
+        }
+    }
+}
+
+bool CellGrid::canReach(int startX, int startY, int goalX, int goalY) const {
+    if (startX < 0 || startX >= widthInCells || startY < 0 || startY >= heightInCells) {
+        return false;
+    }
+    if (startX == goalX && startY == goalY) {
+        return true;
+    }
+    int goal = getComponentId(goalX, goalY);
+    if (goal == -1) {
+        return false;
+    }
+    int start = getComponentId(startX, startY);
+    if (start != -1) {
+        return start == goal;
+    }
+    return getComponentId(startX + 1, startY) == goal || getComponentId(startX - 1, startY) == goal ||
+           getComponentId(startX, startY + 1) == goal || getComponentId(startX, startY - 1) == goal;
+}
+
+int CellGrid::allocateComponentLabel() {
+    if (!freeComponentLabels.empty()) {
+        int label = freeComponentLabels.back();
+        freeComponentLabels.pop_back();
+        return label;
+    }
+    componentSizes.push_back(0);
+    return static_cast<int>(componentSizes.size()) - 1;
+}
+
+void CellGrid::releaseComponentLabel(int label) {
+    componentSizes[label] = 0;
+    freeComponentLabels.push_back(label);
+}
+
+void CellGrid::relabelAllComponents() {
+    const int UNASSIGNED = -2;
+    int count = widthInCells * heightInCells;
+    componentLabels.assign(count, -1);
+    componentSizes.clear();
+    freeComponentLabels.clear();
+    componentVisitStamp.clear();
+    componentVisitOwner.clear();
+    componentVisitGeneration = 0;
+
+    for (int y = 0; y < heightInCells; ++y) {
+        for (int x = 0; x < widthInCells; ++x) {
+            if (walkableBits.isOpen(x, y)) componentLabels[y * widthInCells + x] = UNASSIGNED;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (componentLabels[i] != UNASSIGNED) continue;
+        int label = allocateComponentLabel();
+        componentSizes[label] = relabelComponent(i, UNASSIGNED, label);
+    }
+}
+
+int CellGrid::relabelComponent(int startCell, int fromLabel, int toLabel) {
+    std::vector<int> stack;
+    stack.push_back(startCell);
+    componentLabels[startCell] = toLabel;
+    int relabelled = 0;
+
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    while (!stack.empty()) {
+        int cell = stack.back();
+        stack.pop_back();
+        ++relabelled;
+        int x = cell % widthInCells;
+        int y = cell / widthInCells;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = x + dx[dir];
+            int ny = y + dy[dir];
+            if (nx < 0 || ny < 0 || nx >= widthInCells || ny >= heightInCells) continue;
+            int next = ny * widthInCells + nx;
+            if (componentLabels[next] != fromLabel) continue;
+            componentLabels[next] = toLabel;
+            stack.push_back(next);
+        }
+    }
+    return relabelled;
+}
+
+void CellGrid::onCellOpened(int cell) {
+    int x = cell % widthInCells;
+    int y = cell / widthInCells;
+    int neighbours[4] = {
+        getComponentId(x + 1, y), getComponentId(x - 1, y),
+        getComponentId(x, y + 1), getComponentId(x, y - 1)
+    };
+    int neighbourCells[4] = { cell + 1, cell - 1, cell + widthInCells, cell - widthInCells };
+
+    // Keep the biggest neighbouring component and pour the others into it
+    int keep = -1;
+    for (int label : neighbours) {
+        if (label != -1 && (keep == -1 || componentSizes[label] > componentSizes[keep])) keep = label;
+    }
+    if (keep == -1) {
+        keep = allocateComponentLabel();
+    }
+    for (int i = 0; i < 4; ++i) {
+        int label = neighbours[i];
+        if (label == -1 || label == keep || componentLabels[neighbourCells[i]] != label) continue;
+        componentSizes[keep] += relabelComponent(neighbourCells[i], label, keep);
+        releaseComponentLabel(label);
+    }
+    componentLabels[cell] = keep;
+    ++componentSizes[keep];
+}
+
+void CellGrid::onCellBlocked(int cell) {
+    int label = componentLabels[cell];
+    componentLabels[cell] = -1;
+    if (--componentSizes[label] == 0) {
+        releaseComponentLabel(label);
+        return;
+    }
+
+    int x = cell % widthInCells;
+    int y = cell / widthInCells;
+    int starts[4];
+    int count = 0;
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    for (int dir = 0; dir < 4; ++dir) {
+        if (getComponentId(x + dx[dir], y + dy[dir]) == label) {
+            starts[count++] = (y + dy[dir]) * widthInCells + x + dx[dir];
+        }
+    }
+    if (count <= 1) return;
+
+    // The neighbours may have been connected only through this cell. Flood
+    // from each of them in lockstep: floods that meet join up, and a group of
+    // floods that runs dry before meeting the rest is a piece that split off.
+    // Only the split-off pieces are walked in full, never the part that keeps
+    // the old label.
+    if (componentVisitStamp.empty()) {
+        componentVisitStamp.assign(componentLabels.size(), 0);
+        componentVisitOwner.assign(componentLabels.size(), 0);
+    }
+    if (++componentVisitGeneration == 0) {
+        std::fill(componentVisitStamp.begin(), componentVisitStamp.end(), 0);
+        componentVisitGeneration = 1;
+    }
+    std::vector<int> queues[4];
+    size_t heads[4] = { 0, 0, 0, 0 };
+    int group[4] = { 0, 1, 2, 3 };
+    bool split[4] = { false, false, false, false };
+    auto findGroup = [&group](int i) {
+        while (group[i] != i) i = group[i];
+        return i;
+    };
+    for (int i = 0; i < count; ++i) {
+        componentVisitStamp[starts[i]] = componentVisitGeneration;
+        componentVisitOwner[starts[i]] = static_cast<uint8_t>(i);
+        queues[i].push_back(starts[i]);
+    }
+
+    while (true) {
+        int activeGroups = 0;
+        for (int i = 0; i < count; ++i) {
+            if (findGroup(i) == i && !split[i]) ++activeGroups;
+        }
+        if (activeGroups <= 1) break;
+
+        // One step of every flood
+        for (int i = 0; i < count; ++i) {
+            if (split[findGroup(i)] || heads[i] >= queues[i].size()) continue;
+            int current = queues[i][heads[i]++];
+            int cx = current % widthInCells;
+            int cy = current / widthInCells;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = cx + dx[dir];
+                int ny = cy + dy[dir];
+                if (getComponentId(nx, ny) != label) continue;
+                int next = ny * widthInCells + nx;
+                if (componentVisitStamp[next] != componentVisitGeneration) {
+                    componentVisitStamp[next] = componentVisitGeneration;
+                    componentVisitOwner[next] = static_cast<uint8_t>(i);
+                    queues[i].push_back(next);
+                } else {
+                    int a = findGroup(i);
+                    int b = findGroup(componentVisitOwner[next]);
+                    if (a != b) group[b] = a;
+                }
+            }
+        }
+
+        // Groups whose floods have all run dry are separate components now
+        for (int root = 0; root < count; ++root) {
+            if (findGroup(root) != root || split[root]) continue;
+            bool exhausted = true;
+            for (int i = 0; i < count && exhausted; ++i) {
+                if (findGroup(i) == root && heads[i] < queues[i].size()) exhausted = false;
+            }
+            if (!exhausted) continue;
+
+            int remainingGroups = 0;
+            for (int i = 0; i < count; ++i) {
+                if (findGroup(i) == i && !split[i]) ++remainingGroups;
+            }
+            if (remainingGroups <= 1) break; // Last one standing keeps the old label
+
+            split[root] = true;
+            int newLabel = allocateComponentLabel();
+            for (int i = 0; i < count; ++i) {
+                if (findGroup(i) != root) continue;
+                for (int piece : queues[i]) componentLabels[piece] = newLabel;
+                componentSizes[newLabel] += static_cast<int>(queues[i].size());
+                componentSizes[label] -= static_cast<int>(queues[i].size());
+            }
+        }
+    }
+}
+
+void CellGrid::linkOccupant(int node, int cell) {
+    int x = cell % widthInCells;
+    int y = cell / widthInCells;
+    CellChunk& chunk = writableChunkAt(x, y);
+    int& head = chunk.occupantHeads[chunkCellIndex(x, y)];
+    if (head == -1) {
+        ++chunk.contentCount;
+    }
+    markChanged(GridLayer::Occupancy, x, y);
+    OccupantNode& entry = occupantNodes[node];
+    entry.cell = cell;
+    entry.prev = -1;
+    entry.next = head;
+    if (entry.next != -1) {
+        occupantNodes[entry.next].prev = node;
+    }
+    head = node;
+}
+
+void CellGrid::unlinkOccupant(int node) {
+    OccupantNode& entry = occupantNodes[node];
+    markChanged(GridLayer::Occupancy, entry.cell % widthInCells, entry.cell / widthInCells);
+    if (entry.next != -1) {
+        occupantNodes[entry.next].prev = entry.prev;
+    }
+    if (entry.prev != -1) {
+        occupantNodes[entry.prev].next = entry.next;
+        return;
+    }
+    int x = entry.cell % widthInCells;
+    int y = entry.cell / widthInCells;
+    CellChunk& chunk = writableChunkAt(x, y);
+    chunk.occupantHeads[chunkCellIndex(x, y)] = entry.next;
+    if (entry.next == -1) {
+        --chunk.contentCount;
+        releaseChunkIfEmpty(x, y);
+    }
+}
+
+void CellGrid::addOccupant(CellOccupant kind, int id, int gridX, int gridY) {
+    if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+        return;
+    }
+    int cell = gridY * widthInCells + gridX;
+    if (isBuildingOccupant(kind)) {
+        return;
+    }
+
+    auto found = occupantNodeIndex.find(occupantKey(kind, id));
+    if (found != occupantNodeIndex.end()) {
+        // Already listed somewhere: move it here
+        unlinkOccupant(found->second);
+        linkOccupant(found->second, cell);
+        return;
+    }
+    int node;
+    if (!freeOccupantNodes.empty()) {
+        node = freeOccupantNodes.back();
+        freeOccupantNodes.pop_back();
+    } else {
+        node = static_cast<int>(occupantNodes.size());
+        occupantNodes.push_back(OccupantNode());
+    }
+    occupantNodes[node].id = id;
+    occupantNodes[node].kind = kind;
+    linkOccupant(node, cell);
+    occupantNodeIndex[occupantKey(kind, id)] = node;
+}
+
+void CellGrid::removeOccupant(CellOccupant kind, int id, int gridX, int gridY) {
+    if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+        return;
+    }
+    int cell = gridY * widthInCells + gridX;
+    if (isBuildingOccupant(kind)) {
+        return;
+    }
+
+    auto found = occupantNodeIndex.find(occupantKey(kind, id));
+    if (found == occupantNodeIndex.end() || occupantNodes[found->second].cell != cell) {
+        return;
+    }
+    unlinkOccupant(found->second);
+    freeOccupantNodes.push_back(found->second);
+    occupantNodeIndex.erase(found);
+}
+
+void CellGrid::moveOccupant(CellOccupant kind, int id, int fromGridX, int fromGridY, int toGridX, int toGridY) {
+    if (fromGridX == toGridX && fromGridY == toGridY) {
+        return;
+    }
+    if (toGridX < 0 || toGridX >= widthInCells || toGridY < 0 || toGridY >= heightInCells) {
+        removeOccupant(kind, id, fromGridX, fromGridY);
+        return;
+    }
+    // Wherever it is listed now, addOccupant relinks the same node
+    addOccupant(kind, id, toGridX, toGridY);
+}
+
+void CellGrid::addBuildingFootprint(BuildingKind kind, int index, int gridX, int gridY) {
+    for (int dx = 0; dx < 3; ++dx) {
+        for (int dy = 0; dy < 3; ++dy) {
+            int x = gridX + dx;
+            int y = gridY + dy;
+            if (x < 0 || x >= widthInCells || y < 0 || y >= heightInCells || getBuildingAt(x, y).isValid()) {
+                continue;
+            }
+            CellChunk& chunk = writableChunkAt(x, y);
+            chunk.buildingSlots[chunkCellIndex(x, y)] = packBuildingSlot(kind, index, dx, dy);
+            ++chunk.contentCount;
+            markChanged(GridLayer::Buildings, x, y);
+        }
+    }
+}
+
+void CellGrid::removeBuildingFootprint(BuildingKind kind, int index, int gridX, int gridY) {
+    for (int dx = 0; dx < 3; ++dx) {
+        for (int dy = 0; dy < 3; ++dy) {
+            int x = gridX + dx;
+            int y = gridY + dy;
+            BuildingSlot slot = getBuildingAt(x, y);
+            if (!slot.is(kind) || slot.index != index) {
+                continue;
+            }
+            CellChunk& chunk = writableChunkAt(x, y);
+            chunk.buildingSlots[chunkCellIndex(x, y)] = -1;
+            --chunk.contentCount;
+            releaseChunkIfEmpty(x, y);
+            markChanged(GridLayer::Buildings, x, y);
+        }
+    }
+}
+
+GridChangeSubscriber::GridChangeSubscriber(const CellGrid& grid, std::initializer_list<GridLayer> layers)
+    : grid(grid), layers(layers) {
+    for (GridLayer layer : this->layers) {
+        syncedVersions.push_back(grid.getLayerVersion(layer));
+    }
+}
+
+bool GridChangeSubscriber::hasChanges() const {
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (grid.getLayerVersion(layers[i]) != syncedVersions[i]) return true;
+    }
+    return false;
+}
+
+void GridChangeSubscriber::takeChangedChunks(std::vector<int>& outChunks) {
+    if (!hasChanges()) {
+        return;
+    }
+    int widthInChunks = grid.getWidthInChunks();
+    int chunkCount = widthInChunks * grid.getHeightInChunks();
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (grid.getChunkVersion(layers[i], chunk % widthInChunks, chunk / widthInChunks) > syncedVersions[i]) {
+                outChunks.push_back(chunk);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < layers.size(); ++i) {
+        syncedVersions[i] = grid.getLayerVersion(layers[i]);
+    }
+}
+
 void renderCellGrid(SDL_Renderer* renderer, const CellGrid& cellGrid, bool showCellInfo) {
     // Draw grid lines with semi-transparent white
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 80);
     
-    int widthInPixels = cellGrid.getWidthInPixels();
-    int heightInPixels = cellGrid.getHeightInPixels();
-    int widthInCells = cellGrid.getWidthInCells();
-    int heightInCells = cellGrid.getHeightInCells();
-
-
-	
+    // Only the part of the world the window shows
+    int outputWidth = 0, outputHeight = 0;
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    int widthInPixels = std::min(cellGrid.getWidthInPixels(), outputWidth);
+    int heightInPixels = std::min(cellGrid.getHeightInPixels(), outputHeight);
+    int widthInCells = std::min(cellGrid.getWidthInCells(), (widthInPixels + GRID_SIZE - 1) / GRID_SIZE);
+    int heightInCells = std::min(cellGrid.getHeightInCells(), (heightInPixels + GRID_SIZE - 1) / GRID_SIZE);
     
     // Draw vertical lines
     for (int x = 0; x <= widthInCells; x++) {
@@ -32,44 +559,42 @@ void renderCellGrid(SDL_Renderer* renderer, const CellGrid& cellGrid, bool showC
         SDL_RenderDrawLine(renderer, 0, pixelY, widthInPixels, pixelY);
     }
     
-    // Optionally highlight cells with data
+    // Optionally highlight cells with data. Cells outside the resident
+    // chunks hold nothing and are walkable, so only those are walked.
     if (showCellInfo) {
-        for (int y = 0; y < heightInCells; y++) {
-            for (int x = 0; x < widthInCells; x++) {
-                const MapCell* cell = const_cast<CellGrid&>(cellGrid).getCell(x, y);
-                if (cell) {
+        const WalkabilityPlane& walkable = cellGrid.getWalkabilityPlane();
+        auto tint = [renderer](int pixelX, int pixelY, Uint8 r, Uint8 g, Uint8 b) {
+            SDL_SetRenderDrawColor(renderer, r, g, b, 30);
+            SDL_Rect rect = {pixelX, pixelY, GRID_SIZE, GRID_SIZE};
+            SDL_RenderFillRect(renderer, &rect);
+        };
+        cellGrid.forEachResidentChunkIn(0, 0, widthInCells, heightInCells, [&](const CellGrid::ChunkArea& area) {
+            for (int y = area.gridY; y < area.gridY + area.height; y++) {
+                for (int x = area.gridX; x < area.gridX + area.width; x++) {
                     int pixelX = x * GRID_SIZE;
                     int pixelY = y * GRID_SIZE;
                     
                     // Highlight cells with units (green tint)
-                    if (cell->hasUnits()) {
-                        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 30);
-                        SDL_Rect rect = {pixelX, pixelY, GRID_SIZE, GRID_SIZE};
-                        SDL_RenderFillRect(renderer, &rect);
+                    if (cellGrid.hasOccupant(CellOccupant::Unit, x, y)) {
+                        tint(pixelX, pixelY, 0, 255, 0);
                     }
                     
                     // Highlight cells with food (yellow tint)
-                    if (cell->hasFood()) {
-                        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 30);
-                        SDL_Rect rect = {pixelX, pixelY, GRID_SIZE, GRID_SIZE};
-                        SDL_RenderFillRect(renderer, &rect);
+                    if (cellGrid.hasOccupant(CellOccupant::Food, x, y)) {
+                        tint(pixelX, pixelY, 255, 255, 0);
                     }
                     
                     // Highlight cells with seeds (orange tint)
-                    if (cell->hasSeeds()) {
-                        SDL_SetRenderDrawColor(renderer, 255, 165, 0, 30);
-                        SDL_Rect rect = {pixelX, pixelY, GRID_SIZE, GRID_SIZE};
-                        SDL_RenderFillRect(renderer, &rect);
+                    if (cellGrid.hasOccupant(CellOccupant::Seed, x, y)) {
+                        tint(pixelX, pixelY, 255, 165, 0);
                     }
                     
                     // Highlight non-walkable cells (red tint)
-                    if (!cell->isWalkable) {
-                        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 30);
-                        SDL_Rect rect = {pixelX, pixelY, GRID_SIZE, GRID_SIZE};
-                        SDL_RenderFillRect(renderer, &rect);
+                    if (!walkable.isOpen(x, y)) {
+                        tint(pixelX, pixelY, 255, 0, 0);
                     }
                 }
             }
-        }
+        });
     }
 }
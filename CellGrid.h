@@ -1,72 +1,230 @@
 #pragma once
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <cstdlib>
+#include <initializer_list>
+#include <cstdint>
 #include "sdlWindow.h"
 #include "Food.h"
+#include "WalkabilityPlane.h"
 
 
 
 inline constexpr int GRID_SIZE = 40; // Choose your preferred size
 
 
+// Kinds of 3x3 building stamped into the grid's building plane
+enum class BuildingKind : uint8_t {
+    House,  // Index into HouseManager::houses
+    Farm,   // Index into FarmManager::farms
+    Market  // Index into MarketManager::markets
+};
+
+// The building covering a cell and which of its 3x3 slots the cell is, so
+// slot (dx, dy) lines up with the building's [dx][dy] arrays
+struct BuildingSlot {
+    BuildingKind kind = BuildingKind::House;
+    int index = -1;     // Position in its manager's vector, -1 if no building covers the cell
+    int dx = 0;
+    int dy = 0;
+
+    bool isValid() const { return index != -1; }
+    bool is(BuildingKind wanted) const { return index != -1 && kind == wanted; }
+};
+
+// Snapshot of one cell, assembled from the grid's per-cell planes. CellGrid
+// does not store MapCells; use its accessors to change a cell.
 struct MapCell {
-    int gridX;  // Cell x coordinate (in grid units, not pixels)
-    int gridY;  // Cell y coordinate (in grid units, not pixels)
-    
-    // References to objects in this cell
-    std::vector<int> unitIds;           // IDs of units in this cell
-    std::vector<int> foodIds;           // IDs of food items in this cell
-    std::vector<int> seedIds;           // IDs of seeds in this cell
-    std::vector<int> houseIds;          // IDs of houses overlapping this cell
-    
-    // Tile information
-    bool hasTile = false;               // Whether this cell has a placed tile
-     
-    
-    // Pathfinding information
-    bool isWalkable = true;             // Can units walk through this cell?
-    
-    MapCell() : gridX(0), gridY(0) {}
-    
+    int gridX = 0;          // Cell x coordinate (in grid units, not pixels)
+    int gridY = 0;          // Cell y coordinate (in grid units, not pixels)
+    bool isWalkable = false; // Can units walk through this cell? (set via CellGrid::setCellWalkable)
+    bool hasTile = false;   // Whether this cell has a placed tile
+    BuildingSlot building;  // Building covering this cell, if any
+
+    MapCell() {}
+
     MapCell(int x, int y) : gridX(x), gridY(y) {}
-    
-    // Clear all references
-    void clear() {
-        
-        
-        hasTile = false;
-        isWalkable = true;
-    }
-    
-    // Check if cell has any units
-    bool hasUnits() const {
-        return !unitIds.empty();
-    }
-    
-    // Check if cell has any food
-    bool hasFood() const {
-        return !foodIds.empty();
-    }
-    
-    // Check if cell has any seeds
-    bool hasSeeds() const {
-        return !seedIds.empty();
-    }
-    
-    // Check if cell has any houses
-    bool hasHouses() const {
-        return !houseIds.empty();
+
+    // Check if a building covers this cell
+    bool hasBuilding() const {
+        return building.isValid();
     }
 };
 
 
-// CellGrid manages a grid of MapCells for the entire game world
+// Kinds of thing CellGrid keeps track of per cell
+enum class CellOccupant {
+    Unit,  // Every live unit, in the cell it stands on
+    Food,  // Food lying in the cell (on the ground or in storage); carried food is not listed
+    Seed,  // Seeds lying in the cell, same rule as food
+    Coin,  // Coins lying in the cell, same rule as food
+    House, // Buildings, read from the building plane: the index of the house,
+    Farm,  // farm or market whose 3x3 area covers the cell (see addBuildingFootprint)
+    Market
+};
+
+// Parts of the grid whose changes are versioned separately (see CellGrid::getLayerVersion)
+enum class GridLayer {
+    Walkability, // setCellWalkable, clearAll
+    Occupancy,   // Units and items added, moved or removed
+    Buildings,   // Building footprints
+    Tiles        // setCellTile, clearAll
+};
+inline constexpr int GRID_LAYER_COUNT = 4;
+
+// CellGrid manages the cells of the entire game world.
+//
+// Walkability is one dense bitplane for the whole world (a 4096 x 4096
+// world takes 2 MB), because the searches scan it a word at a time.
+// Everything else a cell holds (tile flag, building plane, occupant list
+// head) lives in CHUNK_SIZE x CHUNK_SIZE chunks, each with its own small
+// planes, looked up through a flat table with one entry per chunk. Chunks
+// with nothing in them, no blocked cells included, all point at one shared
+// empty chunk that is never written; a chunk is allocated on the first
+// write into it and handed back once it is empty again. Reads stay O(1),
+// and passes over the contents (clearAll, the debug overlay, long-range
+// queries) walk only the resident chunks. Copies of the grid share chunks
+// until one side writes to them.
+//
+// Units and items are kept as one pooled node per occupant, linked into a
+// list per cell and found through a hash index by (kind, id). Adding or
+// removing an occupant inserts or erases its index entry (which may
+// allocate); moving one only looks its node up and relinks it.
 
 class CellGrid {
 private:
     int widthInCells;   // Width of grid in cells
     int heightInCells;  // Height of grid in cells
-    std::vector<MapCell> cells; // Flat array of cells (row-major order)
+    WalkabilityPlane walkableBits;  // Walkability, one bit per cell with a blocked border
+
+public:
+    static constexpr int CHUNK_SHIFT = 5;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT; // Chunks are CHUNK_SIZE x CHUNK_SIZE cells
+
+    // The cells one chunk covers (clipped at the grid's right and bottom edges)
+    struct ChunkArea {
+        int chunkX, chunkY;
+        int gridX, gridY;
+        int width, height;
+    };
+
+private:
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+    struct CellChunk {
+        uint8_t tileFlags[CHUNK_CELLS];  // Non-zero if a tile is placed there
+        int buildingSlots[CHUNK_CELLS];  // Packed BuildingSlot of the covering building, -1 if none
+        int occupantHeads[CHUNK_CELLS];  // First occupant node, -1 if empty
+        int chunkX = 0;
+        int chunkY = 0;
+        int contentCount = 0; // Tiles + house cells + occupied cells + blocked cells; 0 = empty
+
+        CellChunk() {
+            std::fill(std::begin(tileFlags), std::end(tileFlags), 0);
+            std::fill(std::begin(buildingSlots), std::end(buildingSlots), -1);
+            std::fill(std::begin(occupantHeads), std::end(occupantHeads), -1);
+        }
+    };
+
+    int widthInChunks;
+    int heightInChunks;
+    std::vector<int> chunkTable;                    // Per chunk, row-major; index into chunks
+    std::vector<std::shared_ptr<CellChunk>> chunks; // chunks[0] is the shared empty chunk
+    std::vector<int> freeChunks;                    // Slots of chunks handed back
+    int residentChunkCount = 0;
+
+    // Building plane entries: index << 6 | kind << 4 | dx * 3 + dy
+    static int packBuildingSlot(BuildingKind kind, int index, int dx, int dy) {
+        return (index << 6) | (static_cast<int>(kind) << 4) | (dx * 3 + dy);
+    }
+    static BuildingSlot unpackBuildingSlot(int packed) {
+        BuildingSlot slot;
+        if (packed == -1) return slot;
+        slot.kind = static_cast<BuildingKind>((packed >> 4) & 3);
+        slot.index = packed >> 6;
+        slot.dx = (packed & 15) / 3;
+        slot.dy = (packed & 15) % 3;
+        return slot;
+    }
+    static bool isBuildingOccupant(CellOccupant kind) {
+        return kind == CellOccupant::House || kind == CellOccupant::Farm || kind == CellOccupant::Market;
+    }
+    static BuildingKind buildingKindOf(CellOccupant kind) {
+        return kind == CellOccupant::Farm ? BuildingKind::Farm : kind == CellOccupant::Market ? BuildingKind::Market : BuildingKind::House;
+    }
+
+    static int chunkCellIndex(int gridX, int gridY) {
+        return ((gridY & CHUNK_MASK) << CHUNK_SHIFT) | (gridX & CHUNK_MASK);
+    }
+    const CellChunk& chunkAt(int gridX, int gridY) const {
+        return *chunks[chunkTable[(gridY >> CHUNK_SHIFT) * widthInChunks + (gridX >> CHUNK_SHIFT)]];
+    }
+    // Chunk for a write: allocated if the cell's chunk is still the empty
+    // one, copied first if another copy of the grid shares it
+    CellChunk& writableChunkAt(int gridX, int gridY);
+    // Hand the cell's chunk back once its contentCount has dropped to zero
+    void releaseChunkIfEmpty(int gridX, int gridY);
+
+    // Sparse occupancy (see addOccupant). Each listed unit or item owns one
+    // node, found through occupantNodeIndex by (kind, id), which gains a hash
+    // entry per occupant added; the nodes of a cell form a doubly-linked list
+    // starting at its chunk's occupantHeads.
+    struct OccupantNode {
+        int id;
+        int cell;   // Flat index of the cell the node is linked into
+        int prev;   // Node indices; -1 ends the list
+        int next;
+        CellOccupant kind;
+    };
+    std::vector<OccupantNode> occupantNodes;
+    std::vector<int> freeOccupantNodes;
+    std::unordered_map<uint64_t, int> occupantNodeIndex; // (kind, id) -> node
+
+    static uint64_t occupantKey(CellOccupant kind, int id) {
+        return (static_cast<uint64_t>(kind) << 32) | static_cast<uint32_t>(id);
+    }
+    void linkOccupant(int node, int cell);
+    void unlinkOccupant(int node);
+
+    // Change tracking (see getLayerVersion). Every change bumps its layer's
+    // version and stamps the chunk it happened in with the new version.
+    uint64_t layerVersions[GRID_LAYER_COUNT] = {};
+    std::vector<uint64_t> chunkLayerVersions; // [chunk * GRID_LAYER_COUNT + layer]
+    void markChanged(GridLayer layer, int gridX, int gridY) {
+        uint64_t version = ++layerVersions[static_cast<int>(layer)];
+        int chunk = (gridY >> CHUNK_SHIFT) * widthInChunks + (gridX >> CHUNK_SHIFT);
+        chunkLayerVersions[static_cast<size_t>(chunk) * GRID_LAYER_COUNT + static_cast<int>(layer)] = version;
+    }
+
+    // Walkability cell log (see getWalkabilityChangesSince); indexed by walkability version
+    uint64_t walkabilityLogBase = 1;        // Version of walkabilityLog[0]
+    std::vector<int> walkabilityLog;        // Flat index of each changed cell, in order
+    static constexpr size_t WALKABILITY_LOG_LIMIT = 4096;
+
+    // Connected components of walkable cells (see sameComponent). Kept up to
+    // date by setCellWalkable: opening a cell merges the components around it,
+    // blocking one checks whether its neighbours still connect.
+    std::vector<int> componentLabels;       // Per cell; -1 for blocked cells
+    std::vector<int> componentSizes;        // Cells per label; 0 means the label is free
+    std::vector<int> freeComponentLabels;
+    std::vector<uint32_t> componentVisitStamp; // Scratch for splitting, per cell; sized on first split
+    std::vector<uint8_t> componentVisitOwner;
+    uint32_t componentVisitGeneration = 0;
+
+    int allocateComponentLabel();
+    void releaseComponentLabel(int label);
+    void relabelAllComponents();
+    // Flood the cells labelled fromLabel that connect to startCell, giving them toLabel
+    int relabelComponent(int startCell, int fromLabel, int toLabel);
+    void onCellOpened(int cell);
+    void onCellBlocked(int cell);
+
+    struct WalkabilityOnly {};
+    CellGrid(const CellGrid& source, WalkabilityOnly);
     
 public:
 	int getWidthInCells() const { return widthInCells; }
@@ -78,27 +236,39 @@ public:
     CellGrid(int widthInPixels, int heightInPixels) {
         widthInCells = (widthInPixels + GRID_SIZE - 1) / GRID_SIZE;
         heightInCells = (heightInPixels + GRID_SIZE - 1) / GRID_SIZE;
-        cells.resize(widthInCells * heightInCells);
-        
-        // Initialize cell coordinates
-        for (int y = 0; y < heightInCells; y++) {
-            for (int x = 0; x < widthInCells; x++) {
-                int index = y * widthInCells + x;
-                cells[index] = MapCell(x, y);
-            }
-        }
+        widthInChunks = (widthInCells + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        heightInChunks = (heightInCells + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        chunkTable.assign(static_cast<size_t>(widthInChunks) * heightInChunks, 0);
+        chunkLayerVersions.assign(chunkTable.size() * GRID_LAYER_COUNT, 0);
+        chunks.push_back(std::make_shared<CellChunk>());
+        walkableBits.reset(widthInCells, heightInCells, true);
+        relabelAllComponents();
     }
+
+    // Copy of only what the path searches read, for worker threads to search
+    // while the live grid moves on: the dimensions, walkability bits,
+    // component labels and the walkability change history (so planners that
+    // sync incrementally can follow one snapshot to the next). Tiles,
+    // buildings and occupants read as empty. Not meant to be written to.
+    CellGrid makeWalkabilitySnapshot() const;
     
-    // Get cell at grid coordinates (in cells, not pixels)
-    MapCell* getCell(int gridX, int gridY) {
+    // Get cell at grid coordinates (in cells, not pixels). Cells off the grid
+    // read as blocked and empty.
+    MapCell getCell(int gridX, int gridY) const {
+        MapCell cell(gridX, gridY);
         if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
-            return nullptr;
+            return cell;
         }
-        return &cells[gridY * widthInCells + gridX];
+        const CellChunk& chunk = chunkAt(gridX, gridY);
+        int index = chunkCellIndex(gridX, gridY);
+        cell.isWalkable = walkableBits.isOpen(gridX, gridY);
+        cell.hasTile = chunk.tileFlags[index] != 0;
+        cell.building = unpackBuildingSlot(chunk.buildingSlots[index]);
+        return cell;
     }
     
     // Get cell at pixel coordinates
-    MapCell* getCellAtPixel(int pixelX, int pixelY) {
+    MapCell getCellAtPixel(int pixelX, int pixelY) const {
         int gridX = pixelX / GRID_SIZE;
         int gridY = pixelY / GRID_SIZE;
         return getCell(gridX, gridY);
@@ -114,24 +284,325 @@ public:
     void gridToPixel(int gridX, int gridY, int& pixelX, int& pixelY) const;
 
     
-    // Clear all cells
-    void clearAll() {
-        for (auto& cell : cells) {
-            cell.clear();
+    // Make every cell walkable and remove all tiles. Occupants and houses stay.
+    void clearAll();
+
+    // Change a cell's walkability. This is the only way to change it, so
+    // cached pathfinding data can see what changed.
+    void setCellWalkable(int gridX, int gridY, bool walkable);
+
+    bool hasTile(int gridX, int gridY) const {
+        if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+            return false;
         }
+        return chunkAt(gridX, gridY).tileFlags[chunkCellIndex(gridX, gridY)] != 0;
     }
+
+    void setCellTile(int gridX, int gridY, bool placed);
+
+    // Building covering the cell and the cell's slot in it; an invalid slot
+    // if there is none or the cell is off the grid
+    BuildingSlot getBuildingAt(int gridX, int gridY) const {
+        if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+            return BuildingSlot();
+        }
+        return unpackBuildingSlot(chunkAt(gridX, gridY).buildingSlots[chunkCellIndex(gridX, gridY)]);
+    }
+
+    int getWidthInChunks() const { return widthInChunks; }
+    int getHeightInChunks() const { return heightInChunks; }
+
+    // True if the chunk holds anything: tiles, houses, occupants or blocked cells
+    bool isChunkResident(int chunkX, int chunkY) const {
+        if (chunkX < 0 || chunkX >= widthInChunks || chunkY < 0 || chunkY >= heightInChunks) {
+            return false;
+        }
+        return chunkTable[chunkY * widthInChunks + chunkX] != 0;
+    }
+
+    int getResidentChunkCount() const { return residentChunkCount; }
+
+    // Call fn(const ChunkArea&) for every resident chunk, in no particular
+    // order. Cells outside these areas are walkable and hold nothing.
+    template <typename Fn>
+    void forEachResidentChunk(Fn fn) const {
+        for (size_t slot = 1; slot < chunks.size(); ++slot) {
+            if (chunks[slot]->contentCount > 0) fn(chunkArea(chunks[slot]->chunkX, chunks[slot]->chunkY));
+        }
+    }
+
+    // Same, limited to the chunks overlapping the width x height area at (gridX, gridY)
+    template <typename Fn>
+    void forEachResidentChunkIn(int gridX, int gridY, int width, int height, Fn fn) const {
+        int firstX = std::max(gridX, 0) >> CHUNK_SHIFT;
+        int firstY = std::max(gridY, 0) >> CHUNK_SHIFT;
+        int lastX = std::min(gridX + width - 1, widthInCells - 1);
+        int lastY = std::min(gridY + height - 1, heightInCells - 1);
+        if (lastX < 0 || lastY < 0) return;
+        for (int chunkY = firstY; chunkY <= (lastY >> CHUNK_SHIFT); ++chunkY) {
+            for (int chunkX = firstX; chunkX <= (lastX >> CHUNK_SHIFT); ++chunkX) {
+                if (chunkTable[chunkY * widthInChunks + chunkX] != 0) fn(chunkArea(chunkX, chunkY));
+            }
+        }
+    }
+
+    ChunkArea chunkArea(int chunkX, int chunkY) const {
+        ChunkArea area;
+        area.chunkX = chunkX;
+        area.chunkY = chunkY;
+        area.gridX = chunkX << CHUNK_SHIFT;
+        area.gridY = chunkY << CHUNK_SHIFT;
+        area.width = std::min(CHUNK_SIZE, widthInCells - area.gridX);
+        area.height = std::min(CHUNK_SIZE, heightInCells - area.gridY);
+        return area;
+    }
+
+    // Incremented every time any cell's walkability changes
+    uint64_t getWalkabilityVersion() const { return getLayerVersion(GridLayer::Walkability); }
+
+    // Append the flat indices (y * width + x) of cells changed after sinceVersion.
+    // Returns false if the log no longer reaches back that far; the caller can
+    // then fall back to getChangedChunksSince.
+    bool getWalkabilityChangesSince(uint64_t sinceVersion, std::vector<int>& outCells) const;
+
+    // Dirty-region tracking. Each layer has a version that only goes up, and
+    // each chunk remembers the version of its last change in every layer, so
+    // a consumer that stores the version it last synced at can ask which
+    // chunks changed since then and redo only those. Unlike the walkability
+    // cell log this never runs out; it is one comparison per chunk.
+    uint64_t getLayerVersion(GridLayer layer) const { return layerVersions[static_cast<int>(layer)]; }
+
+    // Version of the chunk's last change in that layer, 0 if it never changed
+    uint64_t getChunkVersion(GridLayer layer, int chunkX, int chunkY) const {
+        if (chunkX < 0 || chunkX >= widthInChunks || chunkY < 0 || chunkY >= heightInChunks) {
+            return 0;
+        }
+        return chunkLayerVersions[static_cast<size_t>(chunkY * widthInChunks + chunkX) * GRID_LAYER_COUNT + static_cast<int>(layer)];
+    }
+
+    // Append the indices (chunkY * widthInChunks + chunkX) of chunks whose
+    // layer changed after sinceVersion
+    void getChangedChunksSince(GridLayer layer, uint64_t sinceVersion, std::vector<int>& outChunks) const;
     
 	
     
     
+    // Connected-component label of a walkable cell, -1 if blocked or off the grid
+    int getComponentId(int gridX, int gridY) const {
+        if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+            return -1;
+        }
+        return componentLabels[gridY * widthInCells + gridX];
+    }
+
+    // True if both cells are walkable and connected to each other
+    bool sameComponent(int ax, int ay, int bx, int by) const {
+        int a = getComponentId(ax, ay);
+        return a != -1 && a == getComponentId(bx, by);
+    }
+
+    // O(1) answer to "can a path search from start reach goal?", with the same
+    // rules as the searches: start == goal always succeeds, and a start on a
+    // blocked cell (a unit standing on one) may step off to any walkable neighbour.
+    bool canReach(int startX, int startY, int goalX, int goalY) const;
+
     // Check if a cell is walkable (for pathfinding)
     bool isCellWalkable(int gridX, int gridY) const {
         if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
             return false;
         }
-        const MapCell& cell = cells[gridY * widthInCells + gridX];
-        return cell.isWalkable;
+        return walkableBits.isOpen(gridX, gridY);
+    }
+
+    // True if the whole width x height area at (gridX, gridY) is on the grid and walkable
+    bool isAreaWalkable(int gridX, int gridY, int width, int height) const {
+        return walkableBits.isAreaOpen(gridX, gridY, width, height);
+    }
+
+    // Walkability bits with a blocked border, for search loops that want to
+    // skip bounds checks (see WalkabilityPlane)
+    const WalkabilityPlane& getWalkabilityPlane() const { return walkableBits; }
+
+    // Occupancy. This is kept up to date by the code that spawns, moves,
+    // picks up, drops and deletes things, touching only the old and new
+    // cell; nothing rebuilds it per frame. Coordinates off the grid are
+    // ignored. clearAll leaves it alone.
+    //
+    // A unit or item is listed in at most one cell: adding one that is
+    // already listed moves it, and removing one from a cell it is not in
+    // does nothing. Buildings are not listed this way; the building kinds
+    // are only for queries, and footprints go in with addBuildingFootprint.
+    void addOccupant(CellOccupant kind, int id, int gridX, int gridY);
+    void removeOccupant(CellOccupant kind, int id, int gridX, int gridY);
+    // Same as remove + add, but does nothing when both cells are the same,
+    // and an occupant already listed keeps its node and index entry
+    void moveOccupant(CellOccupant kind, int id, int fromGridX, int fromGridY, int toGridX, int toGridY);
+
+    void addOccupantAtPixel(CellOccupant kind, int id, int pixelX, int pixelY) {
+        addOccupant(kind, id, pixelX / GRID_SIZE, pixelY / GRID_SIZE);
+    }
+    void removeOccupantAtPixel(CellOccupant kind, int id, int pixelX, int pixelY) {
+        removeOccupant(kind, id, pixelX / GRID_SIZE, pixelY / GRID_SIZE);
+    }
+    void moveOccupantAtPixel(CellOccupant kind, int id, int fromPixelX, int fromPixelY, int toPixelX, int toPixelY) {
+        moveOccupant(kind, id, fromPixelX / GRID_SIZE, fromPixelY / GRID_SIZE, toPixelX / GRID_SIZE, toPixelY / GRID_SIZE);
+    }
+
+    // Stamp a building's 3x3 area at (gridX, gridY) into the building plane,
+    // each cell with its slot, when the building is placed. index is its
+    // position in its manager's vector. Where footprints overlap, the
+    // building stamped first keeps the cell. Removal clears only the cells
+    // that still name the building; buildings it had covered stay hidden
+    // there, so a manager that erases one must re-stamp those that moved.
+    void addBuildingFootprint(BuildingKind kind, int index, int gridX, int gridY);
+    void removeBuildingFootprint(BuildingKind kind, int index, int gridX, int gridY);
+
+    // Call fn(id) for every occupant of that kind in the cell
+    template <typename Fn>
+    void forEachOccupant(CellOccupant kind, int gridX, int gridY, Fn fn) const {
+        visitCell(kind, gridX, gridY, [&](int id) {
+            fn(id);
+            return false;
+        });
+    }
+
+    bool hasOccupant(CellOccupant kind, int gridX, int gridY) const {
+        return visitCell(kind, gridX, gridY, [](int) { return true; });
+    }
+
+    // Append the IDs of every occupant of that kind in the cell to outIds
+    void getOccupants(CellOccupant kind, int gridX, int gridY, std::vector<int>& outIds) const {
+        forEachOccupant(kind, gridX, gridY, [&](int id) { outIds.push_back(id); });
+    }
+
+    // Spatial queries over the occupancy lists. Distance is counted in cell
+    // steps (|dx| + |dy|), the measure the game uses for "within N tiles",
+    // and cells are visited ring by ring outward from the centre, so the
+    // cost depends on the area searched rather than how many things exist.
+    // A negative radius searches the whole grid.
+
+    // Call fn(id, gridX, gridY) for every occupant within radius, nearest rings first
+    template <typename Fn>
+    void forEachInRadius(CellOccupant kind, int centerX, int centerY, int radius, Fn fn) const {
+        int last = clampRadius(centerX, centerY, radius);
+        for (int distance = 0; distance <= last; ++distance) {
+            visitRing(kind, centerX, centerY, distance, [&](int id, int x, int y) {
+                fn(id, x, y);
+                return false;
+            });
+        }
+    }
+
+    // Nearest occupant for which pred(id, gridX, gridY) holds, or -1. Stops at
+    // the first match; among equally near ones the first found wins.
+    template <typename Pred>
+    int findNearest(CellOccupant kind, int centerX, int centerY, int maxRadius, Pred pred,
+                    int* outGridX = nullptr, int* outGridY = nullptr) const {
+        int last = clampRadius(centerX, centerY, maxRadius);
+        int found = -1;
+        for (int distance = 0; distance <= last && found == -1; ++distance) {
+            visitRing(kind, centerX, centerY, distance, [&](int id, int x, int y) {
+                if (!pred(id, x, y)) return false;
+                found = id;
+                if (outGridX) *outGridX = x;
+                if (outGridY) *outGridY = y;
+                return true;
+            });
+        }
+        return found;
+    }
+
+    // Up to k nearest occupants for which pred(id, gridX, gridY) holds,
+    // appended to outIds nearest first
+    template <typename Pred>
+    void nearestK(CellOccupant kind, int centerX, int centerY, int k, int maxRadius, Pred pred, std::vector<int>& outIds) const {
+        int last = clampRadius(centerX, centerY, maxRadius);
+        int wanted = k;
+        for (int distance = 0; distance <= last && wanted > 0; ++distance) {
+            visitRing(kind, centerX, centerY, distance, [&](int id, int x, int y) {
+                if (!pred(id, x, y)) return false;
+                outIds.push_back(id);
+                return --wanted == 0;
+            });
+        }
+    }
+
+private:
+    // Visit the occupants of one cell; visit(id) returns true to stop.
+    // Returns true if stopped.
+    template <typename Visit>
+    bool visitCell(CellOccupant kind, int gridX, int gridY, Visit&& visit) const {
+        if (gridX < 0 || gridX >= widthInCells || gridY < 0 || gridY >= heightInCells) {
+            return false;
+        }
+        const CellChunk& chunk = chunkAt(gridX, gridY);
+        int index = chunkCellIndex(gridX, gridY);
+        if (isBuildingOccupant(kind)) {
+            BuildingSlot slot = unpackBuildingSlot(chunk.buildingSlots[index]);
+            return slot.is(buildingKindOf(kind)) && visit(slot.index);
+        }
+        for (int node = chunk.occupantHeads[index]; node != -1; node = occupantNodes[node].next) {
+            const OccupantNode& entry = occupantNodes[node];
+            if (entry.kind == kind && visit(entry.id)) return true;
+        }
+        return false;
     }
+
+    // Farthest ring worth visiting. Short searches keep their radius; past
+    // that, nothing lies beyond the farthest resident chunk.
+    int clampRadius(int centerX, int centerY, int radius) const {
+        if (radius >= 0 && radius <= CHUNK_SIZE) {
+            return radius;
+        }
+        int farthest = -1;
+        forEachResidentChunk([&](const ChunkArea& area) {
+            int dx = std::max(std::abs(centerX - area.gridX), std::abs(centerX - (area.gridX + area.width - 1)));
+            int dy = std::max(std::abs(centerY - area.gridY), std::abs(centerY - (area.gridY + area.height - 1)));
+            farthest = std::max(farthest, dx + dy);
+        });
+        return radius < 0 || radius > farthest ? farthest : radius;
+    }
+
+    // Visit the occupants of the cells exactly distance steps from the centre;
+    // visit(id, gridX, gridY) returns true to stop. Returns true if stopped.
+    template <typename Visit>
+    bool visitRing(CellOccupant kind, int centerX, int centerY, int distance, Visit&& visit) const {
+        auto visitAt = [&](int x, int y) {
+            return visitCell(kind, x, y, [&](int id) { return visit(id, x, y); });
+        };
+        if (distance == 0) {
+            return visitAt(centerX, centerY);
+        }
+        // The four edges of the diamond, each starting at a corner
+        for (int i = 0; i < distance; ++i) {
+            if (visitAt(centerX + distance - i, centerY + i)) return true;
+            if (visitAt(centerX - i, centerY + distance - i)) return true;
+            if (visitAt(centerX - distance + i, centerY - i)) return true;
+            if (visitAt(centerX + i, centerY - distance + i)) return true;
+        }
+        return false;
+    }
+};
+
+// A consumer's place in the grid's change history. It records the layer
+// versions it has caught up to; nothing is registered with the grid, so a
+// consumer can hold a const grid and subscribers cost nothing while idle.
+class GridChangeSubscriber {
+public:
+    // Starts caught up with the grid as it is now
+    GridChangeSubscriber(const CellGrid& grid, std::initializer_list<GridLayer> layers);
+
+    // True if any of the layers changed since the last takeChangedChunks
+    bool hasChanges() const;
+
+    // Append each chunk changed in any of the layers since the last call
+    // (once, however many layers changed) and catch up
+    void takeChangedChunks(std::vector<int>& outChunks);
+
+private:
+    const CellGrid& grid;
+    std::vector<GridLayer> layers;
+    std::vector<uint64_t> syncedVersions; // Per entry of layers
 };
 
 void renderCellGrid(SDL_Renderer* renderer, const CellGrid& cellGrid, bool showCellInfo = false);
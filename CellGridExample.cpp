@@ -16,15 +16,12 @@ void example1_InitializeAndUpdate() {
     int screenHeight = 600;
     CellGrid cellGrid(screenWidth, screenHeight);
     
-    // Assume we have these from the game state
-    std::unordered_map<int, Unit> units;
-    std::vector<Food> foods;
-    std::vector<Seed> seeds;
-    std::vector<House> houses;
-    std::unordered_map<GridKey, PlacedTile> placedTiles;
-    
-    // Update all cells with current game state (do this every frame)
-    cellGrid.updateAll(units, foods, seeds, houses, placedTiles);
+    // The cell lists are not rebuilt every frame. Whatever spawns, moves,
+    // picks up, drops or deletes something updates the cells it touches:
+    cellGrid.addOccupantAtPixel(CellOccupant::Unit, unitId, unitX, unitY);          // spawned
+    cellGrid.moveOccupantAtPixel(CellOccupant::Unit, unitId, oldX, oldY, newX, newY); // took a step
+    cellGrid.removeOccupantAtPixel(CellOccupant::Food, foodId, foodX, foodY);        // picked up or eaten
+    cellGrid.addBuildingFootprint(BuildingKind::House, houseIndex, houseGridX, houseGridY); // house built
 }
 
 // Example 2: Find nearest food using cell grid (O(r²) instead of O(n))
@@ -35,22 +32,23 @@ void example2_FindNearestFood(
     int gridWidth,
     int gridHeight
 ) {
-    int foodIndex, foodX, foodY;
+    int foodGridX, foodGridY;
     
-    // Search within 10 cells radius (400 pixels)
-    bool found = cellGrid.findNearestFood(
-        unit.x, unit.y,           // Unit's position
-        foodIndex, foodX, foodY,  // Output: found food info
-        foods,                    // Reference to food vector
-        10                        // Search radius in cells
-    );
+    // Search the cells within 10 steps, nearest ring first; only the food
+    // lists of those cells are looked at, however much food the world holds
+    int foodId = cellGrid.findNearest(CellOccupant::Food,
+        unit.x / GRID_SIZE, unit.y / GRID_SIZE,  // Unit's cell
+        10,                                       // Search radius in cells
+        [](int id, int gridX, int gridY) { return true; },
+        &foodGridX, &foodGridY);                  // Output: where the food is
+    bool found = foodId != -1;
     
     if (found) {
         // Create path to the food
         int ux = unit.x / GRID_SIZE;
         int uy = unit.y / GRID_SIZE;
         GridKey start{ux, uy, unit.layer};
-        GridKey goal{foodX / GRID_SIZE, foodY / GRID_SIZE, unit.layer};
+        GridKey goal{foodGridX, foodGridY, unit.layer};
         
         // Use normal pathfinding
         std::unordered_map<GridKey, PlacedTile> placedTiles; // from game state
@@ -105,31 +103,36 @@ void example4_QueryCellContents(
     int pixelY,
     CellGrid& cellGrid
 ) {
-    MapCell* cell = cellGrid.getCellAtPixel(pixelX, pixelY);
+    int gridX, gridY;
+    cellGrid.pixelToGrid(pixelX, pixelY, gridX, gridY);
     
-    if (cell) {
-        // Check cell contents
-        if (cell->hasUnits()) {
-            std::cout << "Cell has " << cell->unitIds.size() << " units:\n";
-            for (int unitId : cell->unitIds) {
-                std::cout << "  - Unit ID: " << unitId << "\n";
-            }
-        }
-        
-        if (cell->hasFood()) {
-            std::cout << "Cell has " << cell->foodIds.size() << " food items\n";
+    // Check cell contents
+    std::vector<int> unitIds;
+    cellGrid.getOccupants(CellOccupant::Unit, gridX, gridY, unitIds);
+    if (!unitIds.empty()) {
+        std::cout << "Cell has " << unitIds.size() << " units:\n";
+        for (int unitId : unitIds) {
+            std::cout << "  - Unit ID: " << unitId << "\n";
         }
-        
-        if (cell->hasSeeds()) {
-            std::cout << "Cell has " << cell->seedIds.size() << " seeds\n";
-        }
-        
-        if (!cell->isWalkable) {
-            std::cout << "Cell is blocked (wall or obstacle)\n";
-        }
-        
-        if (cell->hasTile && cell->tilePtr) {
-            std::cout << "Cell has a tile at layer " << cell->tilePtr->layer << "\n";
+    }
+    
+    if (cellGrid.hasOccupant(CellOccupant::Food, gridX, gridY)) {
+        std::cout << "Cell has food\n";
+    }
+    
+    if (cellGrid.hasOccupant(CellOccupant::Seed, gridX, gridY)) {
+        std::cout << "Cell has seeds\n";
+    }
+    
+    MapCell cell = cellGrid.getCell(gridX, gridY);
+    if (!cell.isWalkable) {
+        std::cout << "Cell is blocked (wall or obstacle)\n";
+    }
+    
+    if (cell.hasBuilding()) {
+        if (cell.building.is(BuildingKind::House)) {
+            std::cout << "Cell is slot (" << cell.building.dx << ", " << cell.building.dy << ") of house "
+                      << cell.building.index << "\n";
         }
     }
 }
@@ -154,13 +157,8 @@ void example5_FindUnitsInArea(
     // Iterate through cells in the area
     for (int y = startGridY; y <= endGridY; y++) {
         for (int x = startGridX; x <= endGridX; x++) {
-            MapCell* cell = cellGrid.getCell(x, y);
-            if (cell && cell->hasUnits()) {
-                // Add all units in this cell
-                for (int unitId : cell->unitIds) {
-                    outUnitIds.push_back(unitId);
-                }
-            }
+            // Add all units in this cell
+            cellGrid.getOccupants(CellOccupant::Unit, x, y, outUnitIds);
         }
     }
 }
@@ -278,15 +276,16 @@ bool example8_IsPositionSafe(
     // Search nearby cells for thieves (low morality units)
     for (int dy = -searchRadius; dy <= searchRadius; dy++) {
         for (int dx = -searchRadius; dx <= searchRadius; dx++) {
-            MapCell* cell = cellGrid.getCell(startGridX + dx, startGridY + dy);
-            if (cell && cell->hasUnits()) {
-                for (int unitId : cell->unitIds) {
-                    auto it = units.find(unitId);
-                    if (it != units.end() && it->second.morality < 30.0f) {
-                        // Found a thief nearby!
-                        return false;
-                    }
+            bool thief = false;
+            cellGrid.forEachOccupant(CellOccupant::Unit, startGridX + dx, startGridY + dy, [&](int unitId) {
+                auto it = units.find(unitId);
+                if (it != units.end() && it->second.morality < 30.0f) {
+                    thief = true;
                 }
+            });
+            if (thief) {
+                // Found a thief nearby!
+                return false;
             }
         }
     }
@@ -0,0 +1,251 @@
+#include "CooperativePlanner.h"
+#include "Pathfinding.h"
+#include <algorithm>
+#include <cstdlib>
+
+CooperativePlanner* g_CooperativePlanner = nullptr;
+
+namespace {
+    // Expired reservations of units that have not replanned are swept this often
+    const uint64_t PURGE_INTERVAL = 64;
+
+    // Wait in place, then the 4 moves
+    const int STEP_X[5] = { 0, 1, -1, 0, 0 };
+    const int STEP_Y[5] = { 0, 0, 0, 1, -1 };
+}
+
+CooperativePlanner::CooperativePlanner(const CellGrid& grid, int window, int replanInterval, int maxReplansPerTick)
+    : grid(grid), window(window), replanInterval(replanInterval), maxReplansPerTick(maxReplansPerTick) {
+}
+
+void CooperativePlanner::beginTick() {
+    ++tick;
+    replansThisTick = 0;
+    if (tick % PURGE_INTERVAL == 0) {
+        purgeExpired();
+    }
+}
+
+int CooperativePlanner::holderAt(int cell, uint64_t atTick) const {
+    auto it = reservations.find(makeKey(cell, atTick));
+    return it == reservations.end() ? -1 : it->second;
+}
+
+int CooperativePlanner::getReservation(int gridX, int gridY, uint64_t atTick) const {
+    if (gridX < 0 || gridY < 0 || gridX >= grid.getWidthInCells() || gridY >= grid.getHeightInCells()) {
+        return -1;
+    }
+    return holderAt(gridY * grid.getWidthInCells() + gridX, atTick);
+}
+
+bool CooperativePlanner::isFree(int cell, uint64_t fromTick, int ticks, int unitId) const {
+    for (int i = 0; i < ticks; ++i) {
+        int holder = holderAt(cell, fromTick + i);
+        if (holder != -1 && holder != unitId) return false;
+    }
+    return true;
+}
+
+bool CooperativePlanner::isSwap(int fromCell, int toCell, uint64_t arrivalTick, int unitId) const {
+    // Swapping places with a unit coming the other way
+    if (fromCell == toCell) return false;
+    int oncoming = holderAt(toCell, arrivalTick - 1);
+    return oncoming != -1 && oncoming != unitId && holderAt(fromCell, arrivalTick) == oncoming;
+}
+
+void CooperativePlanner::reserve(Agent& agent, int unitId, int cell, uint64_t fromTick, int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        uint64_t key = makeKey(cell, fromTick + i);
+        // First come, first served: never take over someone else's slot
+        if (reservations.emplace(key, unitId).second) {
+            agent.keys.push_back(key);
+        }
+    }
+}
+
+void CooperativePlanner::releaseKeys(Agent& agent, int unitId) {
+    for (uint64_t key : agent.keys) {
+        auto it = reservations.find(key);
+        if (it != reservations.end() && it->second == unitId) {
+            reservations.erase(it);
+        }
+    }
+    agent.keys.clear();
+}
+
+void CooperativePlanner::release(int unitId) {
+    auto it = agents.find(unitId);
+    if (it == agents.end()) return;
+    releaseKeys(it->second, unitId);
+    agents.erase(it);
+}
+
+void CooperativePlanner::purgeExpired() {
+    for (auto& entry : agents) {
+        auto& keys = entry.second.keys;
+        keys.erase(std::remove_if(keys.begin(), keys.end(), [&](uint64_t key) {
+            if ((key >> 32) >= tick) return false;
+            reservations.erase(key);
+            return true;
+        }), keys.end());
+    }
+}
+
+bool CooperativePlanner::update(int unitId, int gridX, int gridY, int ticksPerStep, UnitPath& path) {
+    if (path.empty()) {
+        release(unitId);
+        return false;
+    }
+    int w = grid.getWidthInCells();
+    if (gridX < 0 || gridY < 0 || gridX >= w || gridY >= grid.getHeightInCells()) return false;
+
+    Agent& agent = agents[unitId];
+    int steps = std::max(1, ticksPerStep);
+    // A new path, or a unit about to walk past the end of its reservations,
+    // is planned now. Routine replans wait for their turn and a quiet tick.
+    bool urgent = !path.sharesStorageWith(agent.plannedPath) || tick + 2 * steps >= agent.reservedUntil;
+    if (!urgent && tick < agent.nextReplanTick) return false;
+    if (!urgent && replansThisTick >= maxReplansPerTick) {
+        ++stats.deferred;
+        return false;
+    }
+    ++replansThisTick;
+    ++stats.replans;
+    // Fixed phase per unit so a crowd that starts walking together spreads out
+    agent.nextReplanTick = tick + replanInterval - (tick + static_cast<uint64_t>(unitId)) % replanInterval;
+
+    releaseKeys(agent, unitId);
+    agent.reservedUntil = 0;
+    int startCell = gridY * w + gridX;
+
+    // Aim for the cell `window` moves down the path. Waits left in it by an
+    // earlier window (and a leading copy of the start cell) are not moves, so
+    // they are skipped over and replanned from scratch.
+    UnitPath rest = path;
+    std::vector<std::pair<int, int>> head; // Path cells the window replaces
+    int moves = 0;
+    int targetCell = startCell;
+    while (!rest.empty() && moves < window) {
+        auto cell = rest.front();
+        rest.popFront();
+        head.push_back(cell);
+        int index = cell.second * w + cell.first;
+        if (index != targetCell) ++moves;
+        targetCell = index;
+    }
+
+    std::vector<int> planned;
+    if (!planWindow(unitId, startCell, targetCell, rest.empty(), steps, planned)) {
+        // Boxed in this tick: keep walking the path unreserved
+        agent.plannedPath = path;
+        return true;
+    }
+
+    bool followsPath = planned.size() == head.size();
+    for (size_t i = 0; followsPath && i < planned.size(); ++i) {
+        followsPath = planned[i] == head[i].second * w + head[i].first;
+    }
+    if (!followsPath) {
+        std::vector<std::pair<int, int>> cells;
+        int previous = startCell;
+        for (int cell : planned) {
+            if (cell == previous) ++stats.waitsInserted;
+            cells.emplace_back(cell % w, cell / w);
+            previous = cell;
+        }
+        if (planned.back() != targetCell) {
+            // The window ran out before the target: walk back onto the route
+            auto link = aStarFindPath(planned.back() % w, planned.back() / w, targetCell % w, targetCell / w, grid);
+            if (link.empty()) {
+                agent.plannedPath = path;
+                return true;
+            }
+            cells.insert(cells.end(), link.begin() + 1, link.end());
+        }
+        rest.forEachCell([&cells](int x, int y) { cells.emplace_back(x, y); });
+        path = UnitPath(cells);
+        ++stats.rerouted;
+    }
+
+    // Hold the current cell until the first step, then each planned cell for a step
+    reserve(agent, unitId, startCell, tick, steps);
+    for (size_t i = 0; i < planned.size(); ++i) {
+        reserve(agent, unitId, planned[i], tick + (i + 1) * steps, steps);
+    }
+    agent.reservedUntil = tick + (planned.size() + 1) * steps;
+    agent.plannedPath = path;
+    return true;
+}
+
+bool CooperativePlanner::planWindow(int unitId, int startCell, int targetCell, bool targetIsPathEnd, int ticksPerStep, std::vector<int>& outSteps) {
+    int w = grid.getWidthInCells();
+    int targetX = targetCell % w;
+    int targetY = targetCell / w;
+    auto distance = [w, targetX, targetY](int cell) {
+        return std::abs(cell % w - targetX) + std::abs(cell / w - targetY);
+    };
+    auto later = [](const OpenEntry& a, const OpenEntry& b) {
+        return a.f > b.f || (a.f == b.f && a.step < b.step);
+    };
+    const WalkabilityPlane& walkable = grid.getWalkabilityPlane();
+
+    nodes.clear();
+    open.clear();
+    visited.clear();
+    nodes.push_back({ startCell, 0, -1 });
+    open.push_back({ distance(startCell), 0, 0 });
+
+    // Every plan covers the whole window (waiting if it gets ahead), so the
+    // unit never runs past its reservations before the next replan. Only the
+    // end of the path may be reached early: the unit stops there.
+    int goal = -1;
+    int fallback = -1; // Deepest node, if nothing lasts the whole window
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), later);
+        int index = open.back().node;
+        open.pop_back();
+        Node current = nodes[index];
+
+        // f = window + distance here, so the first full-window node popped is the closest
+        if (current.step == window || (targetIsPathEnd && current.step > 0 && current.cell == targetCell)) {
+            goal = index;
+            break;
+        }
+        if (current.step > 0 && (fallback == -1 || current.step > nodes[fallback].step)) {
+            fallback = index;
+        }
+
+        int cx = current.cell % w;
+        int cy = current.cell / w;
+        int nextStep = current.step + 1;
+        uint64_t arrival = tick + static_cast<uint64_t>(nextStep) * ticksPerStep;
+        for (int action = 0; action < 5; ++action) {
+            int nx = cx + STEP_X[action];
+            int ny = cy + STEP_Y[action];
+            if (action != 0 && !walkable.isOpen(nx, ny)) continue;
+            int next = ny * w + nx;
+            if (!isFree(next, arrival, ticksPerStep, unitId)) continue;
+            if (isSwap(current.cell, next, arrival, unitId)) continue;
+            uint64_t state = (static_cast<uint64_t>(nextStep) << 32) | static_cast<uint32_t>(next);
+            if (!visited.emplace(state, static_cast<int>(nodes.size())).second) continue;
+            nodes.push_back({ next, nextStep, index });
+            open.push_back({ nextStep + distance(next), nextStep, static_cast<int>(nodes.size()) - 1 });
+            std::push_heap(open.begin(), open.end(), later);
+        }
+    }
+
+    int end = goal != -1 ? goal : fallback;
+    if (end == -1) return false;
+    outSteps.clear();
+    for (int index = end; nodes[index].parent != -1; index = nodes[index].parent) {
+        outSteps.push_back(nodes[index].cell);
+    }
+    std::reverse(outSteps.begin(), outSteps.end());
+    return true;
+}
+
+CooperativeStats CooperativePlanner::getStats() const {
+    CooperativeStats result = stats;
+    result.reservations = reservations.size();
+    return result;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include "CellGrid.h"
+#include "UnitPath.h"
+
+struct CooperativeStats {
+    size_t replans = 0;       // Windows planned
+    size_t deferred = 0;      // Routine replans pushed to a later tick by the per-tick cap
+    size_t rerouted = 0;      // Windows that changed the unit's path
+    size_t waitsInserted = 0; // Wait steps added to get out of someone's way
+    size_t reservations = 0;  // (cell, tick) pairs currently reserved
+};
+
+// Cooperative path following (Windowed Hierarchical Cooperative A*).
+//
+// Units keep walking the paths the ordinary planners give them; this only
+// looks a short window ahead. Each unit reserves the cells it will stand on
+// for the next `window` steps in a shared space-time reservation table, and
+// plans that window with a space-time A* (move or wait each step) that
+// avoids every cell another unit has reserved for that tick, plus swaps
+// through each other. If the window plan differs from the path, the path's
+// head is replaced and the window rejoins the original route.
+//
+// Time is counted in game ticks. A unit that needs several ticks per step
+// holds each cell for that many ticks. Replans are staggered: each unit
+// replans every replanInterval ticks, phased by its id, and at most
+// maxReplansPerTick of those routine windows are planned per tick, so the
+// cost per tick stays flat however many units are walking. A unit whose path
+// was changed by someone else, or that is about to run out of reserved
+// steps, replans on its next update regardless of the cap.
+//
+// Like any windowed scheme this is not complete: in a one-wide corridor a
+// unit can be boxed in by reservations made earlier in the tick, and then
+// walks its path unreserved until its next window.
+class CooperativePlanner {
+public:
+    explicit CooperativePlanner(const CellGrid& grid, int window = 8, int replanInterval = 4, int maxReplansPerTick = 64);
+
+    // Advance the reservation clock; call once at the start of every tick
+    void beginTick();
+
+    // Called every tick for each unit. Replans the unit's window when due,
+    // which may rewrite the head of path; a unit with an empty path gives
+    // up its reservations. Returns true if a window was planned.
+    bool update(int unitId, int gridX, int gridY, int ticksPerStep, UnitPath& path);
+
+    // Drop everything a unit has reserved (it stopped or was removed)
+    void release(int unitId);
+
+    // Unit holding (gridX, gridY) at tick, or -1
+    int getReservation(int gridX, int gridY, uint64_t tick) const;
+
+    uint64_t getTick() const { return tick; }
+    CooperativeStats getStats() const;
+
+private:
+    struct Agent {
+        std::vector<uint64_t> keys; // Reservations held
+        uint64_t nextReplanTick = 0;
+        uint64_t reservedUntil = 0; // First tick past the last reservation
+        UnitPath plannedPath;       // Path as of the last replan, to notice outside changes
+    };
+
+    struct Node {
+        int cell;
+        int step;
+        int parent; // Index into nodes
+    };
+
+    struct OpenEntry {
+        int f;    // step + distance to the window's target
+        int step; // Deeper nodes first on equal f
+        int node;
+    };
+
+    uint64_t makeKey(int cell, uint64_t atTick) const { return (atTick << 32) | static_cast<uint32_t>(cell); }
+    bool isFree(int cell, uint64_t fromTick, int ticks, int unitId) const;
+    int holderAt(int cell, uint64_t atTick) const;
+    bool isSwap(int fromCell, int toCell, uint64_t arrivalTick, int unitId) const;
+    void reserve(Agent& agent, int unitId, int cell, uint64_t fromTick, int ticks);
+    void releaseKeys(Agent& agent, int unitId);
+    void purgeExpired();
+
+    // Space-time A* over the window; fills outSteps with the cells for steps 1..k
+    bool planWindow(int unitId, int startCell, int targetCell, bool targetIsPathEnd, int ticksPerStep, std::vector<int>& outSteps);
+
+    const CellGrid& grid;
+    int window;
+    int replanInterval;
+    int maxReplansPerTick;
+
+    uint64_t tick = 0;
+    int replansThisTick = 0;
+    std::unordered_map<uint64_t, int> reservations; // (tick, cell) -> unit id
+    std::unordered_map<int, Agent> agents;
+
+    // Search scratch, reused between windows
+    std::vector<Node> nodes;
+    std::vector<OpenEntry> open;           // Min-heap on f
+    std::unordered_map<uint64_t, int> visited; // (step, cell) states already queued
+
+    CooperativeStats stats;
+};
+
+// Global cooperative planner (created with the cell grid)
+extern CooperativePlanner* g_CooperativePlanner;
@@ -0,0 +1,145 @@
+#include "FlowField.h"
+#include <iterator>
+
+FlowFieldService* g_FlowFieldService = nullptr;
+
+namespace {
+    const int DIR_X[4] = { 1, -1, 0, 0 };
+    const int DIR_Y[4] = { 0, 0, 1, -1 };
+    const int OPPOSITE[4] = { 1, 0, 3, 2 };
+
+    // Drop the demand table rather than let it grow with every goal ever asked for
+    const size_t DEMAND_TABLE_LIMIT = 4096;
+}
+
+FlowFieldService::FlowFieldService(const CellGrid& grid, size_t memoryBudgetBytes, int hotThreshold)
+    : grid(grid), memoryBudget(memoryBudgetBytes), hotThreshold(hotThreshold) {
+}
+
+size_t FlowFieldService::fieldBytes() const {
+    return static_cast<size_t>(grid.getWidthInCells()) * grid.getHeightInCells();
+}
+
+FlowFieldService::Field* FlowFieldService::findField(int goalCell) {
+    auto it = index.find(goalCell);
+    if (it == index.end()) return nullptr;
+
+    // Move to front (most recently used)
+    fields.splice(fields.begin(), fields, it->second);
+    Field& field = *it->second;
+    if (field.builtVersion != grid.getWalkabilityVersion()) {
+        build(field);
+    }
+    return &field;
+}
+
+FlowFieldService::Field& FlowFieldService::createField(int goalCell) {
+    // Evict least recently used fields until the new one fits (always keep room for one)
+    while (!fields.empty() && (fields.size() + 1) * fieldBytes() > memoryBudget) {
+        index.erase(fields.back().goalCell);
+        fields.pop_back();
+    }
+
+    fields.push_front(Field{ goalCell, 0, {} });
+    index[goalCell] = fields.begin();
+    demand.erase(goalCell);
+    build(fields.front());
+    return fields.front();
+}
+
+void FlowFieldService::build(Field& field) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    field.directions.assign(static_cast<size_t>(w) * h, DIR_NONE);
+    field.builtVersion = grid.getWalkabilityVersion();
+    ++rebuilds;
+
+    int goalX = field.goalCell % w;
+    int goalY = field.goalCell / w;
+    field.directions[field.goalCell] = DIR_GOAL;
+    if (!grid.isCellWalkable(goalX, goalY)) return;
+
+    const WalkabilityPlane& walkable = grid.getWalkabilityPlane();
+    queue.clear();
+    queue.push_back(field.goalCell);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue[head];
+        int x = cell % w;
+        int y = cell / w;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = x + DIR_X[dir];
+            int ny = y + DIR_Y[dir];
+            if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+            int next = ny * w + nx;
+            if (field.directions[next] != DIR_NONE) continue;
+
+            // The neighbour reaches the goal by stepping back toward this cell
+            field.directions[next] = static_cast<uint8_t>(OPPOSITE[dir]);
+            // Blocked cells get an arrow out (a unit may be standing on one) but never pass one on
+            if (walkable.isOpen(nx, ny)) {
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+void FlowFieldService::addDestination(int goalX, int goalY) {
+    int w = grid.getWidthInCells();
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= grid.getHeightInCells()) return;
+
+    int goalCell = goalY * w + goalX;
+    if (!findField(goalCell)) {
+        createField(goalCell);
+    }
+}
+
+bool FlowFieldService::getNextStep(int x, int y, int goalX, int goalY, int& outX, int& outY) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (x < 0 || y < 0 || x >= w || y >= h) return false;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return false;
+
+    Field* field = findField(goalY * w + goalX);
+    if (!field) return false;
+
+    uint8_t dir = field->directions[y * w + x];
+    if (dir == DIR_NONE) return false;
+    if (dir == DIR_GOAL) {
+        outX = x;
+        outY = y;
+        return true;
+    }
+    outX = x + DIR_X[dir];
+    outY = y + DIR_Y[dir];
+    return true;
+}
+
+bool FlowFieldService::tracePath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>>& outPath) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return false;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return false;
+
+    int goalCell = goalY * w + goalX;
+    Field* field = findField(goalCell);
+    if (!field) {
+        if (demand.size() >= DEMAND_TABLE_LIMIT) demand.clear();
+        if (++demand[goalCell] < hotThreshold) return false;
+        field = &createField(goalCell);
+    }
+
+    outPath.clear();
+    int x = startX;
+    int y = startY;
+    for (;;) {
+        uint8_t dir = field->directions[y * w + x];
+        if (dir == DIR_NONE) {
+            outPath.clear();
+            return true;
+        }
+        outPath.emplace_back(x, y);
+        if (dir == DIR_GOAL) return true;
+        x += DIR_X[dir];
+        y += DIR_Y[dir];
+    }
+}
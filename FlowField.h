@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include "CellGrid.h"
+
+// Flow fields for popular destinations (market stalls, houses, farms).
+//
+// A field is one reverse breadth-first search out from a goal cell that leaves
+// every cell holding a single direction byte: the neighbour to step to next.
+// Once a field exists, any unit's next step toward that goal is an O(1) read
+// and a full path is a straight walk down the arrows - no per-unit search.
+//
+// Fields are built for goals that are registered up front (markets) or that
+// have been asked for often enough to count as hot (houses, farms). They are
+// rebuilt lazily on the first read after the grid's walkability version moves,
+// and the least recently used fields are evicted to stay under the memory
+// budget.
+class FlowFieldService {
+public:
+    explicit FlowFieldService(const CellGrid& grid, size_t memoryBudgetBytes = 256 * 1024, int hotThreshold = 3);
+
+    // Build a field for this goal now instead of waiting for it to become hot
+    void addDestination(int goalX, int goalY);
+
+    // Next cell to step to from (x, y) toward the goal. Returns false if there
+    // is no field for the goal or the goal cannot be reached from (x, y).
+    bool getNextStep(int x, int y, int goalX, int goalY, int& outX, int& outY);
+
+    // Fill outPath (start and goal inclusive, empty if unreachable) by walking
+    // the goal's field. Returns false if the goal has no field yet; each such
+    // miss counts toward making the goal hot.
+    bool tracePath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>>& outPath);
+
+    size_t getFieldCount() const { return fields.size(); }
+    size_t getMemoryUsage() const { return fields.size() * fieldBytes(); }
+    size_t getRebuildCount() const { return rebuilds; }
+
+private:
+    // Direction byte values: 0-3 index DIR_X/DIR_Y, plus these markers
+    static constexpr uint8_t DIR_GOAL = 4;
+    static constexpr uint8_t DIR_NONE = 0xFF;
+
+    struct Field {
+        int goalCell;
+        uint64_t builtVersion;
+        std::vector<uint8_t> directions; // One byte per cell
+    };
+
+    size_t fieldBytes() const;
+    // Returns the up-to-date field for the goal, or nullptr if it has none
+    Field* findField(int goalCell);
+    Field& createField(int goalCell);
+    void build(Field& field);
+
+    const CellGrid& grid;
+    size_t memoryBudget;
+    int hotThreshold;
+    std::list<Field> fields;                                     // Most recently used first
+    std::unordered_map<int, std::list<Field>::iterator> index;   // Goal cell -> field
+    std::unordered_map<int, int> demand;                         // Goal cell -> misses so far
+    std::vector<int> queue;                                      // BFS scratch, reused between builds
+    size_t rebuilds = 0;
+};
+
+// Global flow field service (created with the cell grid)
+extern FlowFieldService* g_FlowFieldService;
@@ -34,22 +34,58 @@ bool FoodManager::initializeFont(const char* fontPath, int fontSize) {
     return true;
 }
 
-void FoodManager::spawnFood(int x, int y, const std::string& type) {
-    static int nextFoodId = 1; // Static to ensure unique IDs
-    food.emplace_back(x, y, 'f', type, 100, nextFoodId++);
-    std::cout << "Spawned food '" << type << "' at (" << x << ", " << y << ") with id " << (nextFoodId-1) << std::endl;
+void FoodManager::spawnFood(int x, int y, const std::string& type, CellGrid* cellGrid) {
+    Food& spawned = addFood(x, y, type);
+    if (cellGrid) {
+        cellGrid->addOccupantAtPixel(CellOccupant::Food, spawned.foodId, x, y);
+    }
+    std::cout << "Spawned food '" << type << "' at (" << x << ", " << y << ") with id " << spawned.foodId << std::endl;
+}
+
+Food& FoodManager::addFood(int x, int y, const std::string& type, int foodValue) {
+    int handle = food.insert(Food(x, y, 'f', type, foodValue));
+    Food& added = food.get(handle);
+    added.foodId = handle;
+    freeFood.insert(handle);
+    return added;
 }
 
-bool FoodManager::deleteFoodAt(int x, int y) {
+bool FoodManager::removeFood(int foodId) {
+    freeFood.erase(foodId);
+    return food.erase(foodId);
+}
+
+void FoodManager::setCarriedBy(Food& item, int unitId) {
+    item.carriedByUnitId = unitId;
+    updateFreeFood(item);
+}
+
+void FoodManager::setOwnedBy(Food& item, int houseOwnerId) {
+    item.ownedByHouseId = houseOwnerId;
+    updateFreeFood(item);
+}
+
+void FoodManager::updateFreeFood(const Food& item) {
+    if (item.carriedByUnitId == -1 && item.ownedByHouseId == -1) {
+        freeFood.insert(item.foodId);
+    } else {
+        freeFood.erase(item.foodId);
+    }
+}
+
+bool FoodManager::deleteFoodAt(int x, int y, CellGrid* cellGrid) {
     // Use a larger click area to make it easier to select food
     const int clickRadius = 20;
     
-    for (auto it = food.begin(); it != food.end(); ++it) {
+    for (auto it = food.getItems().begin(); it != food.getItems().end(); ++it) {
         // Check if click is within the food's bounding box
         if (x >= it->x - clickRadius && x <= it->x + clickRadius &&
             y >= it->y - clickRadius && y <= it->y + clickRadius) {
             std::cout << "Deleted food '" << it->type << "' (id " << it->foodId << ") at (" << it->x << ", " << it->y << ")" << std::endl;
-            food.erase(it);
+            if (cellGrid && it->carriedByUnitId == -1) {
+                cellGrid->removeOccupantAtPixel(CellOccupant::Food, it->foodId, it->x, it->y);
+            }
+            removeFood(it->foodId);
             return true;
         }
     }
@@ -63,7 +99,7 @@ void FoodManager::renderFood(SDL_Renderer* renderer) {
     
     SDL_Color color = {255, 255, 0, 255}; // Yellow color
     
-    for (const auto& foodItem : food) {
+    for (const auto& foodItem : food.getItems()) {
         // Create surface with the food symbol
         std::string symbolStr(1, foodItem.symbol);
         SDL_Surface* surface = TTF_RenderText_Solid(font, symbolStr.c_str(), color);
@@ -156,12 +192,8 @@ void FoodManager::renderCoinCount(SDL_Renderer* renderer, int x, int y, int coun
     SDL_FreeSurface(surface);
 }
 
-std::vector<Food>& FoodManager::getFood() {
-    return food;
-}
-
 const std::vector<Food>& FoodManager::getFood() const {
-    return food;
+    return food.getItems();
 }
 
 SeedManager::SeedManager() : font(nullptr) {
@@ -196,10 +228,68 @@ bool SeedManager::initializeFont(const char* fontPath, int fontSize) {
     return true;
 }
 
-void SeedManager::spawnSeed(int x, int y, const std::string& type) {
-    static int nextSeedId = 1; // Static to ensure unique IDs
-    seeds.emplace_back(x, y, type, nextSeedId++);
-    std::cout << "Spawned seed '" << type << "' at (" << x << ", " << y << ") with id " << (nextSeedId-1) << std::endl;
+void SeedManager::spawnSeed(int x, int y, const std::string& type, CellGrid* cellGrid) {
+    Seed& spawned = addSeed(x, y, type);
+    if (cellGrid) {
+        cellGrid->addOccupantAtPixel(CellOccupant::Seed, spawned.seedId, x, y);
+    }
+    std::cout << "Spawned seed '" << type << "' at (" << x << ", " << y << ") with id " << spawned.seedId << std::endl;
+}
+
+Seed& SeedManager::addSeed(int x, int y, const std::string& type) {
+    int handle = seeds.insert(Seed(x, y, type, -1));
+    Seed& added = seeds.get(handle);
+    added.seedId = handle;
+    index(added);
+    return added;
+}
+
+bool SeedManager::removeSeed(int seedId) {
+    const Seed* seed = seeds.tryGet(seedId);
+    if (!seed) {
+        return false;
+    }
+    unindex(*seed);
+    return seeds.erase(seedId);
+}
+
+void SeedManager::index(const Seed& seed) {
+    if (seed.carriedByUnitId == -1 && seed.plantedInFarm == -1) {
+        collectableByOwner[seed.ownedByHouseId].insert(seed.seedId);
+    }
+}
+
+void SeedManager::unindex(const Seed& seed) {
+    auto bucket = collectableByOwner.find(seed.ownedByHouseId);
+    if (bucket != collectableByOwner.end()) {
+        bucket->second.erase(seed.seedId);
+        if (bucket->second.empty()) {
+            collectableByOwner.erase(bucket);
+        }
+    }
+}
+
+void SeedManager::setCarriedBy(Seed& seed, int unitId) {
+    unindex(seed);
+    seed.carriedByUnitId = unitId;
+    index(seed);
+}
+
+void SeedManager::setOwnedBy(Seed& seed, int houseOwnerId) {
+    unindex(seed);
+    seed.ownedByHouseId = houseOwnerId;
+    index(seed);
+}
+
+void SeedManager::setPlantedInFarm(Seed& seed, int farmIndex) {
+    unindex(seed);
+    seed.plantedInFarm = farmIndex;
+    index(seed);
+}
+
+bool SeedManager::hasCollectableSeed(int unitId) const {
+    // Empty buckets are dropped, so finding one means it holds a seed
+    return collectableByOwner.count(-1) != 0 || collectableByOwner.count(unitId) != 0;
 }
 
 void SeedManager::renderSeeds(SDL_Renderer* renderer) {
@@ -209,7 +299,7 @@ void SeedManager::renderSeeds(SDL_Renderer* renderer) {
     
     SDL_Color color = {255, 255, 255, 255}; // White color for seeds (high visibility)
     
-    for (const auto& seedItem : seeds) {
+    for (const auto& seedItem : seeds.getItems()) {
         // Create surface with the seed symbol
         std::string symbolStr(1, seedItem.symbol);
         SDL_Surface* surface = TTF_RenderText_Solid(font, symbolStr.c_str(), color);
@@ -229,12 +319,8 @@ void SeedManager::renderSeeds(SDL_Renderer* renderer) {
     }
 }
 
-std::vector<Seed>& SeedManager::getSeeds() {
-    return seeds;
-}
-
 const std::vector<Seed>& SeedManager::getSeeds() const {
-    return seeds;
+    return seeds.getItems();
 }
 
 CoinManager::CoinManager() : font(nullptr) {
@@ -269,10 +355,17 @@ bool CoinManager::initializeFont(const char* fontPath, int fontSize) {
     return true;
 }
 
-void CoinManager::spawnCoin(int x, int y) {
-    static int nextCoinId = 1; // Static to ensure unique IDs
-    coins.emplace_back(x, y, nextCoinId++);
-    std::cout << "Spawned coin at (" << x << ", " << y << ") with id " << (nextCoinId-1) << std::endl;
+void CoinManager::spawnCoin(int x, int y, CellGrid* cellGrid) {
+    int handle = coins.insert(Coin(x, y, -1));
+    coins.get(handle).coinId = handle;
+    if (cellGrid) {
+        cellGrid->addOccupantAtPixel(CellOccupant::Coin, handle, x, y);
+    }
+    std::cout << "Spawned coin at (" << x << ", " << y << ") with id " << handle << std::endl;
+}
+
+bool CoinManager::removeCoin(int coinId) {
+    return coins.erase(coinId);
 }
 
 void CoinManager::renderCoins(SDL_Renderer* renderer) {
@@ -282,7 +375,7 @@ void CoinManager::renderCoins(SDL_Renderer* renderer) {
     
     SDL_Color color = {255, 215, 0, 255}; // Gold color
     
-    for (const auto& coinItem : coins) {
+    for (const auto& coinItem : coins.getItems()) {
         // Render all coins - carried coins move with units via Unit::processAction
         // Coins in houses and at stalls are positioned at their storage locations
         
@@ -305,10 +398,14 @@ void CoinManager::renderCoins(SDL_Renderer* renderer) {
     }
 }
 
-std::vector<Coin>& CoinManager::getCoins() {
-    return coins;
+void CoinManager::setCarriedBy(Coin& coin, int unitId) {
+    coin.carriedByUnitId = unitId;
+}
+
+void CoinManager::setOwnedBy(Coin& coin, int houseOwnerId) {
+    coin.ownedByHouseId = houseOwnerId;
 }
 
 const std::vector<Coin>& CoinManager::getCoins() const {
-    return coins;
+    return coins.getItems();
 }
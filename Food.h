@@ -2,8 +2,11 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include <unordered_set>
+#include <unordered_map>
 #include <SDL.h>
 #include <SDL_ttf.h>
+#include "SlotMap.h"
 
 
 
@@ -27,11 +30,23 @@ public:
 	 }
 };
 
+// Items live in a generational slot map and their ids are its handles, so
+// an id kept after the item is removed (in house storage, a farm plot or a
+// market stall) reads as missing rather than naming some other item. Add and
+// remove items only through the manager; removal moves the last item into
+// the gap, so it invalidates pointers to that item and changes the order.
+//
+// The manager also keeps the set of free food (carried by nobody, owned by
+// nobody), so "is there any free food" needs no scan. Change carriedByUnitId
+// and ownedByHouseId only through setCarriedBy / setOwnedBy.
 class FoodManager {
 private:
-    std::vector<Food> food;
+    SlotMap<Food> food;
+    std::unordered_set<int> freeFood; // Ids of food nobody carries or owns
     TTF_Font* font;
 
+    void updateFreeFood(const Food& item);
+
 public:
     FoodManager();
     ~FoodManager();
@@ -39,11 +54,33 @@ public:
     // Initialize font for rendering
     bool initializeFont(const char* fontPath, int fontSize);
 
-    // Spawn food with f symbol at given position
-    void spawnFood(int x, int y, const std::string& type);
+    // Spawn food with f symbol at given position, listing it in its cell if a grid is given
+    void spawnFood(int x, int y, const std::string& type, CellGrid* cellGrid = nullptr);
 
     // Delete food at given pixel position (returns true if food was deleted)
-    bool deleteFoodAt(int x, int y);
+    bool deleteFoodAt(int x, int y, CellGrid* cellGrid = nullptr);
+
+    // Add a food item under a fresh handle (not listed in any cell)
+    Food& addFood(int x, int y, const std::string& type, int foodValue = 100);
+
+    // Remove a food item by id (returns false if there is none). The caller
+    // takes it off the grid first.
+    bool removeFood(int foodId);
+
+    // Food item by id; get requires it to exist, tryGet returns nullptr for
+    // -1 and for ids of removed food
+    Food& get(int foodId) { return food.get(foodId); }
+    const Food& get(int foodId) const { return food.get(foodId); }
+    Food* tryGet(int foodId) { return food.tryGet(foodId); }
+    const Food* tryGet(int foodId) const { return food.tryGet(foodId); }
+    bool contains(int foodId) const { return food.contains(foodId); }
+
+    // Hand a food item to a unit / house owner (-1 for nobody)
+    void setCarriedBy(Food& item, int unitId);
+    void setOwnedBy(Food& item, int houseOwnerId);
+
+    bool hasFreeFood() const { return !freeFood.empty(); }
+    const std::unordered_set<int>& getFreeFood() const { return freeFood; }
 
     // Render all units
     void renderFood(SDL_Renderer* renderer);
@@ -58,7 +95,6 @@ public:
     void renderCoinCount(SDL_Renderer* renderer, int x, int y, int count);
 
     
-    std::vector<Food>& getFood();
     const std::vector<Food>& getFood() const;
 
 	TTF_Font* getFont() const { return font; }
@@ -73,18 +109,27 @@ public:
     int seedId;
     int carriedByUnitId; // -1 if not carried, otherwise the unit ID carrying it
     int ownedByHouseId;  // -1 if not owned, otherwise the house owner's unit ID
+    int plantedInFarm;   // -1 if not planted, otherwise the farm's index in g_FarmManager
     
     Seed(int x, int y, const std::string& type, int seedId)
 		: x(x), y(y), symbol('.'), type(type), seedId(seedId), 
-		  carriedByUnitId(-1), ownedByHouseId(-1) {
+		  carriedByUnitId(-1), ownedByHouseId(-1), plantedInFarm(-1) {
 	}
 };
 
+// Same ownership rules as FoodManager. The index here is of collectable
+// seeds (not carried, not planted), grouped by owner, since a unit may
+// collect free seeds and its own. Change carriedByUnitId, ownedByHouseId and
+// plantedInFarm only through the setters.
 class SeedManager {
 private:
-    std::vector<Seed> seeds;
+    SlotMap<Seed> seeds;
+    std::unordered_map<int, std::unordered_set<int>> collectableByOwner; // Owner id (-1 = nobody) -> seed ids
     TTF_Font* font;
 
+    void index(const Seed& seed);
+    void unindex(const Seed& seed);
+
 public:
     SeedManager();
     ~SeedManager();
@@ -92,14 +137,41 @@ public:
     // Initialize font for rendering
     bool initializeFont(const char* fontPath, int fontSize);
 
-    // Spawn seed with . symbol at given position
-    void spawnSeed(int x, int y, const std::string& type);
+    // Spawn seed with . symbol at given position, listing it in its cell if a grid is given
+    void spawnSeed(int x, int y, const std::string& type, CellGrid* cellGrid = nullptr);
+
+    // Add a seed under a fresh handle (not listed in any cell)
+    Seed& addSeed(int x, int y, const std::string& type);
+
+    // Remove a seed by id (returns false if there is none). The caller
+    // takes it off the grid first.
+    bool removeSeed(int seedId);
+
+    // Seed by id; get requires it to exist, tryGet returns nullptr for -1
+    // and for ids of removed seeds
+    Seed& get(int seedId) { return seeds.get(seedId); }
+    const Seed& get(int seedId) const { return seeds.get(seedId); }
+    Seed* tryGet(int seedId) { return seeds.tryGet(seedId); }
+    const Seed* tryGet(int seedId) const { return seeds.tryGet(seedId); }
+    bool contains(int seedId) const { return seeds.contains(seedId); }
+
+    // Hand a seed to a unit / house owner / farm (-1 for none)
+    void setCarriedBy(Seed& seed, int unitId);
+    void setOwnedBy(Seed& seed, int houseOwnerId);
+    void setPlantedInFarm(Seed& seed, int farmIndex);
+
+    // Whether a seed could be picked up by unitId: one nobody carries, that
+    // isn't planted, and that is either unowned or owned by that unit
+    static bool isCollectableBy(const Seed& seed, int unitId) {
+        return seed.carriedByUnitId == -1 && seed.plantedInFarm == -1 &&
+               (seed.ownedByHouseId == -1 || seed.ownedByHouseId == unitId);
+    }
+    bool hasCollectableSeed(int unitId) const;
 
     // Render all seeds
     void renderSeeds(SDL_Renderer* renderer);
 
     
-    std::vector<Seed>& getSeeds();
     const std::vector<Seed>& getSeeds() const;
 
 };      // Manages seeds
@@ -119,9 +191,11 @@ public:
 	}
 };
 
+// Same ownership rules as FoodManager: change carriedByUnitId and
+// ownedByHouseId only through setCarriedBy / setOwnedBy.
 class CoinManager {
 private:
-    std::vector<Coin> coins;
+    SlotMap<Coin> coins;
     TTF_Font* font;
 
 public:
@@ -131,14 +205,29 @@ public:
     // Initialize font for rendering
     bool initializeFont(const char* fontPath, int fontSize);
 
-    // Spawn coin with $ symbol at given position
-    void spawnCoin(int x, int y);
+    // Spawn coin with $ symbol at given position, listing it in its cell if a grid is given
+    void spawnCoin(int x, int y, CellGrid* cellGrid = nullptr);
+
+    // Remove a coin by id (returns false if there is none). The caller
+    // takes it off the grid first.
+    bool removeCoin(int coinId);
+
+    // Coin by id; get requires it to exist, tryGet returns nullptr for -1
+    // and for ids of removed coins
+    Coin& get(int coinId) { return coins.get(coinId); }
+    const Coin& get(int coinId) const { return coins.get(coinId); }
+    Coin* tryGet(int coinId) { return coins.tryGet(coinId); }
+    const Coin* tryGet(int coinId) const { return coins.tryGet(coinId); }
+    bool contains(int coinId) const { return coins.contains(coinId); }
+
+    // Hand a coin to a unit / house owner (-1 for nobody)
+    void setCarriedBy(Coin& coin, int unitId);
+    void setOwnedBy(Coin& coin, int houseOwnerId);
 
     // Render all coins
     void renderCoins(SDL_Renderer* renderer);
 
-    
-    std::vector<Coin>& getCoins();
+
     const std::vector<Coin>& getCoins() const;
 
 };      // Manages coins
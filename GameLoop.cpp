@@ -8,11 +8,17 @@
 #include "Food.h"
 #include "Buildings.h"
 #include "Pathfinding.h"
+#include "AsyncPathService.h"
+#include "MovingTargetPlanner.h"
+#include "CooperativePlanner.h"
 
 #include <vector>
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <iostream>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
 
 // Trading system constants
 const int TRADING_CHECK_INTERVAL = 300;  // Check every 300 frames (~5 seconds at 60 FPS)
@@ -20,6 +26,193 @@ const int EXCESS_FOOD_THRESHOLD = 2;     // Sell when house has more than this m
 const int LOW_FOOD_THRESHOLD = 1;        // Buy when house has fewer than this many food items
 const int MIN_COINS_FOR_PURCHASE = 3;    // Minimum coins needed to consider buying food
 
+// Node expansions main-thread path searches may spend per frame, across all units
+const int PATHFINDING_EXPANSIONS_PER_TICK = 4000;
+
+// Debug check for the cell grid's occupancy: rebuilds it from the entity
+// vectors and compares with the grid's. Returns false and describes the first
+// mismatch. Walks every resident chunk, so it only runs in debug builds.
+#ifndef NDEBUG
+static bool checkCellOccupancy(const CellGrid& cellGrid, const std::vector<Unit>& units, const std::vector<Food>& foods,
+                               const std::vector<Seed>& seeds, const std::vector<Coin>& coins, const std::vector<House>& houses,
+                               const std::vector<Farm>& farms, const std::vector<Market>& markets, std::string& outMismatch) {
+    int width = cellGrid.getWidthInCells();
+    int height = cellGrid.getHeightInCells();
+    const int LISTED_KINDS = 4; // Unit, Food, Seed, Coin; buildings are checked against the building plane
+    std::unordered_map<int, std::vector<int>> expected[LISTED_KINDS]; // Per kind: cell -> ids
+    auto place = [&](CellOccupant kind, int id, int gridX, int gridY) {
+        if (gridX >= 0 && gridX < width && gridY >= 0 && gridY < height) {
+            expected[static_cast<int>(kind)][gridY * width + gridX].push_back(id);
+        }
+    };
+
+    for (const auto& unit : units) {
+        place(CellOccupant::Unit, unit.id, unit.x() / GRID_SIZE, unit.y() / GRID_SIZE);
+    }
+    for (const auto& food : foods) {
+        if (food.carriedByUnitId == -1) place(CellOccupant::Food, food.foodId, food.x / GRID_SIZE, food.y / GRID_SIZE);
+    }
+    for (const auto& seed : seeds) {
+        if (seed.carriedByUnitId == -1) place(CellOccupant::Seed, seed.seedId, seed.x / GRID_SIZE, seed.y / GRID_SIZE);
+    }
+    for (const auto& coin : coins) {
+        if (coin.carriedByUnitId == -1) place(CellOccupant::Coin, coin.coinId, coin.x / GRID_SIZE, coin.y / GRID_SIZE);
+    }
+    // Top-left of the building a slot names, false if the index is stale
+    auto buildingOrigin = [&](const BuildingSlot& slot, int& outX, int& outY) {
+        switch (slot.kind) {
+        case BuildingKind::House:
+            if (slot.index >= static_cast<int>(houses.size())) return false;
+            outX = houses[slot.index].gridX; outY = houses[slot.index].gridY;
+            return true;
+        case BuildingKind::Farm:
+            if (slot.index >= static_cast<int>(farms.size())) return false;
+            outX = farms[slot.index].gridX; outY = farms[slot.index].gridY;
+            return true;
+        case BuildingKind::Market:
+            if (slot.index >= static_cast<int>(markets.size())) return false;
+            outX = markets[slot.index].gridX; outY = markets[slot.index].gridY;
+            return true;
+        }
+        return false;
+    };
+
+    static const char* names[LISTED_KINDS] = { "unit", "food", "seed", "coin" };
+    auto mismatch = [&](int x, int y, int kind, size_t have, size_t want) {
+        outMismatch = std::string("cell (") + std::to_string(x) + ", " + std::to_string(y) + ") lists " +
+            std::to_string(have) + " " + names[kind] + " id(s), entities put " + std::to_string(want) + " there";
+        return false;
+    };
+    // Only resident chunks hold anything; every cell checked there is crossed
+    // off, so whatever is left over is missing from the grid
+    bool matches = true;
+    cellGrid.forEachResidentChunk([&](const CellGrid::ChunkArea& area) {
+        for (int y = area.gridY; y < area.gridY + area.height && matches; ++y) {
+            for (int x = area.gridX; x < area.gridX + area.width && matches; ++x) {
+                BuildingSlot slot = cellGrid.getBuildingAt(x, y);
+                int originX, originY;
+                if (slot.isValid() && (!buildingOrigin(slot, originX, originY) ||
+                                       originX + slot.dx != x || originY + slot.dy != y)) {
+                    outMismatch = std::string("cell (") + std::to_string(x) + ", " + std::to_string(y) +
+                        ") names building " + std::to_string(slot.index) + " slot (" + std::to_string(slot.dx) + ", " +
+                        std::to_string(slot.dy) + "), which does not cover it";
+                    matches = false;
+                }
+                for (int kind = 0; kind < LISTED_KINDS && matches; ++kind) {
+                    std::vector<int> want;
+                    auto found = expected[kind].find(y * width + x);
+                    if (found != expected[kind].end()) {
+                        want = std::move(found->second);
+                        expected[kind].erase(found);
+                    }
+                    std::vector<int> have;
+                    cellGrid.getOccupants(static_cast<CellOccupant>(kind), x, y, have);
+                    std::sort(want.begin(), want.end());
+                    std::sort(have.begin(), have.end());
+                    if (want != have) matches = mismatch(x, y, kind, have.size(), want.size());
+                }
+            }
+        }
+    });
+    for (int kind = 0; kind < LISTED_KINDS && matches; ++kind) {
+        if (!expected[kind].empty()) {
+            const auto& missing = *expected[kind].begin();
+            matches = mismatch(missing.first % width, missing.first / width, kind, 0, missing.second.size());
+        }
+    }
+    // Every building's footprint is stamped; where footprints overlap the cell
+    // keeps whichever came first, so only check that something covers it
+    auto checkFootprint = [&](const char* name, int gridX, int gridY) {
+        for (int dx = 0; dx < 3 && matches; ++dx) {
+            for (int dy = 0; dy < 3 && matches; ++dy) {
+                int x = gridX + dx, y = gridY + dy;
+                if (x >= 0 && x < width && y >= 0 && y < height && !cellGrid.getBuildingAt(x, y).isValid()) {
+                    outMismatch = std::string("cell (") + std::to_string(x) + ", " + std::to_string(y) + ") is under a " +
+                        name + " but has no building";
+                    matches = false;
+                }
+            }
+        }
+    };
+    for (const auto& house : houses) checkFootprint("house", house.gridX, house.gridY);
+    for (const auto& farm : farms) checkFootprint("farm", farm.gridX, farm.gridY);
+    for (const auto& market : markets) checkFootprint("market", market.gridX, market.gridY);
+    return matches;
+}
+#endif
+
+// Item ids are slot map handles, so an id left behind in a building after
+// its item was removed (deleted by the player, or eaten while the building
+// still listed it) no longer resolves. Clear those slots so storage, plots
+// and stalls don't stay blocked by items that are gone.
+static void clearStaleItemIds(const FoodManager& foods, const SeedManager& seeds, const CoinManager& coins) {
+    if (g_HouseManager) {
+        for (auto& house : g_HouseManager->houses) {
+            for (int dx = 0; dx < 3; ++dx) {
+                for (int dy = 0; dy < 3; ++dy) {
+                    if (house.foodIds[dx][dy] != -1 && !foods.contains(house.foodIds[dx][dy])) house.foodIds[dx][dy] = -1;
+                    if (house.seedIds[dx][dy] != -1 && !seeds.contains(house.seedIds[dx][dy])) house.seedIds[dx][dy] = -1;
+                    if (house.coinIds[dx][dy] != -1 && !coins.contains(house.coinIds[dx][dy])) house.coinIds[dx][dy] = -1;
+                }
+            }
+        }
+    }
+    if (g_FarmManager) {
+        for (auto& farm : g_FarmManager->farms) {
+            for (int dx = 0; dx < 3; ++dx) {
+                for (int dy = 0; dy < 3; ++dy) {
+                    if (farm.plantIds[dx][dy] != -1 && !seeds.contains(farm.plantIds[dx][dy])) {
+                        farm.plantIds[dx][dy] = -1;
+                        farm.plantTimes[dx][dy] = 0;
+                    }
+                }
+            }
+        }
+    }
+    if (g_MarketManager) {
+        for (auto& market : g_MarketManager->markets) {
+            for (int dx = 0; dx < 3; ++dx) {
+                for (int dy = 0; dy < 3; ++dy) {
+                    if (market.stallFoodIds[dx][dy] != -1 && !foods.contains(market.stallFoodIds[dx][dy])) {
+                        market.stallFoodIds[dx][dy] = -1;
+                        market.stallSellerIds[dx][dy] = -1;
+                        market.stallAbandonTimes[dx][dy] = 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// --- NEEDS ---
+// Hunger drops by 1 every 500 ms. Every 200 ms morality falls by 1 while
+// hunger is below 50 and rises by 1 while it is above. Only the needs and
+// timers arrays are touched.
+static void updateUnitNeeds(UnitComponents& components, Uint32 now) {
+    for (size_t row = 0; row < components.size(); ++row) {
+        UnitNeeds& needs = components.needs[row];
+        UnitTimers& timers = components.timers[row];
+        if (now - timers.lastHungerUpdate >= 500) {
+            if (needs.hunger > 0) {
+                needs.hunger -= 1;
+            }
+            timers.lastHungerUpdate = now;
+        }
+        if (now - timers.lastMoralityUpdate >= 200) {
+            if (needs.hunger < 50) {
+                if (needs.morality > 0) {
+                    needs.morality -= 1;
+                }
+            } else if (needs.hunger > 50) {
+                if (needs.morality < 100) {
+                    needs.morality += 1;
+                }
+            }
+            timers.lastMoralityUpdate = now;
+        }
+    }
+}
+
 void runMainLoop(sdl& app) {
     bool running = true;
     SDL_Event event;
@@ -38,6 +231,15 @@ void runMainLoop(sdl& app) {
         pathClick(app);
         ++frameCounter;
 
+        // Hand finished path searches back to their units before anyone acts
+        if (g_AsyncPathService) {
+            g_AsyncPathService->beginTick();
+        }
+        beginPathfindingTick(PATHFINDING_EXPANSIONS_PER_TICK);
+        if (g_CooperativePlanner) {
+            g_CooperativePlanner->beginTick();
+        }
+
         Uint32 now = SDL_GetTicks();
 
 		// --- MARKET STALL ABANDONMENT LOGIC ---
@@ -50,17 +252,13 @@ void runMainLoop(sdl& app) {
 							int sellerId = market.stallSellerIds[dx][dy];
 							// Check if seller is present at the stall
 							bool sellerPresent = false;
-							if (sellerId != -1) {
-								for (const auto& unit : app.unitManager->getUnits()) {
-									if (unit.id == sellerId && unit.isSelling &&
-										unit.sellingStallX == market.gridX + dx &&
-										unit.sellingStallY == market.gridY + dy) {
-										// Seller is at their stall
-										sellerPresent = true;
-										market.stallAbandonTimes[dx][dy] = 0; // Reset abandon timer
-										break;
-									}
-								}
+							const Unit* seller = app.unitManager->find(sellerId);
+							if (seller && seller->isSelling() &&
+								seller->sellingStallX() == market.gridX + dx &&
+								seller->sellingStallY() == market.gridY + dy) {
+								// Seller is at their stall
+								sellerPresent = true;
+								market.stallAbandonTimes[dx][dy] = 0; // Reset abandon timer
 							}
 							
 							if (!sellerPresent) {
@@ -71,12 +269,10 @@ void runMainLoop(sdl& app) {
 								} else if (now - market.stallAbandonTimes[dx][dy] >= 200000) {
 									// 200 seconds have passed, make food free
 									int foodId = market.stallFoodIds[dx][dy];
-									auto foodIt = std::find_if(app.foodManager->getFood().begin(),
-																app.foodManager->getFood().end(),
-																[&](const Food& food) { return food.foodId == foodId; });
-									if (foodIt != app.foodManager->getFood().end()) {
-										foodIt->ownedByHouseId = -1;
-										foodIt->carriedByUnitId = -1;
+									Food* food = app.foodManager->tryGet(foodId);
+									if (food) {
+										app.foodManager->setOwnedBy(*food, -1);
+										app.foodManager->setCarriedBy(*food, -1);
 										std::cout << "Food (id " << foodId << ") at market stall has been abandoned and is now free.\n";
 									}
 									// Clear the stall
@@ -85,20 +281,15 @@ void runMainLoop(sdl& app) {
 									market.stallAbandonTimes[dx][dy] = 0;
 									
 									// Clear seller's selling status if they still have it
-									if (sellerId != -1) {
-										for (auto& unit : app.unitManager->getUnits()) {
-											if (unit.id == sellerId && unit.isSelling) {
-												unit.isSelling = false;
-												unit.sellingStallX = -1;
-												unit.sellingStallY = -1;
-												
-												// Also clear any active SellAtMarket action
-												if (!unit.actionQueue.empty()) {
-													Action current = unit.actionQueue.top();
-													if (current.type == ActionType::SellAtMarket) {
-														unit.actionQueue.pop();
-													}
-												}
+									Unit* leftSeller = app.unitManager->find(sellerId);
+									if (leftSeller && leftSeller->isSelling()) {
+										leftSeller->leaveStall();
+										
+										// Also clear any active SellAtMarket action
+										if (!leftSeller->actionQueue.empty()) {
+											Action current = leftSeller->actionQueue.top();
+											if (current.type == ActionType::SellAtMarket) {
+												leftSeller->actionQueue.pop();
 											}
 										}
 									}
@@ -110,11 +301,14 @@ void runMainLoop(sdl& app) {
 			}
 		}
 
+        // Hunger and morality for every unit, straight off the component arrays
+        updateUnitNeeds(app.unitManager->getComponents(), now);
+
         // Process units
         for (auto& unit : app.unitManager->getUnits()) {
 
 			// --- CHECK FOR COINS TO BRING HOME AFTER SELLING ---
-			if (!unit.receivedCoins.empty() && unit.carriedCoinId == -1) {
+			if (!unit.receivedCoins.empty() && unit.carriedCoinId() == -1) {
 				bool alreadyBringingCoin = false;
 				if (!unit.actionQueue.empty()) {
 					Action current = unit.actionQueue.top();
@@ -138,24 +332,11 @@ void runMainLoop(sdl& app) {
 			}
 
 			// Only try to bring food if there is food available (and not carried by anyone)
-			if (!alreadyBringingFood && g_HouseManager && app.foodManager && !app.foodManager->getFood().empty()) {
-				for (auto& house : g_HouseManager->houses) {
-					if (house.ownerUnitId == unit.id &&
-						house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-						if (house.hasSpace()) {
-							// Check if there's any free food in the world
-							bool hasFreeFood = false;
-							for (const auto& food : app.foodManager->getFood()) {
-								if (food.carriedByUnitId == -1 && food.ownedByHouseId == -1) {
-									hasFreeFood = true;
-									break;
-								}
-							}
-							if (hasFreeFood) {
-								unit.bringItemToHouse("food");
-							}
-						}
-						break;
+			if (!alreadyBringingFood && g_HouseManager && app.foodManager && app.foodManager->hasFreeFood()) {
+				House* house = unit.house();
+				if (house) {
+					if (house->hasSpace()) {
+						unit.bringItemToHouse("food");
 					}
 				}
 			}
@@ -164,50 +345,20 @@ void runMainLoop(sdl& app) {
 
 
 
-            // --- HUNGER LOGIC START ---
-            // Decrease hunger by 1 every 10 seconds (10000 ms)
-            if (now - unit.lastHungerUpdate >= 500) {
-                if (unit.hunger > 0) {
-                    unit.hunger -= 1;
-                }
-                unit.lastHungerUpdate = now;
-            }
-
-            
-            // --- HUNGER LOGIC END ---
-
-            // --- MORALITY LOGIC START ---
-            // Update morality every 1 second (1000 ms)
-            if (now - unit.lastMoralityUpdate >= 200) {
-                if (unit.hunger < 50) {
-                    // Decrease morality by 1 if hunger is below 50
-                    if (unit.morality > 0) {
-                        unit.morality -= 1;
-                    }
-                } else if (unit.hunger > 50) {
-                    // Increase morality by 1 if hunger is above 50
-                    if (unit.morality < 100) {
-                        unit.morality += 1;
-                    }
-                }
-                unit.lastMoralityUpdate = now;
-            }
-            // --- MORALITY LOGIC END ---
-			
 			// Print hunger every 30 seconds (30000 ms)
-			if (now - unit.lastHungerDebugPrint >= 30000) {
+			if (now - unit.lastHungerDebugPrint() >= 30000) {
 				std::cout << "Unit " << unit.name
 					<< " (id " << unit.id << ") hunger: "
-					<< unit.hunger << "\n Morality:" << unit.morality << "\n Health: " <<
-					unit.health << std::endl;
-				unit.lastHungerDebugPrint = now;
+					<< unit.hunger() << "\n Morality:" << unit.morality() << "\n Health: " <<
+					unit.health() << std::endl;
+				unit.lastHungerDebugPrint() = now;
 			}
 
 
 			// --- EAT FROM HOUSE LOGIC ---
 			// If hunger is below 50, try to eat from house storage first
 			bool tryingToEatFromHouse = false;
-			if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.hunger < 50) {
+			if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.hunger() < 50) {
 				bool alreadyEatingFromHouse = false;
 				if (!unit.actionQueue.empty()) {
 					Action current = unit.actionQueue.top();
@@ -217,14 +368,11 @@ void runMainLoop(sdl& app) {
 				}
 				if (!alreadyEatingFromHouse && g_HouseManager) {
 					// Check if unit has a house with food
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (house.hasItem("food")) {
-								unit.eatFromHouse();
-								tryingToEatFromHouse = true;
-							}
-							break;
+					House* house = unit.house();
+					if (house) {
+						if (house->hasItem("food")) {
+							unit.eatFromHouse();
+							tryingToEatFromHouse = true;
 						}
 					}
 				}
@@ -233,7 +381,7 @@ void runMainLoop(sdl& app) {
 			// --- STEALING LOGIC ---
 			// If morality is below 10 and hunger is 30 or below, unit will steal from nearest home
 			bool tryingToSteal = false;
-			if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.morality < 10 && unit.hunger <= 30) {
+			if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.morality() < 10 && unit.hunger() <= 30) {
 				bool alreadyStealing = false;
 				if (!unit.actionQueue.empty()) {
 					Action current = unit.actionQueue.top();
@@ -261,7 +409,7 @@ void runMainLoop(sdl& app) {
             // Skip if unit is trying to eat from house (hunger < 50 and house has food)
             // Skip if unit is trying to steal (morality < 10 and hunger <= 30)
             // Note: hunger <= 99 allows units to proactively gather food even when only slightly hungry
-            if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.hunger <= 99 && !tryingToEatFromHouse && !tryingToSteal) {
+            if ((frameCounter % HUNGER_CHECK_FRAMES == 0) && unit.hunger() <= 99 && !tryingToEatFromHouse && !tryingToSteal) {
                 bool alreadySeekingFood = false;
                 if (!unit.actionQueue.empty()) {
                     Action current = unit.actionQueue.top();
@@ -271,7 +419,7 @@ void runMainLoop(sdl& app) {
                 }
                 if (!alreadySeekingFood) {
                     // If hunger below 50, try to eat from house
-                    if (unit.hunger < 50) {
+                    if (unit.hunger() < 50) {
                         unit.tryEatFromHouse();
                     } else {
                         // Otherwise, try to find food to bring home
@@ -283,39 +431,37 @@ void runMainLoop(sdl& app) {
             // Market trading logic - check every TRADING_CHECK_INTERVAL frames
             if ((frameCounter % TRADING_CHECK_INTERVAL == 0) && g_HouseManager && g_MarketManager && !g_MarketManager->markets.empty()) {
                 // Find unit's house
-                for (const auto& house : g_HouseManager->houses) {
-                    if (house.ownerUnitId == unit.id) {
-                        // If unit has excess food (more than EXCESS_FOOD_THRESHOLD), consider selling
-                        if (house.foodIds.size() > EXCESS_FOOD_THRESHOLD) {
-                            bool alreadyTrading = false;
-                            if (!unit.actionQueue.empty()) {
-                                Action current = unit.actionQueue.top();
-                                if (current.type == ActionType::SellFoodAtMarket || 
-                                    current.type == ActionType::BuyFoodAtMarket) {
-                                    alreadyTrading = true;
-                                }
-                            }
-                            if (!alreadyTrading) {
-                                unit.addAction(Action(ActionType::SellFoodAtMarket, 5));
-                                std::cout << "Unit " << unit.name << " will sell food at market\n";
+                const House* house = unit.house();
+                if (house) {
+                    // If unit has excess food (more than EXCESS_FOOD_THRESHOLD), consider selling
+                    if (house->foodIds.size() > EXCESS_FOOD_THRESHOLD) {
+                        bool alreadyTrading = false;
+                        if (!unit.actionQueue.empty()) {
+                            Action current = unit.actionQueue.top();
+                            if (current.type == ActionType::SellFoodAtMarket || 
+                                current.type == ActionType::BuyFoodAtMarket) {
+                                alreadyTrading = true;
                             }
                         }
-                        // If unit has low food (less than LOW_FOOD_THRESHOLD) and enough coins, consider buying
-                        else if (house.foodIds.size() < LOW_FOOD_THRESHOLD && house.coins >= MIN_COINS_FOR_PURCHASE) {
-                            bool alreadyTrading = false;
-                            if (!unit.actionQueue.empty()) {
-                                Action current = unit.actionQueue.top();
-                                if (current.type == ActionType::SellFoodAtMarket || 
-                                    current.type == ActionType::BuyFoodAtMarket) {
-                                    alreadyTrading = true;
-                                }
-                            }
-                            if (!alreadyTrading) {
-                                unit.addAction(Action(ActionType::BuyFoodAtMarket, 7));
-                                std::cout << "Unit " << unit.name << " will buy food at market\n";
+                        if (!alreadyTrading) {
+                            unit.addAction(Action(ActionType::SellFoodAtMarket, 5));
+                            std::cout << "Unit " << unit.name << " will sell food at market\n";
+                        }
+                    }
+                    // If unit has low food (less than LOW_FOOD_THRESHOLD) and enough coins, consider buying
+                    else if (house->foodIds.size() < LOW_FOOD_THRESHOLD && house->coins >= MIN_COINS_FOR_PURCHASE) {
+                        bool alreadyTrading = false;
+                        if (!unit.actionQueue.empty()) {
+                            Action current = unit.actionQueue.top();
+                            if (current.type == ActionType::SellFoodAtMarket || 
+                                current.type == ActionType::BuyFoodAtMarket) {
+                                alreadyTrading = true;
                             }
                         }
-                        break;
+                        if (!alreadyTrading) {
+                            unit.addAction(Action(ActionType::BuyFoodAtMarket, 7));
+                            std::cout << "Unit " << unit.name << " will buy food at market\n";
+                        }
                     }
                 }
             }
@@ -342,44 +488,15 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyCollectingSeed && g_HouseManager) {
 					// Check if unit has a house with space
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (house.hasSpace()) {
-								// Check if there's any free seed in the world (unowned or owned by me)
-								// but NOT planted in any farm
-								bool hasCollectableSeed = false;
-								for (const auto& seed : app.seedManager->getSeeds()) {
-									if (seed.carriedByUnitId == -1 && 
-										(seed.ownedByHouseId == -1 || seed.ownedByHouseId == unit.id)) {
-										// Check if this seed is planted in any farm
-										bool isPlantedInFarm = false;
-										if (g_FarmManager) {
-											for (const auto& farm : g_FarmManager->farms) {
-												for (int dx = 0; dx < 3; ++dx) {
-													for (int dy = 0; dy < 3; ++dy) {
-														if (farm.plantIds[dx][dy] == seed.seedId) {
-															isPlantedInFarm = true;
-															break;
-														}
-													}
-													if (isPlantedInFarm) break;
-												}
-												if (isPlantedInFarm) break;
-											}
-										}
-										// Only collect seed if it's not planted in a farm
-										if (!isPlantedInFarm) {
-											hasCollectableSeed = true;
-											break;
-										}
-									}
-								}
-								if (hasCollectableSeed) {
-									unit.addAction(Action(ActionType::CollectSeed, 3));
-								}
+					House* house = unit.house();
+					if (house) {
+						if (house->hasSpace()) {
+							// Any seed lying around or in storage that is unowned or
+							// mine, and not planted in a farm
+							bool hasCollectableSeed = app.seedManager->hasCollectableSeed(unit.id);
+							if (hasCollectableSeed) {
+								unit.addAction(Action(ActionType::CollectSeed, 3));
 							}
-							break;
 						}
 					}
 				}
@@ -398,37 +515,23 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyCollectingCoin && g_HouseManager) {
 					// Check if unit has a house with space
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (house.hasSpace()) {
-								// Get unit's grid position
-								int unitGridX, unitGridY;
-								app.cellGrid->pixelToGrid(unit.x, unit.y, unitGridX, unitGridY);
+					House* house = unit.house();
+					if (house) {
+						if (house->hasSpace()) {
+							// Get unit's grid position
+							int unitGridX, unitGridY;
+							app.cellGrid->pixelToGrid(unit.x(), unit.y(), unitGridX, unitGridY);
 								
-								// Check if there's any free coin within 20 tiles
-								bool hasCollectableCoin = false;
-								for (const auto& coin : app.coinManager->getCoins()) {
-									if (coin.carriedByUnitId == -1 && coin.ownedByHouseId == -1) {
-										// Get coin's grid position
-										int coinGridX, coinGridY;
-										app.cellGrid->pixelToGrid(coin.x, coin.y, coinGridX, coinGridY);
-										
-										// Calculate Manhattan distance
-										int distance = abs(coinGridX - unitGridX) + abs(coinGridY - unitGridY);
-										
-										// Check if coin is within 20 tiles
-										if (distance <= 20) {
-											hasCollectableCoin = true;
-											break;
-										}
-									}
-								}
-								if (hasCollectableCoin) {
-									unit.addAction(Action(ActionType::CollectCoin, 3));
-								}
+							// Check if there's any free coin within 20 tiles (coins
+							// lying in a cell are never carried; owned ones are in storage)
+							int freeCoinId = app.cellGrid->findNearest(CellOccupant::Coin, unitGridX, unitGridY, 20,
+								[&](int coinId, int, int) {
+									const Coin* coin = app.coinManager->tryGet(coinId);
+									return coin && coin->ownedByHouseId == -1;
+								});
+							if (freeCoinId != -1) {
+								unit.addAction(Action(ActionType::CollectCoin, 3));
 							}
-							break;
 						}
 					}
 				}
@@ -447,23 +550,13 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyBuildingFarm) {
 					// Check if unit has a house with seeds
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (house.hasSeed()) {
-								// Check if farm already exists
-								bool farmExists = false;
-								for (const auto& farm : g_FarmManager->farms) {
-									if (farm.ownerUnitId == unit.id) {
-										farmExists = true;
-										break;
-									}
-								}
-								if (!farmExists) {
-									unit.addAction(Action(ActionType::BuildFarm, 4));
-								}
+					House* house = unit.house();
+					if (house) {
+						if (house->hasSeed()) {
+							// Check if farm already exists
+							if (!unit.farm()) {
+								unit.addAction(Action(ActionType::BuildFarm, 4));
 							}
-							break;
 						}
 					}
 				}
@@ -482,19 +575,13 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyPlanting) {
 					// Check if unit has a farm with space and house with seeds
-					for (auto& farm : g_FarmManager->farms) {
-						if (farm.ownerUnitId == unit.id && farm.hasSpace()) {
-							// Check if house has seeds
-							for (auto& house : g_HouseManager->houses) {
-								if (house.ownerUnitId == unit.id &&
-									house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-									if (house.hasSeed()) {
-										unit.addAction(Action(ActionType::PlantSeed, 4));
-									}
-									break;
-								}
+					Farm* farm = unit.farm();
+					if (farm && farm->hasSpace()) {
+						House* house = unit.house();
+						if (house) {
+							if (house->hasSeed()) {
+								unit.addAction(Action(ActionType::PlantSeed, 4));
 							}
-							break;
 						}
 					}
 				}
@@ -513,14 +600,9 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyHarvesting) {
 					// Check if unit has a farm with grown food
-					for (auto& farm : g_FarmManager->farms) {
-						if (farm.ownerUnitId == unit.id) {
-							Uint32 currentTime = SDL_GetTicks();
-							if (farm.getFirstGrownFoodId(currentTime) != -1) {
-								unit.addAction(Action(ActionType::HarvestFood, 4));
-							}
-							break;
-						}
+					Farm* farm = unit.farm();
+					if (farm && farm->getFirstGrownFoodId(SDL_GetTicks()) != -1) {
+						unit.addAction(Action(ActionType::HarvestFood, 4));
 					}
 				}
 			}
@@ -542,19 +624,16 @@ void runMainLoop(sdl& app) {
 				}
 				
 				// Don't trigger sell if unit is bringing coin home or has coins to collect
-				bool isBusyWithCoin = alreadyBringingCoin || unit.carriedCoinId != -1 || !unit.receivedCoins.empty();
+				bool isBusyWithCoin = alreadyBringingCoin || unit.carriedCoinId() != -1 || !unit.receivedCoins.empty();
 				
 				// If unit is marked as selling but not actively selling, validate before resuming
-				if (!alreadySelling && !isBusyWithCoin && unit.isSelling && unit.sellingStallX != -1) {
+				if (!alreadySelling && !isBusyWithCoin && unit.isSelling() && unit.sellingStallX() != -1) {
 					// Validate that house is still full and has food before resuming
 					bool shouldResume = false;
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (!house.hasSpace() && house.hasFood()) {
-								shouldResume = true;
-							}
-							break;
+					House* house = unit.house();
+					if (house) {
+						if (!house->hasSpace() && house->hasFood()) {
+							shouldResume = true;
 						}
 					}
 					if (shouldResume) {
@@ -562,20 +641,15 @@ void runMainLoop(sdl& app) {
 						unit.addAction(Action(ActionType::SellAtMarket, 2));
 					} else {
 						// Can't resume - clear selling state
-						unit.isSelling = false;
-						unit.sellingStallX = -1;
-						unit.sellingStallY = -1;
+						unit.leaveStall();
 					}
-				} else if (!alreadySelling && !isBusyWithCoin && !unit.isSelling) {
+				} else if (!alreadySelling && !isBusyWithCoin && !unit.isSelling()) {
 					// Check if unit's house is full and has food
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							if (!house.hasSpace() && house.hasFood()) {
-								// House is full and has food to sell
-								unit.addAction(Action(ActionType::SellAtMarket, 2));
-							}
-							break;
+					House* house = unit.house();
+					if (house) {
+						if (!house->hasSpace() && house->hasFood()) {
+							// House is full and has food to sell
+							unit.addAction(Action(ActionType::SellAtMarket, 2));
 						}
 					}
 				}
@@ -594,25 +668,22 @@ void runMainLoop(sdl& app) {
 				
 				if (!alreadyBuying) {
 					// Check if unit's house has space and has a coin
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == unit.id &&
-							house.gridX == unit.houseGridX && house.gridY == unit.houseGridY) {
-							// House should not be full of food (check if has space OR only has coins/seeds)
-							bool needsFood = house.hasSpace() || !house.hasFood();
-							if (needsFood && house.hasCoin()) {
-								// Check if there's an active seller at any market
-								bool hasActiveSeller = false;
-								for (const auto& market : g_MarketManager->markets) {
-									if (market.hasActiveSeller()) {
-										hasActiveSeller = true;
-										break;
-									}
-								}
-								if (hasActiveSeller) {
-									unit.addAction(Action(ActionType::BuyAtMarket, 2));
+					House* house = unit.house();
+					if (house) {
+						// House should not be full of food (check if has space OR only has coins/seeds)
+						bool needsFood = house->hasSpace() || !house->hasFood();
+						if (needsFood && house->hasCoin()) {
+							// Check if there's an active seller at any market
+							bool hasActiveSeller = false;
+							for (const auto& market : g_MarketManager->markets) {
+								if (market.hasActiveSeller()) {
+									hasActiveSeller = true;
+									break;
 								}
 							}
-							break;
+							if (hasActiveSeller) {
+								unit.addAction(Action(ActionType::BuyAtMarket, 2));
+							}
 						}
 					}
 				}
@@ -622,91 +693,78 @@ void runMainLoop(sdl& app) {
 
 			// --- FIGHT LOGIC ---
 			// If a unit had food stolen from them and the thief is within 5 tiles, fight them
-			if (unit.stolenFromByUnitId != -1) {
-				// Find the thief unit
+			if (unit.stolenFromByUnitId() != -1) {
+				// Look for the thief within 5 tiles of this unit
+				int unitGridX, unitGridY;
+				app.cellGrid->pixelToGrid(unit.x(), unit.y(), unitGridX, unitGridY);
+				int thiefId = unit.stolenFromByUnitId();
+				int thiefGridX = -1, thiefGridY = -1;
 				Unit* thiefUnit = nullptr;
-				for (auto& otherUnit : app.unitManager->getUnits()) {
-					if (otherUnit.id == unit.stolenFromByUnitId) {
-						thiefUnit = &otherUnit;
-						break;
-					}
+				if (app.cellGrid->findNearest(CellOccupant::Unit, unitGridX, unitGridY, 5,
+						[thiefId](int id, int, int) { return id == thiefId; }, &thiefGridX, &thiefGridY) != -1) {
+					thiefUnit = app.unitManager->find(thiefId);
 				}
 				
 				if (thiefUnit) {
-					// Calculate distance to thief
-					int unitGridX, unitGridY;
-					app.cellGrid->pixelToGrid(unit.x, unit.y, unitGridX, unitGridY);
-					int thiefGridX, thiefGridY;
-					app.cellGrid->pixelToGrid(thiefUnit->x, thiefUnit->y, thiefGridX, thiefGridY);
 					int dist = abs(thiefGridX - unitGridX) + abs(thiefGridY - unitGridY);
 					
-					// If thief is within 5 tiles, start or continue fighting
-					if (dist <= 5) {
-						bool alreadyFighting = false;
-						if (!unit.actionQueue.empty()) {
-							Action current = unit.actionQueue.top();
-							if (current.type == ActionType::Fight) {
-								alreadyFighting = true;
-							}
+					bool alreadyFighting = false;
+					if (!unit.actionQueue.empty()) {
+						Action current = unit.actionQueue.top();
+						if (current.type == ActionType::Fight) {
+							alreadyFighting = true;
 						}
+					}
+					
+					if (!alreadyFighting) {
+						// Add Fight action with priority 9
+						unit.addAction(Action(ActionType::Fight, 9));
+						unit.fightingTargetId() = thiefUnit->id;
+					}
+					
+					// Check if units are adjacent (distance 1 or 0)
+					if (dist <= 1 && !unit.isClamped()) {
+						// Start the fight - clamp both units
+						unit.isClamped() = true;
+						thiefUnit->isClamped() = true;
+						unit.fightStartTime() = now;
+						thiefUnit->fightStartTime() = now;
 						
-						if (!alreadyFighting) {
-							// Add Fight action with priority 9
-							unit.addAction(Action(ActionType::Fight, 9));
-							unit.fightingTargetId = thiefUnit->id;
-						}
+						// Deal damage to the thief
+						thiefUnit->health() -= 10;
+						std::cout << unit.name << " has hit " << thiefUnit->name 
+						          << " for 10 damage for stealing from them!" << std::endl;
 						
-						// Check if units are adjacent (distance 1 or 0)
-						if (dist <= 1 && !unit.isClamped) {
-							// Start the fight - clamp both units
-							unit.isClamped = true;
-							thiefUnit->isClamped = true;
-							unit.fightStartTime = now;
-							thiefUnit->fightStartTime = now;
-							
-							// Deal damage to the thief
-							thiefUnit->health -= 10;
-							std::cout << unit.name << " has hit " << thiefUnit->name 
-							          << " for 10 damage for stealing from them!" << std::endl;
-							
-							// Clear the stolen from tracking after the hit (unit stays clamped for 2 seconds)
-							unit.stolenFromByUnitId = -1;
-							unit.fightingTargetId = -1;
-							
-							// Clear the thief's action queue so they return to default Wander behavior
-							std::priority_queue<Action, std::vector<Action>, ActionComparator> empty;
-							std::swap(thiefUnit->actionQueue, empty);
-							
-							// Speed will be restored when unclamped (line 428) or fight ends
-						}
+						// Clear the stolen from tracking after the hit (unit stays clamped for 2 seconds)
+						unit.stolenFromByUnitId() = -1;
+						unit.fightingTargetId() = -1;
+						releasePursuitPlanner(unit.id);
 						
-						// Update path to thief if not clamped
-						if (!unit.isClamped && (unit.path.empty() || frameCounter % 30 == 0)) {
-							// Continuously update path to follow the thief
-							auto newPath = aStarFindPath(unitGridX, unitGridY, thiefGridX, thiefGridY, *app.cellGrid);
-							if (!newPath.empty()) {
-								unit.path = newPath;
-								// Make this unit faster to catch up
-								unit.moveDelay = 30; // Faster than normal (normal is 50)
-							}
-						}
-					} else {
-						// Thief too far away, give up chase and restore normal speed
-						unit.stolenFromByUnitId = -1;
-						unit.fightingTargetId = -1;
-						unit.moveDelay = 50;
-						// Clear Fight action from queue
-						if (!unit.actionQueue.empty()) {
-							Action current = unit.actionQueue.top();
-							if (current.type == ActionType::Fight) {
-								unit.actionQueue.pop();
-							}
+						// Clear the thief's action queue so they return to default Wander behavior
+						std::priority_queue<Action, std::vector<Action>, ActionComparator> empty;
+						std::swap(thiefUnit->actionQueue, empty);
+						
+						// Speed will be restored when unclamped (line 428) or fight ends
+					}
+					
+					// Update path to thief if not clamped
+					bool thiefMoved = !unit.path.empty() &&
+						(unit.path.back().first != thiefGridX || unit.path.back().second != thiefGridY);
+					if (!unit.isClamped() && (unit.path.empty() || thiefMoved)) {
+						// Continuously update path to follow the thief (incremental, so
+						// replanning on every thief step is cheap)
+						auto newPath = getPursuitPlanner(unit.id, *app.cellGrid).findPath(unitGridX, unitGridY, thiefGridX, thiefGridY);
+						if (!newPath.empty()) {
+							unit.path = UnitPath(newPath);
+							// Make this unit faster to catch up
+							unit.moveDelay = 30; // Faster than normal (normal is 50)
 						}
 					}
 				} else {
-					// Thief not found (might have been deleted), clear tracking and restore speed
-					unit.stolenFromByUnitId = -1;
-					unit.fightingTargetId = -1;
+					// Thief more than 5 tiles away (or gone), give up chase and restore normal speed
+					unit.stolenFromByUnitId() = -1;
+					unit.fightingTargetId() = -1;
+					releasePursuitPlanner(unit.id);
 					unit.moveDelay = 50;
 					// Clear Fight action from queue
 					if (!unit.actionQueue.empty()) {
@@ -719,10 +777,10 @@ void runMainLoop(sdl& app) {
 			}
 			
 			// Handle clamping during fight - prevent movement for 2 seconds
-			if (unit.isClamped && now - unit.fightStartTime >= 2000) {
+			if (unit.isClamped() && now - unit.fightStartTime() >= 2000) {
 				// 2 seconds have passed, unclamp
-				unit.isClamped = false;
-				unit.fightStartTime = 0;
+				unit.isClamped() = false;
+				unit.fightStartTime() = 0;
 				// Restore normal speed
 				unit.moveDelay = 50;
 				
@@ -736,13 +794,13 @@ void runMainLoop(sdl& app) {
 			}
 			
 			// Prevent movement if clamped
-			if (unit.isClamped) {
+			if (unit.isClamped()) {
 				unit.path.clear();
 			}
 
             // Process queued actions - only if there's something to process
             if (!unit.actionQueue.empty() || !unit.path.empty()) {
-                unit.processAction(*app.cellGrid, app.foodManager->getFood(), app.seedManager->getSeeds(), app.coinManager->getCoins());
+                unit.processAction(*app.cellGrid, *app.foodManager, *app.seedManager, *app.coinManager);
             }
 
             // If no actions left, re-add Wander
@@ -754,48 +812,42 @@ void runMainLoop(sdl& app) {
 		// --- TRACK THEFT VICTIMS ---
 		// After all units have processed, check if any stealing occurred
 		for (auto& thief : app.unitManager->getUnits()) {
-			if (thief.justStoleFromUnitId != -1) {
+			if (thief.justStoleFromUnitId() != -1) {
 				// Find the victim and record the theft
-				for (auto& victim : app.unitManager->getUnits()) {
-					if (victim.id == thief.justStoleFromUnitId) {
-						victim.stolenFromByUnitId = thief.id;
-						std::cout << "Victim " << victim.name << " (id " << victim.id 
-						          << ") now knows that " << thief.name << " (id " << thief.id 
-						          << ") stole from them" << std::endl;
-						break;
-					}
+				Unit* victim = app.unitManager->find(thief.justStoleFromUnitId());
+				if (victim) {
+					victim->stolenFromByUnitId() = thief.id;
+					std::cout << "Victim " << victim->name << " (id " << victim->id 
+					          << ") now knows that " << thief.name << " (id " << thief.id 
+					          << ") stole from them" << std::endl;
 				}
 				// Clear the flag
-				thief.justStoleFromUnitId = -1;
+				thief.justStoleFromUnitId() = -1;
 			}
 		}
 
 		// --- HANDLE COIN OWNERSHIP FROM MARKET TRANSACTIONS ---
 		// Check for coins marked as owned by sellers and add them to receivedCoins
 		if (app.coinManager) {
-			for (auto& coin : app.coinManager->getCoins()) {
+			for (const auto& coin : app.coinManager->getCoins()) {
 				if (coin.ownedByHouseId != -1 && coin.carriedByUnitId == -1) {
 					// Find the seller unit and add coin to their receivedCoins if not already there
-					for (auto& seller : app.unitManager->getUnits()) {
-						if (seller.id == coin.ownedByHouseId) {
-							// Check if coin is already in receivedCoins
-							bool alreadyAdded = false;
-							for (int receivedCoin : seller.receivedCoins) {
-								if (receivedCoin == coin.coinId) {
-									alreadyAdded = true;
-									break;
-								}
-							}
-							if (!alreadyAdded) {
-								seller.receivedCoins.push_back(coin.coinId);
-								std::cout << "Market: Seller " << seller.name << " (id " << seller.id 
-								          << ") received coin (id " << coin.coinId << ") from sale.\n";
-								// Clear the seller's selling status
-								seller.isSelling = false;
-								seller.sellingStallX = -1;
-								seller.sellingStallY = -1;
+					Unit* seller = app.unitManager->find(coin.ownedByHouseId);
+					if (seller) {
+						// Check if coin is already in receivedCoins
+						bool alreadyAdded = false;
+						for (int receivedCoin : seller->receivedCoins) {
+							if (receivedCoin == coin.coinId) {
+								alreadyAdded = true;
+								break;
 							}
-							break;
+						}
+						if (!alreadyAdded) {
+							seller->receivedCoins.push_back(coin.coinId);
+							std::cout << "Market: Seller " << seller->name << " (id " << seller->id 
+							          << ") received coin (id " << coin.coinId << ") from sale.\n";
+							// Clear the seller's selling status
+							seller->leaveStall();
 						}
 					}
 				}
@@ -803,62 +855,52 @@ void runMainLoop(sdl& app) {
 		}
 
 		// --- DELETE DEAD UNITS ---
-		// Remove units with hunger <= 0 or health <= 0
-		auto& units = app.unitManager->getUnits();
-		auto it = units.begin();
-		while (it != units.end()) {
-			bool shouldDelete = false;
+		// Remove units with hunger <= 0 or health <= 0, all in one compaction pass
+		app.unitManager->removeUnitsIf([&](Unit& unit) {
 			std::string deleteReason;
-			
-			if (it->hunger <= 0) {
-				shouldDelete = true;
+			if (unit.hunger() <= 0) {
 				deleteReason = "hunger reached 0";
-			} else if (it->health <= 0) {
-				shouldDelete = true;
+			} else if (unit.health() <= 0) {
 				deleteReason = "health reached 0";
+			} else {
+				return false;
 			}
+			std::cout << "Unit " << unit.name << " (id " << unit.id << ") has died: " << deleteReason << std::endl;
 			
-			if (shouldDelete) {
-				std::cout << "Unit " << it->name << " (id " << it->id << ") has died: " << deleteReason << std::endl;
-				
-				// Clean up any references to this unit
-				int deletedId = it->id;
-				
-				// Clear any theft tracking involving this unit
-				for (auto& otherUnit : units) {
-					if (otherUnit.stolenFromByUnitId == deletedId) {
-						otherUnit.stolenFromByUnitId = -1;
-						otherUnit.fightingTargetId = -1;
-					}
-					if (otherUnit.fightingTargetId == deletedId) {
-						otherUnit.fightingTargetId = -1;
-					}
+			// Clear carried items
+			if (unit.carriedFoodId() != -1) {
+				Food* food = app.foodManager->tryGet(unit.carriedFoodId());
+				if (food) {
+					app.foodManager->setCarriedBy(*food, -1);
+					app.cellGrid->addOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
 				}
-				
-				// Clear carried items
-				if (it->carriedFoodId != -1) {
-					auto foodIt = std::find_if(app.foodManager->getFood().begin(), 
-					                           app.foodManager->getFood().end(),
-					                           [&](const Food& food) { return food.foodId == it->carriedFoodId; });
-					if (foodIt != app.foodManager->getFood().end()) {
-						foodIt->carriedByUnitId = -1;
-					}
-				}
-				
-				if (it->carriedSeedId != -1) {
-					auto seedIt = std::find_if(app.seedManager->getSeeds().begin(), 
-					                           app.seedManager->getSeeds().end(),
-					                           [&](const Seed& seed) { return seed.seedId == it->carriedSeedId; });
-					if (seedIt != app.seedManager->getSeeds().end()) {
-						seedIt->carriedByUnitId = -1;
-					}
+			}
+			
+			if (unit.carriedSeedId() != -1) {
+				Seed* seed = app.seedManager->tryGet(unit.carriedSeedId());
+				if (seed) {
+					app.seedManager->setCarriedBy(*seed, -1);
+					app.cellGrid->addOccupantAtPixel(CellOccupant::Seed, seed->seedId, seed->x, seed->y);
 				}
-				
-				it = units.erase(it);
-			} else {
-				++it;
+			}
+			return true;
+		}, app.cellGrid);
+		auto& units = app.unitManager->getUnits();
+
+		if (frameCounter % HUNGER_CHECK_FRAMES == 0) {
+			clearStaleItemIds(*app.foodManager, *app.seedManager, *app.coinManager);
+		}
+
+#ifndef NDEBUG
+		if (frameCounter % HUNGER_CHECK_FRAMES == 0 && g_HouseManager && g_FarmManager && g_MarketManager) {
+			std::string mismatch;
+			if (!checkCellOccupancy(*app.cellGrid, units, app.foodManager->getFood(), app.seedManager->getSeeds(),
+			                        app.coinManager->getCoins(), g_HouseManager->houses, g_FarmManager->farms,
+			                        g_MarketManager->markets, mismatch)) {
+				std::cerr << "Cell occupancy out of sync: " << mismatch << std::endl;
 			}
 		}
+#endif
 
         // --- RENDERING ---
         SDL_SetRenderDrawColor(app.renderer, 0, 0, 0, 255);
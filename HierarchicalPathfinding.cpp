@@ -0,0 +1,396 @@
+#include "HierarchicalPathfinding.h"
+#include <algorithm>
+#include <queue>
+#include <cstdlib>
+
+HierarchicalPathfinder* g_HierarchicalPathfinder = nullptr;
+
+// Border runs at least this long get an entrance at both ends instead of one in the middle
+static constexpr int LONG_ENTRANCE_LENGTH = 6;
+
+HierarchicalPathfinder::HierarchicalPathfinder(const CellGrid& plannedGrid) : grid(&plannedGrid) {
+    int w = plannedGrid.getWidthInCells();
+    int h = plannedGrid.getHeightInCells();
+    Region prototype;
+    regionsX = (w + prototype.width - 1) / prototype.width;
+    regionsY = (h + prototype.height - 1) / prototype.height;
+
+    for (int gy = 0; gy < regionsY; ++gy) {
+        for (int gx = 0; gx < regionsX; ++gx) {
+            Region region(gy * regionsX + gx, gx, gy);
+            // Regions on the far edge are clipped to the grid
+            region.width = std::min(region.width, w - region.worldX);
+            region.height = std::min(region.height, h - region.worldY);
+            regions.push_back(region);
+        }
+    }
+    caches.resize(regions.size());
+    syncedVersion = plannedGrid.getWalkabilityVersion();
+}
+
+int HierarchicalPathfinder::getRegionIndexAt(int gridX, int gridY) const {
+    Region prototype;
+    int gx = gridX / prototype.width;
+    int gy = gridY / prototype.height;
+    if (gx < 0 || gy < 0 || gx >= regionsX || gy >= regionsY) return -1;
+    return gy * regionsX + gx;
+}
+
+int HierarchicalPathfinder::toLocal(int regionIndex, int cell) const {
+    const Region& region = regions[regionIndex];
+    int w = grid->getWidthInCells();
+    return (cell / w - region.worldY) * region.width + (cell % w - region.worldX);
+}
+
+int HierarchicalPathfinder::toCell(int regionIndex, int local) const {
+    const Region& region = regions[regionIndex];
+    return (region.worldY + local / region.width) * grid->getWidthInCells() + region.worldX + local % region.width;
+}
+
+void HierarchicalPathfinder::bfsInRegion(int regionIndex, int sourceCell, std::vector<int>& dist, std::vector<int>& parent) const {
+    const Region& region = regions[regionIndex];
+    int size = region.width * region.height;
+    dist.assign(size, -1);
+    parent.assign(size, -1);
+
+    std::vector<int> queue;
+    queue.reserve(size);
+    int source = toLocal(regionIndex, sourceCell);
+    dist[source] = 0;
+    queue.push_back(source);
+
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int local = queue[head];
+        int lx = local % region.width;
+        int ly = local / region.width;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = lx + dx[dir];
+            int ny = ly + dy[dir];
+            if (nx < 0 || ny < 0 || nx >= region.width || ny >= region.height) continue;
+            int next = ny * region.width + nx;
+            if (dist[next] != -1) continue;
+            if (!grid->isCellWalkable(region.worldX + nx, region.worldY + ny)) continue;
+            dist[next] = dist[local] + 1;
+            parent[next] = local;
+            queue.push_back(next);
+        }
+    }
+}
+
+void HierarchicalPathfinder::collectBorderTransitions(int regionA, bool horizontalNeighbor,
+                                                      std::vector<std::pair<int, int>>& outTransitions) const {
+    // The other region is to the right of (horizontalNeighbor) or below regionA
+    const Region& a = regions[regionA];
+    int w = grid->getWidthInCells();
+    int length = horizontalNeighbor ? a.height : a.width;
+
+    auto cellPair = [&](int i) {
+        int ax = horizontalNeighbor ? a.worldX + a.width - 1 : a.worldX + i;
+        int ay = horizontalNeighbor ? a.worldY + i : a.worldY + a.height - 1;
+        int bx = horizontalNeighbor ? ax + 1 : ax;
+        int by = horizontalNeighbor ? ay : ay + 1;
+        return std::make_pair(ay * w + ax, by * w + bx);
+    };
+    auto isOpen = [&](int i) {
+        auto cells = cellPair(i);
+        return grid->isCellWalkable(cells.first % w, cells.first / w) &&
+               grid->isCellWalkable(cells.second % w, cells.second / w);
+    };
+
+    int i = 0;
+    while (i < length) {
+        if (!isOpen(i)) {
+            ++i;
+            continue;
+        }
+        int runStart = i;
+        while (i < length && isOpen(i)) ++i;
+        int runEnd = i - 1;
+
+        if (runEnd - runStart + 1 >= LONG_ENTRANCE_LENGTH) {
+            outTransitions.push_back(cellPair(runStart));
+            outTransitions.push_back(cellPair(runEnd));
+        } else {
+            outTransitions.push_back(cellPair((runStart + runEnd) / 2));
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildRegion(int regionIndex) {
+    RegionCache& cache = caches[regionIndex];
+    cache = RegionCache();
+
+    const Region& region = regions[regionIndex];
+    auto addTransition = [&](int ownCell, int otherCell) {
+        auto it = cache.localIndex.find(ownCell);
+        int node;
+        if (it == cache.localIndex.end()) {
+            node = static_cast<int>(cache.nodeCells.size());
+            cache.localIndex[ownCell] = node;
+            cache.nodeCells.push_back(ownCell);
+            cache.partners.emplace_back();
+        } else {
+            node = it->second;
+        }
+        cache.partners[node].push_back(otherCell);
+    };
+
+    std::vector<std::pair<int, int>> transitions;
+    // Right and bottom borders: this region is side A
+    if (region.gridX + 1 < regionsX) {
+        transitions.clear();
+        collectBorderTransitions(regionIndex, true, transitions);
+        for (const auto& t : transitions) addTransition(t.first, t.second);
+    }
+    if (region.gridY + 1 < regionsY) {
+        transitions.clear();
+        collectBorderTransitions(regionIndex, false, transitions);
+        for (const auto& t : transitions) addTransition(t.first, t.second);
+    }
+    // Left and top borders: this region is side B
+    if (region.gridX > 0) {
+        transitions.clear();
+        collectBorderTransitions(regionIndex - 1, true, transitions);
+        for (const auto& t : transitions) addTransition(t.second, t.first);
+    }
+    if (region.gridY > 0) {
+        transitions.clear();
+        collectBorderTransitions(regionIndex - regionsX, false, transitions);
+        for (const auto& t : transitions) addTransition(t.second, t.first);
+    }
+
+    // Cache intra-region distances (and the BFS trees, for refinement)
+    int n = static_cast<int>(cache.nodeCells.size());
+    cache.distances.assign(n * n, -1);
+    cache.parentTrees.resize(n);
+    std::vector<int> dist;
+    for (int i = 0; i < n; ++i) {
+        bfsInRegion(regionIndex, cache.nodeCells[i], dist, cache.parentTrees[i]);
+        for (int j = 0; j < n; ++j) {
+            cache.distances[i * n + j] = dist[toLocal(regionIndex, cache.nodeCells[j])];
+        }
+    }
+    cache.dirty = false;
+}
+
+void HierarchicalPathfinder::onCellWalkabilityChanged(int gridX, int gridY) {
+    int regionIndex = getRegionIndexAt(gridX, gridY);
+    if (regionIndex < 0) return;
+    caches[regionIndex].dirty = true;
+
+    // A border cell also changes the entrances seen by the region across that border
+    const Region& region = regions[regionIndex];
+    if (gridX == region.worldX && region.gridX > 0) caches[regionIndex - 1].dirty = true;
+    if (gridX == region.worldX + region.width - 1 && region.gridX + 1 < regionsX) caches[regionIndex + 1].dirty = true;
+    if (gridY == region.worldY && region.gridY > 0) caches[regionIndex - regionsX].dirty = true;
+    if (gridY == region.worldY + region.height - 1 && region.gridY + 1 < regionsY) caches[regionIndex + regionsX].dirty = true;
+}
+
+void HierarchicalPathfinder::setGrid(const CellGrid& newGrid) {
+    grid = &newGrid;
+    // Older than what the caches were built from: its history can't say what to undo
+    if (newGrid.getWalkabilityVersion() < syncedVersion) {
+        for (RegionCache& cache : caches) cache.dirty = true;
+        syncedVersion = newGrid.getWalkabilityVersion();
+    }
+}
+
+void HierarchicalPathfinder::syncWithGrid() {
+    uint64_t version = grid->getWalkabilityVersion();
+    if (version != syncedVersion) {
+        std::vector<int> changed;
+        if (grid->getWalkabilityChangesSince(syncedVersion, changed)) {
+            int w = grid->getWidthInCells();
+            for (int cell : changed) {
+                onCellWalkabilityChanged(cell % w, cell / w);
+            }
+        } else {
+            // The cell log has moved on: treat every cell of a changed chunk as changed
+            grid->getChangedChunksSince(GridLayer::Walkability, syncedVersion, changed);
+            int widthInChunks = grid->getWidthInChunks();
+            for (int chunk : changed) {
+                CellGrid::ChunkArea area = grid->chunkArea(chunk % widthInChunks, chunk / widthInChunks);
+                for (int y = area.gridY; y < area.gridY + area.height; ++y) {
+                    for (int x = area.gridX; x < area.gridX + area.width; ++x) {
+                        onCellWalkabilityChanged(x, y);
+                    }
+                }
+            }
+        }
+        syncedVersion = version;
+    }
+
+    for (size_t i = 0; i < caches.size(); ++i) {
+        if (caches[i].dirty) rebuildRegion(static_cast<int>(i));
+    }
+}
+
+void HierarchicalPathfinder::appendTreePath(int regionIndex, const std::vector<int>& parent, int to,
+                                            std::vector<int>& outReversed) const {
+    for (int local = toLocal(regionIndex, to); local != -1; local = parent[local]) {
+        outReversed.push_back(toCell(regionIndex, local));
+    }
+}
+
+std::vector<std::pair<int, int>> HierarchicalPathfinder::findPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    int refineEdges,
+    bool* outComplete
+) {
+    std::vector<std::pair<int, int>> path;
+    if (outComplete) *outComplete = false;
+
+    int w = grid->getWidthInCells();
+    int h = grid->getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return path;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return path;
+    if (!grid->isCellWalkable(goalX, goalY)) return path;
+    // Different connected components: no need to touch the abstract graph
+    if (!grid->canReach(startX, startY, goalX, goalY)) return path;
+
+    if (startX == goalX && startY == goalY) {
+        path.emplace_back(startX, startY);
+        if (outComplete) *outComplete = true;
+        return path;
+    }
+
+    syncWithGrid();
+
+    const int startCell = startY * w + startX;
+    const int goalCell = goalY * w + goalX;
+    const int startRegion = getRegionIndexAt(startX, startY);
+    const int goalRegion = getRegionIndexAt(goalX, goalY);
+
+    // Connect the temporary start and goal nodes to their regions
+    std::vector<int> startDist, startParent, goalDist, goalParent;
+    bfsInRegion(startRegion, startCell, startDist, startParent);
+    bfsInRegion(goalRegion, goalCell, goalDist, goalParent);
+
+    // Abstract A*: node ids are flat cell indices, plus two special ids
+    const int START = -1;
+    const int GOAL = -2;
+
+    auto coords = [&](int id, int& x, int& y) {
+        int cell = id == START ? startCell : (id == GOAL ? goalCell : id);
+        x = cell % w;
+        y = cell / w;
+    };
+    auto heuristic = [&](int id) {
+        int x, y;
+        coords(id, x, y);
+        return std::abs(x - goalX) + std::abs(y - goalY);
+    };
+
+    auto forEachSuccessor = [&](int id, auto&& visit) {
+        if (id == START) {
+            const RegionCache& cache = caches[startRegion];
+            for (int node : cache.nodeCells) {
+                int d = startDist[toLocal(startRegion, node)];
+                if (d >= 0) visit(node, d);
+            }
+            if (startRegion == goalRegion) {
+                int d = startDist[toLocal(goalRegion, goalCell)];
+                if (d >= 0) visit(GOAL, d);
+            }
+            return;
+        }
+        int x, y;
+        coords(id, x, y);
+        int regionIndex = getRegionIndexAt(x, y);
+        const RegionCache& cache = caches[regionIndex];
+        int n = static_cast<int>(cache.nodeCells.size());
+        int li = cache.localIndex.at(id);
+        for (int j = 0; j < n; ++j) {
+            int d = cache.distances[li * n + j];
+            if (j != li && d >= 0) visit(cache.nodeCells[j], d);
+        }
+        for (int partner : cache.partners[li]) {
+            visit(partner, 1);
+        }
+        if (regionIndex == goalRegion) {
+            int d = goalDist[toLocal(goalRegion, id)];
+            if (d >= 0) visit(GOAL, d);
+        }
+    };
+
+    using OpenEntry = std::pair<int, int>; // (f, id)
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+    std::unordered_map<int, int> gScore;
+    std::unordered_map<int, int> cameFrom;
+    gScore[START] = 0;
+    open.push({ heuristic(START), START });
+
+    bool found = false;
+    while (!open.empty()) {
+        OpenEntry top = open.top();
+        open.pop();
+        int current = top.second;
+        int g = gScore[current];
+        if (top.first > g + heuristic(current)) continue; // Stale entry
+        if (current == GOAL) {
+            found = true;
+            break;
+        }
+        forEachSuccessor(current, [&](int next, int cost) {
+            int ng = g + cost;
+            auto it = gScore.find(next);
+            if (it == gScore.end() || ng < it->second) {
+                gScore[next] = ng;
+                cameFrom[next] = current;
+                open.push({ ng + heuristic(next), next });
+            }
+        });
+    }
+    if (!found) return path;
+
+    std::vector<int> abstractPath;
+    for (int id = GOAL; id != START; id = cameFrom[id]) abstractPath.push_back(id);
+    abstractPath.push_back(START);
+    std::reverse(abstractPath.begin(), abstractPath.end());
+
+    // Refine only the first few abstract edges into cells
+    path.emplace_back(startX, startY);
+    int edgeCount = static_cast<int>(abstractPath.size()) - 1;
+    int refined = std::min(edgeCount, std::max(refineEdges, 1));
+    std::vector<int> segment;
+    for (int e = 0; e < refined; ++e) {
+        int from = abstractPath[e];
+        int to = abstractPath[e + 1];
+        int toCellIndex = to == GOAL ? goalCell : to;
+        segment.clear();
+
+        if (from == START) {
+            // Walk the start BFS tree back from the target, then flip it
+            appendTreePath(startRegion, startParent, toCellIndex, segment);
+            std::reverse(segment.begin(), segment.end());
+        } else if (to == GOAL) {
+            // The goal BFS tree already leads from this node to the goal
+            appendTreePath(goalRegion, goalParent, from, segment);
+        } else {
+            int fx, fy, tx, ty;
+            coords(from, fx, fy);
+            coords(to, tx, ty);
+            int fromRegion = getRegionIndexAt(fx, fy);
+            if (fromRegion != getRegionIndexAt(tx, ty)) {
+                // Entrance crossing: one step over the border
+                segment.push_back(from);
+                segment.push_back(to);
+            } else {
+                const RegionCache& cache = caches[fromRegion];
+                appendTreePath(fromRegion, cache.parentTrees[cache.localIndex.at(from)], to, segment);
+                std::reverse(segment.begin(), segment.end());
+            }
+        }
+
+        // segment[0] is the cell we are already standing on
+        for (size_t i = 1; i < segment.size(); ++i) {
+            path.emplace_back(segment[i] % w, segment[i] / w);
+        }
+    }
+
+    if (outComplete) *outComplete = (refined == edgeCount);
+    return path;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include "CellGrid.h"
+#include "World.h"
+
+// Hierarchical pathfinder (HPA*) built on World.h Regions.
+//
+// The grid is tiled into Region-sized clusters (48x25 cells). Walkable runs
+// along each shared region border become entrances; each entrance is a pair of
+// abstract nodes, one on each side. Within a region, the distance between every
+// pair of its nodes is cached together with the BFS tree it came from, so a
+// long trip is planned on the small abstract graph and only the first few
+// abstract edges are turned back into cells. When the returned path is used up,
+// the caller simply plans again from where it stands.
+//
+// The cache follows the grid's walkability version: regions containing changed
+// cells (and the neighbour across a changed border cell) are rebuilt lazily on
+// the next query. When the grid's cell log no longer reaches back far enough,
+// the changed chunks stand in for the changed cells.
+class HierarchicalPathfinder {
+public:
+    explicit HierarchicalPathfinder(const CellGrid& grid);
+
+    // Plan on another copy of the same world from now on, such as a newer
+    // walkability snapshot of it. The region caches are kept and brought up
+    // to date from the new grid's change history on the next query.
+    void setGrid(const CellGrid& newGrid);
+
+    // Plan from start to goal. The returned path starts at the start cell and
+    // covers at most refineEdges abstract edges; if it stops short of the goal,
+    // outComplete is set to false. Returns an empty vector if the goal is
+    // unreachable.
+    std::vector<std::pair<int, int>> findPath(
+        int startX, int startY,
+        int goalX, int goalY,
+        int refineEdges = 3,
+        bool* outComplete = nullptr
+    );
+
+    // Mark the region holding a cell (and its neighbour, for border cells) for rebuild.
+    // Called automatically for changes made through CellGrid::setCellWalkable.
+    void onCellWalkabilityChanged(int gridX, int gridY);
+
+    const std::vector<Region>& getRegions() const { return regions; }
+    int getRegionIndexAt(int gridX, int gridY) const;
+
+private:
+    struct RegionCache {
+        std::vector<int> nodeCells;                 // Abstract node -> flat cell index
+        std::unordered_map<int, int> localIndex;    // Flat cell index -> abstract node
+        std::vector<std::vector<int>> partners;     // Node -> cells across the border
+        std::vector<int> distances;                 // n*n intra-region distances, -1 if unreachable
+        std::vector<std::vector<int>> parentTrees;  // Node -> BFS parent per region-local cell
+        bool dirty = true;
+    };
+
+    // Region-restricted BFS from one cell; dist/parent are indexed by region-local cell
+    void bfsInRegion(int regionIndex, int sourceCell, std::vector<int>& dist, std::vector<int>& parent) const;
+    int toLocal(int regionIndex, int cell) const;
+    int toCell(int regionIndex, int local) const;
+
+    void syncWithGrid();
+    void rebuildRegion(int regionIndex);
+    void collectBorderTransitions(int regionA, bool horizontalNeighbor,
+                                  std::vector<std::pair<int, int>>& outTransitions) const;
+
+    // Append the cells leading from one cell to another by walking a BFS parent tree rooted at 'from'
+    void appendTreePath(int regionIndex, const std::vector<int>& parent, int to, std::vector<int>& outReversed) const;
+
+    const CellGrid* grid;
+    int regionsX = 0;
+    int regionsY = 0;
+    std::vector<Region> regions;
+    std::vector<RegionCache> caches;
+    uint64_t syncedVersion = 0;
+};
+
+// Global hierarchical pathfinder instance (created with the cell grid)
+extern HierarchicalPathfinder* g_HierarchicalPathfinder;
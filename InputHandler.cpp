@@ -1,7 +1,7 @@
 #include "sdlHeader.h"
 #include "UnitManager.h"
 #include "InputHandler.h"
-#include "Pathfinding.h"
+#include "PathPlanner.h"
 #include "Food.h"
 #include "Buildings.h"
 
@@ -48,7 +48,7 @@ void handleInput(sdl& app) {
 	if (fHeld && (mouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT))) {
         if (currentTime - lastFoodSpawnTime >= SPAWN_DEBOUNCE_MS) {
             if (app.foodManager) {
-                app.foodManager->spawnFood(mouseX, mouseY, "food");
+                app.foodManager->spawnFood(mouseX, mouseY, "food", app.cellGrid);
                 lastFoodSpawnTime = currentTime;
             }
         }
@@ -58,7 +58,7 @@ void handleInput(sdl& app) {
 	if (cHeld && (mouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT))) {
 		if (currentTime - lastFoodSpawnTime >= SPAWN_DEBOUNCE_MS) {
 			if (app.coinManager) {
-				app.coinManager->spawnCoin(mouseX, mouseY);
+				app.coinManager->spawnCoin(mouseX, mouseY, app.cellGrid);
 				lastFoodSpawnTime = currentTime;
 			}
 		}
@@ -67,21 +67,21 @@ void handleInput(sdl& app) {
     // Path last unit with P + click
     if (pHeld && (mouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT))) {
         if (app.unitManager && app.cellGrid) {
-            auto& units = app.unitManager->getUnits();
-            if (!units.empty()) {
+            Unit* lastPlaced = app.unitManager->getLastSpawned();
+            if (lastPlaced) {
                 // Get last placed unit
-                auto& unit = const_cast<Unit&>(units.back());
+                Unit& unit = *lastPlaced;
 
                 // Convert unit and mouse to grid coordinates
                 int unitGridX, unitGridY, mouseGridX, mouseGridY;
-                app.cellGrid->pixelToGrid(unit.x, unit.y, unitGridX, unitGridY);
+                app.cellGrid->pixelToGrid(unit.x(), unit.y(), unitGridX, unitGridY);
                 app.cellGrid->pixelToGrid(mouseX, mouseY, mouseGridX, mouseGridY);
 
-                // Find path
-                auto path = aStarFindPath(unitGridX, unitGridY, mouseGridX, mouseGridY, *app.cellGrid);
+                // Find path (served from the shared path cache when possible)
+                auto path = planPath(unitGridX, unitGridY, mouseGridX, mouseGridY, *app.cellGrid);
 
                 // Assign path to unit
-                unit.path = path;
+                unit.path = UnitPath(path);
             }
         }
     }
@@ -99,35 +99,29 @@ void handleInput(sdl& app) {
                 int carriedFoodId = -1;
                 int carriedSeedId = -1;
                 for (const auto& unit : app.unitManager->getUnits()) {
-                    if (mouseX >= unit.x - clickRadius && mouseX <= unit.x + clickRadius &&
-                        mouseY >= unit.y - clickRadius && mouseY <= unit.y + clickRadius) {
-                        carriedFoodId = unit.carriedFoodId;
-                        carriedSeedId = unit.carriedSeedId;
+                    if (mouseX >= unit.x() - clickRadius && mouseX <= unit.x() + clickRadius &&
+                        mouseY >= unit.y() - clickRadius && mouseY <= unit.y() + clickRadius) {
+                        carriedFoodId = unit.carriedFoodId();
+                        carriedSeedId = unit.carriedSeedId();
                         break;
                     }
                 }
                 
                 // Delete the unit
-                deletedUnit = app.unitManager->deleteUnitAt(mouseX, mouseY);
+                deletedUnit = app.unitManager->deleteUnitAt(mouseX, mouseY, app.cellGrid);
                 
                 // Clear carried items from food/seed managers
                 if (deletedUnit) {
                     deletedSomething = true;
-                    if (carriedFoodId != -1 && app.foodManager) {
-                        for (auto& foodItem : app.foodManager->getFood()) {
-                            if (foodItem.foodId == carriedFoodId) {
-                                foodItem.carriedByUnitId = -1;
-                                break;
-                            }
-                        }
+                    Food* foodItem = app.foodManager ? app.foodManager->tryGet(carriedFoodId) : nullptr;
+                    if (foodItem) {
+                        app.foodManager->setCarriedBy(*foodItem, -1);
+                        app.cellGrid->addOccupantAtPixel(CellOccupant::Food, foodItem->foodId, foodItem->x, foodItem->y);
                     }
-                    if (carriedSeedId != -1 && app.seedManager) {
-                        for (auto& seedItem : app.seedManager->getSeeds()) {
-                            if (seedItem.seedId == carriedSeedId) {
-                                seedItem.carriedByUnitId = -1;
-                                break;
-                            }
-                        }
+                    Seed* seedItem = app.seedManager ? app.seedManager->tryGet(carriedSeedId) : nullptr;
+                    if (seedItem) {
+                        app.seedManager->setCarriedBy(*seedItem, -1);
+                        app.cellGrid->addOccupantAtPixel(CellOccupant::Seed, seedItem->seedId, seedItem->x, seedItem->y);
                     }
                 }
             }
@@ -145,14 +139,14 @@ void handleInput(sdl& app) {
                 }
                 
                 // Delete the food
-                if (app.foodManager->deleteFoodAt(mouseX, mouseY)) {
+                if (app.foodManager->deleteFoodAt(mouseX, mouseY, app.cellGrid)) {
                     deletedSomething = true;
                     if (deletedFoodId != -1) {
                         // Clear any unit carrying this food
                         if (app.unitManager) {
                             for (auto& unit : app.unitManager->getUnits()) {
-                                if (unit.carriedFoodId == deletedFoodId) {
-                                    unit.carriedFoodId = -1;
+                                if (unit.carriedFoodId() == deletedFoodId) {
+                                    unit.carriedFoodId() = -1;
                                 }
                             }
                         }
@@ -0,0 +1,103 @@
+#include "MovingTargetPlanner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <unordered_map>
+
+MovingTargetPlanner::MovingTargetPlanner(const CellGrid& grid)
+    : grid(grid), syncedVersion(grid.getWalkabilityVersion()) {
+    learned.resize(static_cast<size_t>(grid.getWidthInCells()) * grid.getHeightInCells());
+}
+
+void MovingTargetPlanner::reset() {
+    std::fill(learned.begin(), learned.end(), Learned());
+    lastPath.clear();
+    targetX = -1;
+    targetY = -1;
+    totalTargetShift = 0;
+    ++resets;
+}
+
+void MovingTargetPlanner::syncWithGrid() {
+    uint64_t version = grid.getWalkabilityVersion();
+    if (version == syncedVersion) return;
+
+    // Cells that became blocked only make paths longer, so learned values stay
+    // admissible. A cell that opened may have created a shortcut.
+    std::vector<int> changed;
+    bool resetNeeded = !grid.getWalkabilityChangesSince(syncedVersion, changed);
+    int w = grid.getWidthInCells();
+    for (size_t i = 0; i < changed.size() && !resetNeeded; ++i) {
+        if (grid.isCellWalkable(changed[i] % w, changed[i] / w)) resetNeeded = true;
+    }
+    syncedVersion = version;
+
+    if (resetNeeded) {
+        reset();
+    } else {
+        lastPath.clear();
+    }
+}
+
+int MovingTargetPlanner::heuristic(int cell) const {
+    int w = grid.getWidthInCells();
+    int manhattan = std::abs(cell % w - targetX) + std::abs(cell / w - targetY);
+    const Learned& entry = learned[cell];
+    if (entry.h < 0) return manhattan;
+    return std::max(manhattan, entry.h - (totalTargetShift - entry.shift));
+}
+
+std::vector<std::pair<int, int>> MovingTargetPlanner::findPath(int startX, int startY, int newTargetX, int newTargetY) {
+    lastExpanded = 0;
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return {};
+    if (newTargetX < 0 || newTargetY < 0 || newTargetX >= w || newTargetY >= h) return {};
+
+    syncWithGrid();
+
+    if (newTargetX != targetX || newTargetY != targetY) {
+        if (targetX >= 0) {
+            totalTargetShift += std::abs(newTargetX - targetX) + std::abs(newTargetY - targetY);
+        }
+        targetX = newTargetX;
+        targetY = newTargetY;
+        lastPath.clear();
+    }
+
+    // Same target and the pursuer is still on the last path: keep following it
+    auto onPath = std::find(lastPath.begin(), lastPath.end(), std::make_pair(startX, startY));
+    if (onPath != lastPath.end()) {
+        return std::vector<std::pair<int, int>>(onPath, lastPath.end());
+    }
+
+    auto path = search.findPathWithHeuristic(startX, startY, targetX, targetY, grid,
+        [this](int cell) { return heuristic(cell); }, &expanded);
+    lastExpanded = search.getLastExpandedCount();
+
+    if (!path.empty()) {
+        int goalCost = static_cast<int>(path.size()) - 1;
+        for (const auto& entry : expanded) {
+            learned[entry.first].h = goalCost - entry.second;
+            learned[entry.first].shift = totalTargetShift;
+        }
+    }
+    lastPath = path;
+    return path;
+}
+
+namespace {
+    std::unordered_map<int, std::unique_ptr<MovingTargetPlanner>> g_PursuitPlanners;
+}
+
+MovingTargetPlanner& getPursuitPlanner(int pursuerId, const CellGrid& grid) {
+    auto& planner = g_PursuitPlanners[pursuerId];
+    if (!planner) {
+        planner = std::make_unique<MovingTargetPlanner>(grid);
+    }
+    return *planner;
+}
+
+void releasePursuitPlanner(int pursuerId) {
+    g_PursuitPlanners.erase(pursuerId);
+}
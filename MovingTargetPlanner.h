@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "CellGrid.h"
+#include "Pathfinding.h"
+
+// Incremental planner for chasing a target that moves (Moving Target
+// Adaptive A*).
+//
+// Each search leaves behind what it learned: every expanded cell s gets
+// h(s) = cost(goal) - g(s), which is exact or better than Manhattan distance
+// and stays admissible. When the target moves, the learned values are
+// lowered by the Manhattan distance it moved, so they stay admissible and
+// consistent without being thrown away. Later searches toward the nearby
+// target follow the learned corridor and expand few cells beyond it, so the
+// cost of a replan grows with how far the target moved rather than with the
+// distance to it. If neither end has moved off the last path, the rest of
+// that path is returned without searching at all.
+//
+// One planner per pursuer; see getPursuitPlanner().
+class MovingTargetPlanner {
+public:
+    explicit MovingTargetPlanner(const CellGrid& grid);
+
+    // Path from the pursuer to the target's current cell (both inclusive).
+    // Returns an empty vector if the target is unreachable.
+    std::vector<std::pair<int, int>> findPath(int startX, int startY, int targetX, int targetY);
+
+    // Forget everything learned (done automatically when a cell opens up)
+    void reset();
+
+    // Nodes expanded by the most recent call (0 if it reused the last path)
+    int getLastExpandedCount() const { return lastExpanded; }
+    // Times the learned values were thrown away
+    size_t getResetCount() const { return resets; }
+
+private:
+    struct Learned {
+        int h = -1;      // Learned goal distance, -1 if never learned
+        int shift = 0;   // totalTargetShift when h was learned
+    };
+
+    int heuristic(int cell) const;
+    void syncWithGrid();
+
+    const CellGrid& grid;
+    PathSearchContext search;
+    std::vector<Learned> learned;
+    std::vector<std::pair<int, int>> expanded; // Scratch, reused between searches
+    std::vector<std::pair<int, int>> lastPath;
+    int targetX = -1;
+    int targetY = -1;
+    int totalTargetShift = 0;                  // Sum of Manhattan target moves so far
+    uint64_t syncedVersion = 0;
+    int lastExpanded = 0;
+    size_t resets = 0;
+};
+
+// Planner owned by a pursuing unit, created on first use
+MovingTargetPlanner& getPursuitPlanner(int pursuerId, const CellGrid& grid);
+
+// Drop the pursuer's planner once the chase is over
+void releasePursuitPlanner(int pursuerId);
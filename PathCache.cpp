@@ -0,0 +1,151 @@
+#include "PathCache.h"
+#include <iterator>
+
+PathCache* g_PathCache = nullptr;
+
+PathCache::PathCache(const CellGrid& grid, size_t capacity)
+    : grid(grid), capacity(capacity), syncedVersion(grid.getWalkabilityVersion()) {
+}
+
+uint64_t PathCache::makeKey(int startX, int startY, int goalX, int goalY) const {
+    int w = grid.getWidthInCells();
+    uint64_t startCell = static_cast<uint32_t>(startY * w + startX);
+    uint64_t goalCell = static_cast<uint32_t>(goalY * w + goalX);
+    return (startCell << 32) | goalCell;
+}
+
+void PathCache::erase(std::list<Entry>::iterator it) {
+    int w = grid.getWidthInCells();
+    uint64_t key = it->key;
+    it->path.forEachCell([&](int x, int y) {
+        auto cellIt = keysByCell.find(y * w + x);
+        if (cellIt != keysByCell.end()) {
+            cellIt->second.erase(key);
+            if (cellIt->second.empty()) keysByCell.erase(cellIt);
+        }
+    });
+    unreachableKeys.erase(it->key);
+    index.erase(it->key);
+    entries.erase(it);
+}
+
+void PathCache::clear() {
+    entries.clear();
+    index.clear();
+    keysByCell.clear();
+    unreachableKeys.clear();
+    syncedVersion = grid.getWalkabilityVersion();
+}
+
+void PathCache::syncWithGrid() {
+    uint64_t version = grid.getWalkabilityVersion();
+    if (version == syncedVersion) return;
+
+    std::vector<int> changed;
+    if (!grid.getWalkabilityChangesSince(syncedVersion, changed)) {
+        dropChangedChunks();
+        return;
+    }
+    syncedVersion = version;
+
+    int w = grid.getWidthInCells();
+    bool anyOpened = false;
+    for (int cell : changed) {
+        if (grid.isCellWalkable(cell % w, cell / w)) {
+            anyOpened = true;
+            continue;
+        }
+        // Cell is now blocked: drop every path that walks through it
+        auto cellIt = keysByCell.find(cell);
+        if (cellIt == keysByCell.end()) continue;
+        std::vector<uint64_t> keys(cellIt->second.begin(), cellIt->second.end());
+        for (uint64_t key : keys) {
+            auto it = index.find(key);
+            if (it != index.end()) erase(it->second);
+        }
+    }
+
+    if (anyOpened && !unreachableKeys.empty()) {
+        // A new opening may connect previously unreachable pairs
+        std::vector<uint64_t> keys(unreachableKeys.begin(), unreachableKeys.end());
+        for (uint64_t key : keys) {
+            auto it = index.find(key);
+            if (it != index.end()) erase(it->second);
+        }
+    }
+}
+
+void PathCache::dropChangedChunks() {
+    std::vector<int> changed;
+    grid.getChangedChunksSince(GridLayer::Walkability, syncedVersion, changed);
+    syncedVersion = grid.getWalkabilityVersion();
+    if (changed.empty()) return;
+
+    int widthInChunks = grid.getWidthInChunks();
+    std::vector<bool> dirty(static_cast<size_t>(widthInChunks) * grid.getHeightInChunks(), false);
+    for (int chunk : changed) dirty[chunk] = true;
+
+    // Without the changed cells, any path crossing a changed chunk may be
+    // broken, and any cell there may have opened
+    std::vector<std::list<Entry>::iterator> stale;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        bool crosses = it->path.empty();
+        it->path.forEachCell([&](int x, int y) {
+            crosses = crosses || dirty[(y >> CellGrid::CHUNK_SHIFT) * widthInChunks + (x >> CellGrid::CHUNK_SHIFT)];
+        });
+        if (crosses) stale.push_back(it);
+    }
+    for (auto it : stale) erase(it);
+}
+
+std::list<PathCache::Entry>::iterator PathCache::find(int startX, int startY, int goalX, int goalY) {
+    syncWithGrid();
+
+    auto it = index.find(makeKey(startX, startY, goalX, goalY));
+    if (it == index.end()) {
+        ++misses;
+        return entries.end();
+    }
+    ++hits;
+    // Move to front (most recently used)
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second;
+}
+
+bool PathCache::lookup(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>>& outPath) {
+    auto it = find(startX, startY, goalX, goalY);
+    if (it == entries.end()) return false;
+    outPath = it->path.toCells();
+    return true;
+}
+
+bool PathCache::lookup(int startX, int startY, int goalX, int goalY, UnitPath& outPath) {
+    auto it = find(startX, startY, goalX, goalY);
+    if (it == entries.end()) return false;
+    outPath = it->path;
+    return true;
+}
+
+void PathCache::store(int startX, int startY, int goalX, int goalY, const std::vector<std::pair<int, int>>& path) {
+    if (capacity == 0) return;
+    syncWithGrid();
+
+    uint64_t key = makeKey(startX, startY, goalX, goalY);
+    auto existing = index.find(key);
+    if (existing != index.end()) erase(existing->second);
+
+    while (entries.size() >= capacity) {
+        erase(std::prev(entries.end()));
+    }
+
+    entries.push_front(Entry{ key, UnitPath(path) });
+    index[key] = entries.begin();
+
+    int w = grid.getWidthInCells();
+    if (path.empty()) {
+        unreachableKeys.insert(key);
+    }
+    for (const auto& step : path) {
+        keysByCell[step.second * w + step.first].insert(key);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include "CellGrid.h"
+#include "UnitPath.h"
+
+// Path cache shared by all units.
+//
+// Entries are keyed by (start cell, goal cell) and kept in LRU order up to a
+// fixed capacity. The cache follows the grid's walkability version: on every
+// lookup it pulls the cells changed since it last synced and drops only the
+// entries whose path runs through one of them. A cell that opens up cannot
+// break a cached path, so it only invalidates cached "unreachable" results;
+// surviving paths stay valid, though a newly opened shortcut is not taken
+// until the entry ages out. If the grid's cell log no longer reaches back to
+// the last sync, the entries crossing a chunk changed since then are dropped
+// instead, together with every cached "unreachable".
+class PathCache {
+public:
+    explicit PathCache(const CellGrid& grid, size_t capacity = 1024);
+
+    // Returns true on a hit and copies the cached path (empty = unreachable)
+    bool lookup(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>>& outPath);
+    // Same, but hands out the cached path's shared storage instead of expanding it
+    bool lookup(int startX, int startY, int goalX, int goalY, UnitPath& outPath);
+
+    // Store a freshly computed path (an empty path records "unreachable")
+    void store(int startX, int startY, int goalX, int goalY, const std::vector<std::pair<int, int>>& path);
+
+    void clear();
+
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getSize() const { return entries.size(); }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        UnitPath path; // Compressed; shared with units that take this route
+    };
+
+    uint64_t makeKey(int startX, int startY, int goalX, int goalY) const;
+    void syncWithGrid();
+    void dropChangedChunks();
+    void erase(std::list<Entry>::iterator it);
+    std::list<Entry>::iterator find(int startX, int startY, int goalX, int goalY);
+
+    const CellGrid& grid;
+    size_t capacity;
+    std::list<Entry> entries;                                      // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    std::unordered_map<int, std::unordered_set<uint64_t>> keysByCell; // Cell -> entries whose path uses it
+    std::unordered_set<uint64_t> unreachableKeys;                   // Entries caching "no path"
+    uint64_t syncedVersion = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// Global path cache instance (created with the cell grid)
+extern PathCache* g_PathCache;
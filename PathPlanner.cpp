@@ -0,0 +1,49 @@
+#include "PathPlanner.h"
+#include "Pathfinding.h"
+#include "HierarchicalPathfinding.h"
+#include "PathCache.h"
+#include "FlowField.h"
+
+bool lookupPlannedPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    UnitPath& outPath
+) {
+    // Popular destinations are answered by walking their flow field
+    std::vector<std::pair<int, int>> traced;
+    if (g_FlowFieldService && g_FlowFieldService->tracePath(startX, startY, goalX, goalY, traced)) {
+        outPath = UnitPath(traced);
+        return true;
+    }
+    return g_PathCache && g_PathCache->lookup(startX, startY, goalX, goalY, outPath);
+}
+
+std::vector<std::pair<int, int>> planPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+) {
+    std::vector<std::pair<int, int>> path;
+    if (!grid.canReach(startX, startY, goalX, goalY)) {
+        return path;
+    }
+    // Popular destinations are answered by walking their flow field
+    if (g_FlowFieldService && g_FlowFieldService->tracePath(startX, startY, goalX, goalY, path)) {
+        return path;
+    }
+    if (g_PathCache && g_PathCache->lookup(startX, startY, goalX, goalY, path)) {
+        return path;
+    }
+
+    if (g_HierarchicalPathfinder &&
+        g_HierarchicalPathfinder->getRegionIndexAt(startX, startY) != g_HierarchicalPathfinder->getRegionIndexAt(goalX, goalY)) {
+        path = g_HierarchicalPathfinder->findPath(startX, startY, goalX, goalY);
+    } else {
+        path = findPath(startX, startY, goalX, goalY, grid);
+    }
+
+    if (g_PathCache) {
+        g_PathCache->store(startX, startY, goalX, goalY, path);
+    }
+    return path;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "CellGrid.h"
+#include "UnitPath.h"
+
+// Single entry point for gameplay path requests (unit actions, P+click).
+// Goals in a different connected component are rejected up front.
+// Goals with a flow field (markets, hot houses and farms) are answered by
+// walking the field. Other repeated routes come from the shared path cache;
+// on a miss, trips that cross a region border go through the hierarchical
+// planner (which may return only the first few region hops - callers re-plan
+// when the path runs out) and everything else through findPath().
+std::vector<std::pair<int, int>> planPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+);
+
+// The cheap half of planPath(): a flow field walk or a path cache hit, no
+// search. Returns false if the path would have to be searched for. Cache
+// hits share the cached path's storage rather than copying it.
+bool lookupPlannedPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    UnitPath& outPath
+);
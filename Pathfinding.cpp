@@ -1,82 +1,663 @@
 #include "Pathfinding.h"
-#include <queue>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
 #include <unordered_map>
-#include <cmath>
-#include <limits>
 
-struct Node {
-    int x, y;
-    float g, f;
-    Node* parent;
-    Node(int x, int y, float g, float f, Node* parent)
-        : x(x), y(y), g(g), f(f), parent(parent) {}
-};
+void PathSearchContext::prepare(int width, int height, int statesPerCell) {
+    if (width != gridWidth || height != gridHeight || statesPerCell != gridStatesPerCell) {
+        // Grid size changed (or first use) - reallocate once
+        gridWidth = width;
+        gridHeight = height;
+        gridStatesPerCell = statesPerCell;
+        cells.assign(static_cast<size_t>(width) * height * statesPerCell, CellState());
+        targetMarks.clear();
+        generation = 0;
+    }
 
-struct NodeCmp {
-    bool operator()(const Node* a, const Node* b) const {
-        return a->f > b->f;
+    ++generation;
+    if (generation == 0) {
+        // Counter wrapped around: stale stamps could alias the new generation
+        for (auto& cell : cells) cell.generation = 0;
+        for (auto& mark : targetMarks) mark.generation = 0;
+        generation = 1;
     }
-};
+    heap.clear();
+    lastExpanded = 0;
+}
 
-std::vector<std::pair<int, int>> aStarFindPath(
+void PathSearchContext::siftUp(int index) {
+    HeapEntry entry = heap[index];
+    while (index > 0) {
+        int parentIndex = (index - 1) / 2;
+        if (!heapLess(entry, heap[parentIndex])) break;
+        heap[index] = heap[parentIndex];
+        cells[heap[index].cell].heapIndex = index;
+        index = parentIndex;
+    }
+    heap[index] = entry;
+    cells[entry.cell].heapIndex = index;
+}
+
+void PathSearchContext::siftDown(int index) {
+    int count = static_cast<int>(heap.size());
+    HeapEntry entry = heap[index];
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= count) break;
+        if (child + 1 < count && heapLess(heap[child + 1], heap[child])) ++child;
+        if (!heapLess(heap[child], entry)) break;
+        heap[index] = heap[child];
+        cells[heap[index].cell].heapIndex = index;
+        index = child;
+    }
+    heap[index] = entry;
+    cells[entry.cell].heapIndex = index;
+}
+
+void PathSearchContext::heapPush(const HeapEntry& entry) {
+    heap.push_back(entry);
+    siftUp(static_cast<int>(heap.size()) - 1);
+}
+
+void PathSearchContext::heapUpdate(int heapIndex, const HeapEntry& entry) {
+    // Only ever called with a lower f, so the entry can only move up
+    heap[heapIndex] = entry;
+    siftUp(heapIndex);
+}
+
+PathSearchContext::HeapEntry PathSearchContext::heapPop() {
+    HeapEntry top = heap.front();
+    HeapEntry last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        siftDown(0);
+    }
+    return top;
+}
+
+template <typename Heuristic>
+void PathSearchContext::expandNeighbors(int cell, const CellGrid& grid, Heuristic& heuristic) {
+    int w = gridWidth;
+    int cx = cell % w;
+    int cy = cell / w;
+    const CellState& currentState = cells[cell];
+    // The plane's blocked border stands in for the bounds check
+    const WalkabilityPlane& walkable = grid.getWalkabilityPlane();
+
+    // 4 directions
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    for (int dir = 0; dir < 4; ++dir) {
+        int nx = cx + dx[dir];
+        int ny = cy + dy[dir];
+        if (!walkable.isOpen(nx, ny)) continue;
+
+        int neighbor = ny * w + nx;
+        int ng = currentState.g + 1;
+        CellState& state = cells[neighbor];
+
+        if (!isOpenOrClosed(neighbor)) {
+            state.generation = generation;
+            state.g = ng;
+            state.parent = cell;
+            int nh = heuristic(neighbor);
+            heapPush({ ng + nh, nh, neighbor });
+        } else if (state.heapIndex >= 0 && ng < state.g) {
+            // The heuristic is consistent (Manhattan distance is on a
+            // unit-cost grid), so closed nodes never need reopening
+            state.g = ng;
+            state.parent = cell;
+            int nh = heuristic(neighbor);
+            heapUpdate(state.heapIndex, { ng + nh, nh, neighbor });
+        }
+    }
+}
+
+template <typename Heuristic>
+std::vector<std::pair<int, int>> PathSearchContext::searchAStar(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid,
+    Heuristic heuristic,
+    std::vector<std::pair<int, int>>* expanded
+) {
+    std::vector<std::pair<int, int>> path;
+    if (expanded) expanded->clear();
+
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return path;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return path;
+    // Different connected components: unreachable without expanding anything
+    if (!grid.canReach(startX, startY, goalX, goalY)) {
+        lastExpanded = 0;
+        return path;
+    }
+
+    prepare(w, h);
+
+    int startCell = startY * w + startX;
+    int goalCell = goalY * w + goalX;
+
+    CellState& start = cells[startCell];
+    start.generation = generation;
+    start.g = 0;
+    start.parent = -1;
+    int startH = heuristic(startCell);
+    heapPush({ startH, startH, startCell });
+
+    bool found = false;
+    while (!heap.empty()) {
+        HeapEntry current = heapPop();
+        CellState& currentState = cells[current.cell];
+        currentState.heapIndex = CLOSED;
+        ++lastExpanded;
+        if (expanded) expanded->emplace_back(current.cell, currentState.g);
+
+        if (current.cell == goalCell) {
+            found = true;
+            break;
+        }
+
+        expandNeighbors(current.cell, grid, heuristic);
+    }
+
+    if (!found) return path;
+
+    // Reconstruct path
+    for (int cell = goalCell; cell != -1; cell = cells[cell].parent) {
+        path.emplace_back(cell % w, cell / w);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<std::pair<int, int>> PathSearchContext::findPath(
     int startX, int startY,
     int goalX, int goalY,
     const CellGrid& grid
 ) {
+    int w = grid.getWidthInCells();
+    auto heuristic = [w, goalX, goalY](int cell) {
+        return std::abs(cell % w - goalX) + std::abs(cell / w - goalY);
+    };
+    return searchAStar(startX, startY, goalX, goalY, grid, heuristic, nullptr);
+}
+
+std::vector<std::pair<int, int>> PathSearchContext::findPathWithHeuristic(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid,
+    const std::function<int(int)>& heuristic,
+    std::vector<std::pair<int, int>>* expanded
+) {
+    return searchAStar(startX, startY, goalX, goalY, grid, std::cref(heuristic), expanded);
+}
+
+int PathSearchContext::findNearestTarget(
+    int startX, int startY,
+    const std::vector<std::pair<int, int>>& targets,
+    const CellGrid& grid,
+    std::vector<std::pair<int, int>>& outPath,
+    int maxCost
+) {
+    outPath.clear();
+    lastExpanded = 0;
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return -1;
+
+    prepare(w, h);
+    if (targetMarks.size() != static_cast<size_t>(w) * h) {
+        targetMarks.assign(static_cast<size_t>(w) * h, TargetMark());
+    }
+
+    int reachableTargets = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        int tx = targets[i].first;
+        int ty = targets[i].second;
+        if (tx < 0 || ty < 0 || tx >= w || ty >= h) continue;
+        if (!grid.canReach(startX, startY, tx, ty)) continue;
+        TargetMark& mark = targetMarks[ty * w + tx];
+        if (mark.generation == generation) continue; // Earlier target on the same cell wins
+        mark.generation = generation;
+        mark.target = static_cast<int>(i);
+        ++reachableTargets;
+    }
+    if (reachableTargets == 0) return -1;
+
+    int startCell = startY * w + startX;
+    CellState& start = cells[startCell];
+    start.generation = generation;
+    start.g = 0;
+    start.parent = -1;
+    heapPush({ 0, 0, startCell });
+
+    // No single goal to aim at, so no heuristic: plain Dijkstra
+    auto noHeuristic = [](int) { return 0; };
+    while (!heap.empty()) {
+        HeapEntry current = heapPop();
+        if (maxCost >= 0 && current.f > maxCost) break;
+        cells[current.cell].heapIndex = CLOSED;
+        ++lastExpanded;
+
+        const TargetMark& mark = targetMarks[current.cell];
+        if (mark.generation == generation) {
+            buildPathTo(current.cell, -1, -1, outPath);
+            return mark.target;
+        }
+        expandNeighbors(current.cell, grid, noHeuristic);
+    }
+    return -1;
+}
+
+void PathSearchContext::beginSearch(int startX, int startY, int goalX, int goalY, const CellGrid& grid) {
+    activeGrid = nullptr;
     int w = grid.getWidthInCells();
     int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return;
+    // Different connected components: unreachable without expanding anything
+    if (!grid.canReach(startX, startY, goalX, goalY)) return;
+
+    prepare(w, h);
+    activeGrid = &grid;
+    activeVersion = grid.getWalkabilityVersion();
+    activeStartCell = startY * w + startX;
+    activeGoalCell = goalY * w + goalX;
+    bestCell = activeStartCell;
+    bestH = std::abs(startX - goalX) + std::abs(startY - goalY);
+
+    CellState& start = cells[activeStartCell];
+    start.generation = generation;
+    start.g = 0;
+    start.parent = -1;
+    heapPush({ bestH, bestH, activeStartCell });
+}
+
+PathSearchStatus PathSearchContext::continueSearch(
+    int maxExpansions,
+    std::vector<std::pair<int, int>>& outPath,
+    int fromX, int fromY
+) {
+    outPath.clear();
+    lastExpanded = 0;
+    if (!activeGrid) return PathSearchStatus::Unreachable;
+
+    const CellGrid& grid = *activeGrid;
+    int w = gridWidth;
+    int goalX = activeGoalCell % w;
+    int goalY = activeGoalCell / w;
 
-    auto heuristic = [](int x1, int y1, int x2, int y2) {
-        return static_cast<float>(std::abs(x1 - x2) + std::abs(y1 - y2));
+    // Walkability changed since the search began: start over from where the caller stands
+    if (grid.getWalkabilityVersion() != activeVersion) {
+        bool fromOnGrid = fromX >= 0 && fromY >= 0 && fromX < w && fromY < gridHeight;
+        beginSearch(fromOnGrid ? fromX : activeStartCell % w, fromOnGrid ? fromY : activeStartCell / w, goalX, goalY, grid);
+        if (!activeGrid) return PathSearchStatus::Unreachable;
+    }
+    auto heuristic = [w, goalX, goalY](int cell) {
+        return std::abs(cell % w - goalX) + std::abs(cell / w - goalY);
     };
 
-    std::priority_queue<Node*, std::vector<Node*>, NodeCmp> open;
-    std::unordered_map<int, Node*> allNodes;
-    auto hash = [w](int x, int y) { return y * w + x; };
+    while (lastExpanded < maxExpansions && !heap.empty()) {
+        HeapEntry current = heapPop();
+        cells[current.cell].heapIndex = CLOSED;
+        ++lastExpanded;
 
-    Node* start = new Node(startX, startY, 0.0f, heuristic(startX, startY, goalX, goalY), nullptr);
-    open.push(start);
-    allNodes[hash(startX, startY)] = start;
+        if (current.cell == activeGoalCell) {
+            activeGrid = nullptr;
+            buildPathTo(activeGoalCell, fromX, fromY, outPath);
+            return PathSearchStatus::Found;
+        }
+        // Closest expanded cell so far; ties go to the cheaper one
+        if (current.h < bestH || (current.h == bestH && cells[current.cell].g < cells[bestCell].g)) {
+            bestCell = current.cell;
+            bestH = current.h;
+        }
+        expandNeighbors(current.cell, grid, heuristic);
+    }
 
-    std::vector<std::pair<int, int>> path;
-    bool found = false;
+    if (heap.empty()) {
+        activeGrid = nullptr;
+        return PathSearchStatus::Unreachable;
+    }
+    if (bestCell == activeStartCell) {
+        return PathSearchStatus::BudgetExhausted;
+    }
+    buildPathTo(bestCell, fromX, fromY, outPath);
+    return PathSearchStatus::Partial;
+}
+
+void PathSearchContext::buildPathTo(int targetCell, int fromX, int fromY, std::vector<std::pair<int, int>>& outPath) const {
+    int w = gridWidth;
+    outPath.clear();
+    for (int cell = targetCell; cell != -1; cell = cells[cell].parent) {
+        outPath.emplace_back(cell % w, cell / w);
+    }
+    std::reverse(outPath.begin(), outPath.end());
 
-    while (!open.empty()) {
-        Node* current = open.top();
-        open.pop();
+    // Re-root at the caller's cell if it has walked part-way down an earlier
+    // partial path. Such a cell is expanded, so its parent chain is final:
+    // climb it until it meets the path, then follow the path from there.
+    if (fromX < 0 || fromY < 0 || fromX >= w || fromY >= gridHeight) return;
+    int fromCell = fromY * w + fromX;
+    if (fromCell == activeStartCell || cells[fromCell].generation != generation || cells[fromCell].heapIndex != CLOSED) return;
 
-        if (current->x == goalX && current->y == goalY) {
-            // Reconstruct path
-            while (current) {
-                path.emplace_back(current->x, current->y);
-                current = current->parent;
+    std::unordered_map<int, size_t> positionOnPath;
+    for (size_t i = 0; i < outPath.size(); ++i) {
+        positionOnPath[outPath[i].second * w + outPath[i].first] = i;
+    }
+    std::vector<std::pair<int, int>> rerooted;
+    int cell = fromCell;
+    auto joined = positionOnPath.end();
+    while (cell != -1 && (joined = positionOnPath.find(cell)) == positionOnPath.end()) {
+        rerooted.emplace_back(cell % w, cell / w);
+        cell = cells[cell].parent;
+    }
+    if (joined == positionOnPath.end()) return;
+    rerooted.insert(rerooted.end(), outPath.begin() + joined->second, outPath.end());
+    outPath.swap(rerooted);
+}
+
+// Jump Point Search for a 4-connected grid.
+//
+// Shortest paths are restricted to a canonical form: vertical moves may turn
+// horizontal anywhere, but a horizontal run only turns vertical where the cell
+// diagonally behind is blocked (otherwise the vertical step could have been
+// taken one cell earlier at the same cost). Horizontal jumps therefore stop at
+// such "forced" cells, and vertical jumps stop at any cell whose horizontal
+// scans find a jump point. Each cell keeps one search state per arrival axis
+// because the two axes allow different successors.
+//
+// Horizontal scans read the walkability plane 64 cells at a time: one word
+// each for the row and the rows above and below gives every blocked, forced
+// and goal cell in the window at once, and the nearest one is a bit scan.
+namespace {
+    enum Axis { AXIS_VERTICAL = 0, AXIS_HORIZONTAL = 1 };
+
+    struct JumpScanner {
+        const WalkabilityPlane& plane;
+        int goalX, goalY;
+
+        bool open(int x, int y) const { return plane.isOpen(x, y); }
+
+        // Returns true and the jump point in outX if a horizontal run from (x, y) finds one
+        bool jumpHorizontal(int x, int y, int dx, int& outX) const {
+            // A cell stops the run if it is blocked (no jump point), the goal,
+            // or forced: open above/below with the cell diagonally behind blocked.
+            // The border column is blocked, so every run stops on the grid's edge.
+            if (dx > 0) {
+                for (int first = x + 1; ; first += 64) {
+                    uint64_t blocked = ~plane.rowBitsFrom(first, y);
+                    uint64_t above = plane.rowBitsFrom(first, y - 1);
+                    uint64_t below = plane.rowBitsFrom(first, y + 1);
+                    uint64_t stops = blocked |
+                        (above & ~plane.rowBitsFrom(first - 1, y - 1)) |
+                        (below & ~plane.rowBitsFrom(first - 1, y + 1));
+                    if (y == goalY && goalX >= first && goalX < first + 64) {
+                        stops |= uint64_t(1) << (goalX - first);
+                    }
+                    if (stops) {
+                        int bit = WalkabilityPlane::lowestBit(stops);
+                        if ((blocked >> bit) & 1) return false;
+                        outX = first + bit;
+                        return true;
+                    }
+                }
             }
-            std::reverse(path.begin(), path.end());
-            found = true;
+            for (int last = x - 1; ; last -= 64) {
+                // Bit 63 is column last, bit 62 is last - 1, ...
+                uint64_t blocked = ~plane.rowBitsUpTo(last, y);
+                uint64_t above = plane.rowBitsUpTo(last, y - 1);
+                uint64_t below = plane.rowBitsUpTo(last, y + 1);
+                uint64_t stops = blocked |
+                    (above & ~plane.rowBitsUpTo(last + 1, y - 1)) |
+                    (below & ~plane.rowBitsUpTo(last + 1, y + 1));
+                if (y == goalY && goalX <= last && goalX > last - 64) {
+                    stops |= uint64_t(1) << (63 - (last - goalX));
+                }
+                if (stops) {
+                    int bit = WalkabilityPlane::highestBit(stops);
+                    if ((blocked >> bit) & 1) return false;
+                    outX = last - (63 - bit);
+                    return true;
+                }
+            }
+        }
+
+        bool jumpVertical(int x, int y, int dy, int& outY) const {
+            int ignored;
+            while (true) {
+                y += dy;
+                if (!open(x, y)) return false;
+                if (x == goalX && y == goalY) break;
+                if (jumpHorizontal(x, y, 1, ignored) || jumpHorizontal(x, y, -1, ignored)) break;
+            }
+            outY = y;
+            return true;
+        }
+    };
+
+    int signOf(int v) { return (v > 0) - (v < 0); }
+}
+
+std::vector<std::pair<int, int>> PathSearchContext::findPathJPS(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+) {
+    std::vector<std::pair<int, int>> path;
+
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    if (startX < 0 || startY < 0 || startX >= w || startY >= h) return path;
+    if (goalX < 0 || goalY < 0 || goalX >= w || goalY >= h) return path;
+
+    if (startX == goalX && startY == goalY) {
+        path.emplace_back(startX, startY);
+        return path;
+    }
+    if (!grid.isCellWalkable(goalX, goalY)) return path;
+    if (!grid.canReach(startX, startY, goalX, goalY)) {
+        lastExpanded = 0;
+        return path;
+    }
+
+    prepare(w, h, 2);
+    JumpScanner scanner{ grid.getWalkabilityPlane(), goalX, goalY };
+
+    auto heuristic = [goalX, goalY](int x, int y) {
+        return std::abs(x - goalX) + std::abs(y - goalY);
+    };
+    auto stateOf = [w](int x, int y, int axis) { return (y * w + x) * 2 + axis; };
+
+    // The start behaves like a vertical arrival, but may also head either way vertically
+    int startState = stateOf(startX, startY, AXIS_VERTICAL);
+    CellState& start = cells[startState];
+    start.generation = generation;
+    start.g = 0;
+    start.parent = -1;
+    int startH = heuristic(startX, startY);
+    heapPush({ startH, startH, startState });
+
+    int goalState = -1;
+    while (!heap.empty()) {
+        HeapEntry current = heapPop();
+        CellState& currentState = cells[current.cell];
+        currentState.heapIndex = CLOSED;
+        ++lastExpanded;
+
+        int cellIndex = current.cell / 2;
+        int axis = current.cell % 2;
+        int cx = cellIndex % w;
+        int cy = cellIndex / w;
+        if (cx == goalX && cy == goalY) {
+            goalState = current.cell;
             break;
         }
 
-        // 4 directions
-        const int dx[4] = {1, -1, 0, 0};
-        const int dy[4] = {0, 0, 1, -1};
-        for (int dir = 0; dir < 4; ++dir) {
-            int nx = current->x + dx[dir];
-            int ny = current->y + dy[dir];
-            if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
-            if (!grid.isCellWalkable(nx, ny)) continue;
-
-            float ng = current->g + 1.0f;
-            int nhash = hash(nx, ny);
-            if (!allNodes.count(nhash) || ng < allNodes[nhash]->g) {
-                Node* neighbor = new Node(nx, ny, ng, ng + heuristic(nx, ny, goalX, goalY), current);
-                open.push(neighbor);
-                allNodes[nhash] = neighbor;
+        // Direction we arrived from (0, 0 at the start)
+        int dirX = 0, dirY = 0;
+        if (currentState.parent != -1) {
+            int parentCell = currentState.parent / 2;
+            dirX = signOf(cx - parentCell % w);
+            dirY = signOf(cy - parentCell / w);
+        }
+
+        auto relax = [&](int nx, int ny, int nextAxis) {
+            int next = stateOf(nx, ny, nextAxis);
+            int ng = currentState.g + std::abs(nx - cx) + std::abs(ny - cy);
+            CellState& state = cells[next];
+            if (!isOpenOrClosed(next)) {
+                state.generation = generation;
+                state.g = ng;
+                state.parent = current.cell;
+                int nh = heuristic(nx, ny);
+                heapPush({ ng + nh, nh, next });
+            } else if (state.heapIndex >= 0 && ng < state.g) {
+                state.g = ng;
+                state.parent = current.cell;
+                int nh = heuristic(nx, ny);
+                heapUpdate(state.heapIndex, { ng + nh, nh, next });
+            }
+        };
+        auto tryVertical = [&](int dy) {
+            int jy;
+            if (scanner.jumpVertical(cx, cy, dy, jy)) relax(cx, jy, AXIS_VERTICAL);
+        };
+        auto tryHorizontal = [&](int dx) {
+            int jx;
+            if (scanner.jumpHorizontal(cx, cy, dx, jx)) relax(jx, cy, AXIS_HORIZONTAL);
+        };
+
+        if (axis == AXIS_VERTICAL) {
+            // Keep going vertically (both ways from the start), or turn either way
+            if (dirY >= 0) tryVertical(1);
+            if (dirY <= 0) tryVertical(-1);
+            tryHorizontal(1);
+            tryHorizontal(-1);
+        } else {
+            // Keep going horizontally; turn only where the turn is forced
+            tryHorizontal(dirX);
+            for (int dy = -1; dy <= 1; dy += 2) {
+                if (scanner.open(cx, cy + dy) && !scanner.open(cx - dirX, cy + dy)) {
+                    tryVertical(dy);
+                }
             }
         }
     }
 
-    // Clean up
-    for (auto& kv : allNodes) delete kv.second;
-    if (!found) path.clear();
+    if (goalState == -1) return path;
+
+    // Expand the straight segments between jump points back into cells
+    std::vector<int> jumpPoints;
+    for (int state = goalState; state != -1; state = cells[state].parent) {
+        jumpPoints.push_back(state / 2);
+    }
+    std::reverse(jumpPoints.begin(), jumpPoints.end());
+
+    path.emplace_back(startX, startY);
+    for (size_t i = 1; i < jumpPoints.size(); ++i) {
+        int x = jumpPoints[i - 1] % w, y = jumpPoints[i - 1] / w;
+        int tx = jumpPoints[i] % w, ty = jumpPoints[i] / w;
+        int stepX = signOf(tx - x), stepY = signOf(ty - y);
+        while (x != tx || y != ty) {
+            x += stepX;
+            y += stepY;
+            path.emplace_back(x, y);
+        }
+    }
     return path;
 }
+
+PathSearchContext& getThreadPathSearchContext() {
+    thread_local PathSearchContext context;
+    return context;
+}
+
+std::vector<std::pair<int, int>> aStarFindPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+) {
+    return getThreadPathSearchContext().findPath(startX, startY, goalX, goalY, grid);
+}
+
+int nearestTargetFindPath(
+    int startX, int startY,
+    const std::vector<std::pair<int, int>>& targets,
+    const CellGrid& grid,
+    std::vector<std::pair<int, int>>& outPath,
+    int maxCost
+) {
+    return getThreadPathSearchContext().findNearestTarget(startX, startY, targets, grid, outPath, maxCost);
+}
+
+PathSearchStatus budgetedFindPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid,
+    int maxExpansions,
+    std::vector<std::pair<int, int>>& outPath
+) {
+    PathSearchContext& context = getThreadPathSearchContext();
+    context.beginSearch(startX, startY, goalX, goalY, grid);
+    PathSearchStatus status = context.continueSearch(maxExpansions, outPath);
+    // Single-shot: the shared context must not be left mid-search
+    context.cancelSearch();
+    return status;
+}
+
+namespace {
+    int g_TickExpansionsLeft = 0;
+}
+
+void beginPathfindingTick(int expansionBudget) {
+    g_TickExpansionsLeft = expansionBudget;
+}
+
+int claimTickExpansions(int wanted) {
+    int granted = std::min(wanted, g_TickExpansionsLeft);
+    if (granted < 0) granted = 0;
+    g_TickExpansionsLeft -= granted;
+    return granted;
+}
+
+void refundTickExpansions(int unused) {
+    if (unused > 0) g_TickExpansionsLeft += unused;
+}
+
+int getTickExpansionsLeft() {
+    return g_TickExpansionsLeft;
+}
+
+std::vector<std::pair<int, int>> jpsFindPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+) {
+    return getThreadPathSearchContext().findPathJPS(startX, startY, goalX, goalY, grid);
+}
+
+static PathfindingBackend g_PathfindingBackend = PathfindingBackend::AStar;
+
+void setPathfindingBackend(PathfindingBackend backend) {
+    g_PathfindingBackend = backend;
+}
+
+PathfindingBackend getPathfindingBackend() {
+    return g_PathfindingBackend;
+}
+
+std::vector<std::pair<int, int>> findPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+) {
+    if (g_PathfindingBackend == PathfindingBackend::JumpPoint) {
+        return jpsFindPath(startX, startY, goalX, goalY, grid);
+    }
+    return aStarFindPath(startX, startY, goalX, goalY, grid);
+}
@@ -1,10 +1,219 @@
 #pragma once
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <functional>
 #include "CellGrid.h"
 
+// Search algorithm used by findPath()
+enum class PathfindingBackend {
+    AStar,      // Plain 4-connected A*
+    JumpPoint   // Jump Point Search: same path lengths, far fewer node expansions
+};
+
+// Outcome of an expansion-budgeted search (see PathSearchContext::continueSearch)
+enum class PathSearchStatus {
+    Found,           // Complete path to the goal
+    Partial,         // Budget spent; path leads to the explored cell closest to the goal
+    Unreachable,     // Every reachable cell explored without finding the goal
+    BudgetExhausted  // Budget spent before getting any closer than the start; no path yet
+};
+
+// Reusable A* workspace.
+// All per-cell search state lives in one flat array sized to the grid
+// (width * height). Each entry carries the generation it was written in, so
+// starting a new search is just a counter bump - nothing is cleared or freed
+// between searches. The open list is an indexed binary heap over cell indices,
+// which lets a better g-score update a node in place instead of pushing a
+// duplicate.
+class PathSearchContext {
+public:
+    PathSearchContext() = default;
+
+    // Find a 4-connected path from start to goal (inclusive of both ends).
+    // Returns an empty vector if the goal is unreachable.
+    std::vector<std::pair<int, int>> findPath(
+        int startX, int startY,
+        int goalX, int goalY,
+        const CellGrid& grid
+    );
+
+    // Jump Point Search over the same 4-connected, unit-cost grid. Returns the
+    // full cell-by-cell path (jump points expanded), same length as findPath.
+    std::vector<std::pair<int, int>> findPathJPS(
+        int startX, int startY,
+        int goalX, int goalY,
+        const CellGrid& grid
+    );
+
+    // A* with a caller-supplied heuristic over flat cell indices (y * width + x).
+    // The heuristic must be consistent. If expanded is given it receives every
+    // expanded cell with its cost from the start, which is what incremental
+    // planners learn from.
+    std::vector<std::pair<int, int>> findPathWithHeuristic(
+        int startX, int startY,
+        int goalX, int goalY,
+        const CellGrid& grid,
+        const std::function<int(int)>& heuristic,
+        std::vector<std::pair<int, int>>* expanded = nullptr
+    );
+
+    // Dijkstra outward from the start that stops at the first target cell it
+    // settles, so the result is the nearest target by walking distance rather
+    // than straight-line distance. Returns the index into targets of the one
+    // reached (the first listed if several share a cell) and the path to it,
+    // or -1 if none is reachable within maxCost steps (-1 = no limit).
+    // Targets in other connected components are dropped before searching.
+    int findNearestTarget(
+        int startX, int startY,
+        const std::vector<std::pair<int, int>>& targets,
+        const CellGrid& grid,
+        std::vector<std::pair<int, int>>& outPath,
+        int maxCost = -1
+    );
+
+    // Resumable, expansion-budgeted A*. beginSearch() sets a search up and each
+    // continueSearch() call expands at most maxExpansions more nodes. Partial
+    // and BudgetExhausted leave the search active to be continued later (on a
+    // later tick); Found and Unreachable end it. While a search is active this
+    // context must not be used for any other search.
+    //
+    // Paths run from the start, or from (fromX, fromY) if the caller has since
+    // walked part-way down an earlier partial path.
+    //
+    // If the grid's walkability changed since beginSearch(), what the search
+    // has explored may lead through cells blocked since, so continueSearch()
+    // starts it over from (fromX, fromY), or from the start if not given.
+    void beginSearch(int startX, int startY, int goalX, int goalY, const CellGrid& grid);
+    PathSearchStatus continueSearch(
+        int maxExpansions,
+        std::vector<std::pair<int, int>>& outPath,
+        int fromX = -1, int fromY = -1
+    );
+    bool isSearchActive() const { return activeGrid != nullptr; }
+    void cancelSearch() { activeGrid = nullptr; }
+    int getSearchGoalX() const { return activeGoalCell % gridWidth; }
+    int getSearchGoalY() const { return activeGoalCell / gridWidth; }
+
+    // Number of nodes expanded by the most recent search (for profiling)
+    int getLastExpandedCount() const { return lastExpanded; }
+
+private:
+    struct CellState {
+        uint32_t generation = 0; // Search that last touched this cell
+        int g = 0;               // Cost from start
+        int parent = -1;         // Index of the cell we came from
+        int heapIndex = -1;      // Position in heap, or CLOSED once expanded
+    };
+
+    struct HeapEntry {
+        int f;    // g + h
+        int h;    // Heuristic, used to break ties toward the goal
+        int cell; // Flat cell (or state) index
+    };
+
+    static constexpr int CLOSED = -2;
+
+    template <typename Heuristic>
+    std::vector<std::pair<int, int>> searchAStar(
+        int startX, int startY,
+        int goalX, int goalY,
+        const CellGrid& grid,
+        Heuristic heuristic,
+        std::vector<std::pair<int, int>>* expanded
+    );
+
+    template <typename Heuristic>
+    void expandNeighbors(int cell, const CellGrid& grid, Heuristic& heuristic);
+    void buildPathTo(int targetCell, int fromX, int fromY, std::vector<std::pair<int, int>>& outPath) const;
+
+    // statesPerCell > 1 gives each cell several search states (JPS keeps one per arrival axis)
+    void prepare(int width, int height, int statesPerCell = 1);
+    bool isOpenOrClosed(int state) const { return cells[state].generation == generation; }
+
+    void heapPush(const HeapEntry& entry);
+    void heapUpdate(int heapIndex, const HeapEntry& entry);
+    HeapEntry heapPop();
+    void siftUp(int index);
+    void siftDown(int index);
+    static bool heapLess(const HeapEntry& a, const HeapEntry& b) {
+        return a.f < b.f || (a.f == b.f && a.h < b.h);
+    }
+
+    struct TargetMark {
+        uint32_t generation = 0; // Search that marked this cell as a target
+        int target = -1;         // Index into that search's target list
+    };
+
+    std::vector<CellState> cells;
+    std::vector<TargetMark> targetMarks; // Per cell, only used by findNearestTarget
+    std::vector<HeapEntry> heap;
+    int gridWidth = 0;
+    int gridHeight = 0;
+    int gridStatesPerCell = 0;
+    uint32_t generation = 0;
+    int lastExpanded = 0;
+
+    // Budgeted search in progress (activeGrid is null when there is none)
+    const CellGrid* activeGrid = nullptr;
+    uint64_t activeVersion = 0; // Grid walkability version at beginSearch()
+    int activeStartCell = -1;
+    int activeGoalCell = -1;
+    int bestCell = -1;
+    int bestH = 0;
+};
+
+// Per-thread search context shared by every aStarFindPath call on that thread
+PathSearchContext& getThreadPathSearchContext();
+
 std::vector<std::pair<int, int>> aStarFindPath(
     int startX, int startY,
     int goalX, int goalY,
     const CellGrid& grid
-);
\ No newline at end of file
+);
+
+std::vector<std::pair<int, int>> jpsFindPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+);
+
+// Nearest of several targets by walking distance, on the thread's shared
+// context (see PathSearchContext::findNearestTarget)
+int nearestTargetFindPath(
+    int startX, int startY,
+    const std::vector<std::pair<int, int>>& targets,
+    const CellGrid& grid,
+    std::vector<std::pair<int, int>>& outPath,
+    int maxCost = -1
+);
+
+// Single-shot budgeted A* on the thread's shared context. Never leaves a
+// search active, so Partial here just means "best effort within budget".
+PathSearchStatus budgetedFindPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid,
+    int maxExpansions,
+    std::vector<std::pair<int, int>>& outPath
+);
+
+// Node expansions that main-thread searches may spend per tick, shared by all
+// units so frame time stays bounded however many of them plan at once. The
+// game loop refills it with beginPathfindingTick(); searches claim a slice
+// before running and refund whatever they did not use.
+void beginPathfindingTick(int expansionBudget);
+int claimTickExpansions(int wanted);
+void refundTickExpansions(int unused);
+int getTickExpansionsLeft();
+
+// Backend used by findPath(); defaults to AStar
+void setPathfindingBackend(PathfindingBackend backend);
+PathfindingBackend getPathfindingBackend();
+
+// Find a path with the currently selected backend
+std::vector<std::pair<int, int>> findPath(
+    int startX, int startY,
+    int goalX, int goalY,
+    const CellGrid& grid
+);
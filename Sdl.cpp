@@ -3,8 +3,14 @@
 #include "UnitManager.h"
 #include <SDL_ttf.h>
 #include <iostream>
+#include <thread>
 #include "Food.h"
 #include "Buildings.h"
+#include "HierarchicalPathfinding.h"
+#include "PathCache.h"
+#include "FlowField.h"
+#include "AsyncPathService.h"
+#include "CooperativePlanner.h"
 
 
 sdl runSdl() {
@@ -20,6 +26,14 @@ sdl runSdl() {
     SDL_GetWindowSize(state.window, &gridWidth, &gridHeight);
 
     state.cellGrid = new CellGrid(gridWidth, gridHeight);
+    g_HierarchicalPathfinder = new HierarchicalPathfinder(*state.cellGrid);
+    g_PathCache = new PathCache(*state.cellGrid);
+    g_FlowFieldService = new FlowFieldService(*state.cellGrid);
+    g_CooperativePlanner = new CooperativePlanner(*state.cellGrid);
+    // Single-core machines search on the main thread under the per-tick expansion budget instead
+    if (std::thread::hardware_concurrency() > 1) {
+        g_AsyncPathService = new AsyncPathService();
+    }
     state.showCellGrid = false;
     
     state.unitManager = new UnitManager();
@@ -61,6 +75,34 @@ void sdlDestroyWindow(sdl& app) {
     if (app.window) {
         SDL_DestroyWindow(app.window);
     }
+    if (g_AsyncPathService) {
+        AsyncPathStats stats = g_AsyncPathService->getStats();
+        std::cout << "Async paths: " << stats.integrated << " integrated, " << stats.cancelled << " cancelled, "
+                  << "avg latency " << stats.averageLatencyMs << " ms (" << stats.averageLatencyTicks << " ticks), "
+                  << "max " << stats.maxLatencyMs << " ms" << std::endl;
+        // Joins the workers before the grid goes away
+        delete g_AsyncPathService;
+        g_AsyncPathService = nullptr;
+    }
+    if (g_CooperativePlanner) {
+        CooperativeStats stats = g_CooperativePlanner->getStats();
+        std::cout << "Cooperative windows: " << stats.replans << " planned, " << stats.rerouted << " rerouted, "
+                  << stats.waitsInserted << " waits, " << stats.deferred << " deferred" << std::endl;
+        delete g_CooperativePlanner;
+        g_CooperativePlanner = nullptr;
+    }
+    if (g_FlowFieldService) {
+        delete g_FlowFieldService;
+        g_FlowFieldService = nullptr;
+    }
+    if (g_PathCache) {
+        delete g_PathCache;
+        g_PathCache = nullptr;
+    }
+    if (g_HierarchicalPathfinder) {
+        delete g_HierarchicalPathfinder;
+        g_HierarchicalPathfinder = nullptr;
+    }
     if (app.cellGrid) {
         delete app.cellGrid;
     }
@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+
+// Generational slot map: items live packed in a dense vector and are named
+// by 32-bit handles that stay valid until the item is erased.
+//
+// A handle is a slot index plus the slot's generation. Each slot points at
+// its item's position in the dense vector; erasing moves the last item into
+// the gap (O(1)), repoints that item's slot, and bumps the erased slot's
+// generation so every handle still naming it goes stale. Freed slots are
+// reused, oldest first.
+//
+// Handles are positive ints, so they fit the places that already store item
+// ids as int with -1 for "none" (cell lists, house storage, farm plots,
+// market stalls). A stale or made-up handle is never mistaken for a live one
+// unless its slot has been reused 2^GENERATION_BITS times since.
+template <typename T>
+class SlotMap {
+public:
+    static constexpr int INDEX_BITS = 20;       // Up to ~1M live items
+    static constexpr int GENERATION_BITS = 11;  // Top bit stays clear, so handles are positive
+    static constexpr uint32_t INDEX_MASK = (uint32_t(1) << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (uint32_t(1) << GENERATION_BITS) - 1;
+
+    // Add an item; returns its handle. Throws std::length_error rather than
+    // hand out a handle whose index would not fit in INDEX_BITS (it would
+    // alias a live item's).
+    int insert(T value) {
+        uint32_t slot;
+        if (freeHead != NONE) {
+            slot = freeHead;
+            freeHead = slots[slot].position;
+            if (freeHead == NONE) freeTail = NONE;
+        } else {
+            if (slots.size() > INDEX_MASK) {
+                throw std::length_error("SlotMap: more live items than handles can index");
+            }
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({ 0, 1 });
+        }
+        slots[slot].position = static_cast<uint32_t>(items.size());
+        items.push_back(std::move(value));
+        slotOfItem.push_back(slot);
+        return makeHandle(slot, slots[slot].generation);
+    }
+
+    // Remove the item a handle names; false if the handle is stale
+    bool erase(int handle) {
+        uint32_t slot;
+        if (!resolve(handle, slot)) return false;
+        uint32_t position = slots[slot].position;
+        uint32_t last = static_cast<uint32_t>(items.size()) - 1;
+        if (position != last) {
+            items[position] = std::move(items[last]);
+            slotOfItem[position] = slotOfItem[last];
+            slots[slotOfItem[position]].position = position;
+        }
+        items.pop_back();
+        slotOfItem.pop_back();
+        // Generation 0 is never handed out, so wrap past it
+        slots[slot].generation = (slots[slot].generation + 1) & GENERATION_MASK;
+        if (slots[slot].generation == 0) slots[slot].generation = 1;
+        // Queue the slot behind the other free ones, so reuse (and with it
+        // generation wrap) is spread over every slot
+        slots[slot].position = NONE;
+        if (freeTail == NONE) {
+            freeHead = slot;
+        } else {
+            slots[freeTail].position = slot;
+        }
+        freeTail = slot;
+        return true;
+    }
+
+    bool contains(int handle) const {
+        uint32_t slot;
+        return resolve(handle, slot);
+    }
+
+    // Item a handle names; get requires a live handle, tryGet returns nullptr
+    T& get(int handle) { return items[slots[static_cast<uint32_t>(handle) & INDEX_MASK].position]; }
+    const T& get(int handle) const { return items[slots[static_cast<uint32_t>(handle) & INDEX_MASK].position]; }
+    T* tryGet(int handle) {
+        uint32_t slot;
+        return resolve(handle, slot) ? &items[slots[slot].position] : nullptr;
+    }
+    const T* tryGet(int handle) const {
+        uint32_t slot;
+        return resolve(handle, slot) ? &items[slots[slot].position] : nullptr;
+    }
+
+    // Dense storage, for iterating every item. Erasing reorders it.
+    std::vector<T>& getItems() { return items; }
+    const std::vector<T>& getItems() const { return items; }
+    size_t size() const { return items.size(); }
+
+private:
+    static constexpr uint32_t NONE = ~uint32_t(0);
+
+    struct Slot {
+        uint32_t position;   // Index into items while live, next free slot (or NONE) while free
+        uint32_t generation; // Bumped on every erase; never 0
+    };
+
+    static int makeHandle(uint32_t slot, uint32_t generation) {
+        return static_cast<int>((generation << INDEX_BITS) | slot);
+    }
+
+    bool resolve(int handle, uint32_t& outSlot) const {
+        if (handle <= 0) return false;
+        uint32_t slot = static_cast<uint32_t>(handle) & INDEX_MASK;
+        uint32_t generation = static_cast<uint32_t>(handle) >> INDEX_BITS;
+        if (slot >= slots.size() || slots[slot].generation != generation || generation == 0) return false;
+        outSlot = slot;
+        return slots[slot].position < items.size() && slotOfItem[slots[slot].position] == slot;
+    }
+
+    std::vector<T> items;
+    std::vector<uint32_t> slotOfItem; // Dense position -> slot
+    std::vector<Slot> slots;
+    uint32_t freeHead = NONE;
+    uint32_t freeTail = NONE;
+};
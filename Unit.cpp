@@ -1,40 +1,165 @@
 #include "Unit.h"
 #include "CellGrid.h"
+#include "PathPlanner.h"
+#include "AsyncPathService.h"
+#include "PathCache.h"
 #include "Pathfinding.h"
+#include "CooperativePlanner.h"
+#include <memory>
+#include <unordered_map>
 #include <random>
 #include <iostream>
 #include <SDL.h>
-#include <limits>
 #include "Buildings.h"
 
 
-// Global seed ID counter for all seed generation
-// Note: This is safe for single-threaded SDL game. Overflow is not a practical concern
-// as it would require billions of seeds to be generated in a single game session.
-static int g_nextSeedId = 1;
+// Main-thread path searches still in progress, one per unit (only used when
+// there are no path worker threads). Each holds full-grid search state, so
+// units hand theirs back when they are removed.
+static std::unordered_map<int, std::unique_ptr<PathSearchContext>> g_unitSearchContexts;
 
+// Node expansions a unit's search may claim from the tick budget per call
+const int UNIT_SEARCH_SLICE = 500;
+// Wander hops are at most 5 tiles; this covers any detour worth taking
+const int WANDER_SEARCH_BUDGET = 150;
+// The game loop sleeps about this long per tick; converts moveDelay to ticks
+const unsigned int MS_PER_TICK = 16;
 
-static int findClosestFoodIndex(const Unit& unit, const std::vector<Food>& foods, const CellGrid& cellGrid, int& outFoodGridX, int& outFoodGridY) {
-    int unitGridX, unitGridY;
-    cellGrid.pixelToGrid(unit.x, unit.y, unitGridX, unitGridY);
-    int minDist = std::numeric_limits<int>::max();
-    int closestIdx = -1;
-    for (size_t i = 0; i < foods.size(); ++i) {
-        // Only consider food that is not carried and not owned by any house
-        if (foods[i].carriedByUnitId != -1 || foods[i].ownedByHouseId != -1) {
-            continue;
-        }
-        int fx, fy;
-        cellGrid.pixelToGrid(foods[i].x, foods[i].y, fx, fy);
-        int dist = abs(fx - unitGridX) + abs(fy - unitGridY);
-        if (dist < minDist) {
-            minDist = dist;
-            closestIdx = static_cast<int>(i);
-            outFoodGridX = fx;
-            outFoodGridY = fy;
-        }
+
+void releaseUnitPathSearch(int unitId) {
+	g_unitSearchContexts.erase(unitId);
+}
+
+PathRequestStatus Unit::requestPath(int startX, int startY, int goalX, int goalY, const CellGrid& cellGrid) {
+	// Walled off from the goal: no point asking anyone to search
+	if (!cellGrid.canReach(startX, startY, goalX, goalY)) {
+		return PathRequestStatus::Unreachable;
+	}
+
+	if (pathTicket != 0 && g_AsyncPathService) {
+		if (pathTicketGoalX == goalX && pathTicketGoalY == goalY) {
+			std::vector<std::pair<int, int>> result;
+			uint64_t searchedVersion = 0;
+			PathPollStatus status = g_AsyncPathService->poll(pathTicket, result, &searchedVersion);
+			if (status == PathPollStatus::Pending) {
+				return PathRequestStatus::Pending;
+			}
+			pathTicket = 0;
+			// Unknown means the result expired while the unit was busy
+			// elsewhere. A result searched on a grid that has changed since
+			// may cross cells blocked in the meantime. Either way, ask again
+			// below instead
+			if (status == PathPollStatus::Ready && searchedVersion == cellGrid.getWalkabilityVersion()) {
+				if (result.empty()) {
+					return PathRequestStatus::Unreachable;
+				}
+				// Only usable if it still starts where the unit is now
+				if (result.front().first == startX && result.front().second == startY) {
+					path = UnitPath(result);
+					return PathRequestStatus::Found;
+				}
+			}
+		} else {
+			// Heading somewhere else now
+			g_AsyncPathService->cancel(pathTicket);
+			pathTicket = 0;
+		}
+	}
+
+	UnitPath cached;
+	if (lookupPlannedPath(startX, startY, goalX, goalY, cached)) {
+		path = std::move(cached);
+		return path.empty() ? PathRequestStatus::Unreachable : PathRequestStatus::Found;
+	}
+
+	if (g_AsyncPathService) {
+		pathTicket = g_AsyncPathService->submit(startX, startY, goalX, goalY, cellGrid);
+		pathTicketGoalX = goalX;
+		pathTicketGoalY = goalY;
+		return PathRequestStatus::Pending;
+	}
+
+	// No worker threads: search on the main thread a slice at a time, out of
+	// the tick's shared expansion budget. Partial paths get the unit moving
+	// toward the goal while the search carries on.
+	auto& search = g_unitSearchContexts[id];
+	if (!search) {
+		search = std::make_unique<PathSearchContext>();
+	}
+	if (!search->isSearchActive() || search->getSearchGoalX() != goalX || search->getSearchGoalY() != goalY) {
+		search->beginSearch(startX, startY, goalX, goalY, cellGrid);
+	}
+
+	int granted = claimTickExpansions(UNIT_SEARCH_SLICE);
+	if (granted == 0) {
+		return PathRequestStatus::Pending;
+	}
+	std::vector<std::pair<int, int>> result;
+	PathSearchStatus status = search->continueSearch(granted, result, startX, startY);
+	refundTickExpansions(granted - search->getLastExpandedCount());
+
+	if (status == PathSearchStatus::Unreachable) {
+		if (g_PathCache) g_PathCache->store(startX, startY, goalX, goalY, result);
+		return PathRequestStatus::Unreachable;
+	}
+	if (status == PathSearchStatus::BudgetExhausted) {
+		return PathRequestStatus::Pending;
+	}
+	if (result.front().first != startX || result.front().second != startY) {
+		// The unit left the search tree (e.g. a manual path); start over from here
+		search->beginSearch(startX, startY, goalX, goalY, cellGrid);
+		return PathRequestStatus::Pending;
+	}
+	path = UnitPath(result);
+	if (status == PathSearchStatus::Partial) {
+		return PathRequestStatus::Pending;
+	}
+	if (g_PathCache) g_PathCache->store(startX, startY, goalX, goalY, result);
+	return PathRequestStatus::Found;
+}
+
+// Nearest item accepted by isCandidate, by walking distance from (gridX, gridY).
+// One outward search over every candidate at once, so an item behind a wall
+// never wins just for being close in a straight line. Returns the item's index
+// and the path to it, or -1 if none is reachable within maxSteps (-1 = any).
+template <typename Item, typename Filter>
+static int findNearestReachableItem(int gridX, int gridY, const std::vector<Item>& items, const CellGrid& cellGrid,
+                                    Filter isCandidate, int maxSteps, std::vector<std::pair<int, int>>& outPath) {
+    std::vector<std::pair<int, int>> targets;
+    std::vector<int> targetItems;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!isCandidate(items[i])) continue;
+        int ix, iy;
+        cellGrid.pixelToGrid(items[i].x, items[i].y, ix, iy);
+        targets.emplace_back(ix, iy);
+        targetItems.push_back(static_cast<int>(i));
+    }
+    if (targets.empty()) {
+        outPath.clear();
+        return -1;
     }
-    return closestIdx;
+    int reached = nearestTargetFindPath(gridX, gridY, targets, cellGrid, outPath, maxSteps);
+    return reached == -1 ? -1 : targetItems[reached];
+}
+
+// Food that is not carried and not owned by any house
+static bool isFreeFood(const Food& food) {
+    return food.carriedByUnitId == -1 && food.ownedByHouseId == -1;
+}
+
+House* Unit::house() {
+	int index = houseIndex();
+	return (g_HouseManager && index != -1) ? &g_HouseManager->houses[index] : nullptr;
+}
+
+Farm* Unit::farm() {
+	int index = farmIndex();
+	return (g_FarmManager && index != -1) ? &g_FarmManager->farms[index] : nullptr;
+}
+
+Market* Unit::stallMarket() {
+	int index = stallMarketIndex();
+	return (g_MarketManager && index != -1) ? &g_MarketManager->markets[index] : nullptr;
 }
 
 
@@ -57,9 +182,22 @@ void Unit::addAction(const Action& action) {
     }
 }
 
-void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vector<Seed>& seeds, std::vector<Coin>& coins) {
+void Unit::processAction(CellGrid& cellGrid, FoodManager& foodManager, SeedManager& seedManager, CoinManager& coinManager) {
+    // Lookups by id go through the managers; the vectors are only scanned
+    // when searching for the nearest reachable item
+    const std::vector<Food>& foods = foodManager.getFood();
+    const std::vector<Seed>& seeds = seedManager.getSeeds();
+    const std::vector<Coin>& coins = coinManager.getCoins();
 
-    // First, handle any path movement (works with or without actions)
+    // Reserve the next few steps and sidestep other units' reservations
+    if (g_CooperativePlanner) {
+        int gridX, gridY;
+        cellGrid.pixelToGrid(x(), y(), gridX, gridY);
+        int ticksPerStep = static_cast<int>((moveDelay + MS_PER_TICK - 1) / MS_PER_TICK);
+        g_CooperativePlanner->update(id, gridX, gridY, ticksPerStep, path);
+    }
+
+    // Then handle any path movement (works with or without actions)
     // This allows manually-assigned paths (e.g., via P+click) to be followed
     if (!path.empty()) {
         unsigned int currentTime = SDL_GetTicks();
@@ -68,39 +206,34 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
             auto [nextGridX, nextGridY] = path.front();
             int nextPixelX, nextPixelY;
             cellGrid.gridToPixel(nextGridX, nextGridY, nextPixelX, nextPixelY);
-            x = nextPixelX;
-            y = nextPixelY;
-            path.erase(path.begin());
+            cellGrid.moveOccupantAtPixel(CellOccupant::Unit, id, x(), y(), nextPixelX, nextPixelY);
+            x() = nextPixelX;
+            y() = nextPixelY;
+            path.popFront();
             lastMoveTime = currentTime;
             
             // Update carried item positions immediately after moving
-            if (carriedFoodId != -1) {
-                auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-                    return food.foodId == carriedFoodId;
-                });
-                if (it != foods.end()) {
-                    it->x = x;
-                    it->y = y;
+            if (carriedFoodId() != -1) {
+                Food* food = foodManager.tryGet(carriedFoodId());
+                if (food) {
+                    food->x = x();
+                    food->y = y();
                 }
             }
             
-            if (carriedSeedId != -1) {
-                auto it = std::find_if(seeds.begin(), seeds.end(), [&](const Seed& seed) {
-                    return seed.seedId == carriedSeedId;
-                });
-                if (it != seeds.end()) {
-                    it->x = x;
-                    it->y = y;
+            if (carriedSeedId() != -1) {
+                Seed* seed = seedManager.tryGet(carriedSeedId());
+                if (seed) {
+                    seed->x = x();
+                    seed->y = y();
                 }
             }
             
-            if (carriedCoinId != -1) {
-                auto it = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-                    return coin.coinId == carriedCoinId;
-                });
-                if (it != coins.end()) {
-                    it->x = x;
-                    it->y = y;
+            if (carriedCoinId() != -1) {
+                Coin* coin = coinManager.tryGet(carriedCoinId());
+                if (coin) {
+                    coin->x = x();
+                    coin->y = y();
                 }
             }
         }
@@ -115,7 +248,7 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
         // If no path, pick a random walkable cell nearby and path to it
         if (path.empty()) {
             int gridX, gridY;
-            cellGrid.pixelToGrid(x, y, gridX, gridY);
+            cellGrid.pixelToGrid(x(), y(), gridX, gridY);
 
             // Try up to 10 times to find a random walkable cell nearby
             std::random_device rd;
@@ -128,9 +261,14 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
                 int nx = gridX + dx;
                 int ny = gridY + dy;
                 if ((dx != 0 || dy != 0) && cellGrid.isCellWalkable(nx, ny)) {
-                    auto newPath = aStarFindPath(gridX, gridY, nx, ny, cellGrid);
-                    if (!newPath.empty()) {
-                        path = newPath;
+                    // Budgeted so an enclosed target can't flood the map; a
+                    // partial path toward it is good enough for wandering
+                    std::vector<std::pair<int, int>> newPath;
+                    int granted = claimTickExpansions(WANDER_SEARCH_BUDGET);
+                    PathSearchStatus status = budgetedFindPath(gridX, gridY, nx, ny, cellGrid, granted, newPath);
+                    refundTickExpansions(granted - getThreadPathSearchContext().getLastExpandedCount());
+                    if ((status == PathSearchStatus::Found || status == PathSearchStatus::Partial) && !newPath.empty()) {
+                        path = UnitPath(newPath);
                         break;
                     }
                 }
@@ -147,16 +285,15 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::Eat: {
 		// Check if at house location to eat from stored food
 		int gridX, gridY;
-		cellGrid.pixelToGrid(x, y, gridX, gridY);
+		cellGrid.pixelToGrid(x(), y(), gridX, gridY);
 
 		// Find food at this location (only free food, not carried or owned)
-		auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-			int fx, fy;
-			cellGrid.pixelToGrid(food.x, food.y, fx, fy);
-			return fx == gridX && fy == gridY && food.carriedByUnitId == -1 && food.ownedByHouseId == -1;
-			});
+		int foodId = cellGrid.findNearest(CellOccupant::Food, gridX, gridY, 0, [&](int candidateId, int, int) {
+			const Food* food = foodManager.tryGet(candidateId);
+			return food && isFreeFood(*food);
+		});
 
-		if (it != foods.end()) {
+		if (foodId != -1) {
 			// Drop seeds before eating the food
 			std::random_device rd;
 			std::mt19937 gen(rd());
@@ -168,36 +305,29 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			
 			for (int i = 0; i < numSeeds; ++i) {
 				// Create new seed at food location
-				Seed newSeed(pixelX, pixelY, "seed", g_nextSeedId++);
+				Seed& newSeed = seedManager.addSeed(pixelX, pixelY, "seed");
 				
 				// Check if this location is in the unit's home
-				if (g_HouseManager) {
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == id &&
-							gridX >= house.gridX && gridX < house.gridX + 3 &&
-							gridY >= house.gridY && gridY < house.gridY + 3) {
-							// Seed dropped in home, owned by homeowner
-							newSeed.ownedByHouseId = id;
-							break;
-						}
-					}
+				BuildingSlot building = cellGrid.getBuildingAt(gridX, gridY);
+				if (g_HouseManager && building.is(BuildingKind::House) &&
+					g_HouseManager->houses[building.index].ownerUnitId == id) {
+					// Seed dropped in home, owned by homeowner
+					seedManager.setOwnedBy(newSeed, id);
 				}
 				
-				seeds.push_back(newSeed);
+				cellGrid.addOccupantAtPixel(CellOccupant::Seed, newSeed.seedId, pixelX, pixelY);
 				std::cout << "Dropped seed " << newSeed.seedId << " at (" << gridX << ", " << gridY << ")\n";
 			}
 			
 			// Eat the food
-			hunger = 100;
-			foods.erase(it);
+			hunger() = 100;
+			cellGrid.removeOccupantAtPixel(CellOccupant::Food, foodId, pixelX, pixelY);
+			foodManager.removeFood(foodId);
 			std::cout << "Unit " << name << " (id " << id << ") ate food at (" << gridX << ", " << gridY << ")\n";
 			actionQueue.pop();
 		} else if (path.empty()) {
 			// Not at house and no path - need to path to house
-			auto newPath = aStarFindPath(gridX, gridY, houseGridX, houseGridY, cellGrid);
-			if (!newPath.empty()) {
-				path = newPath;
-			} else {
+			if (requestPath(gridX, gridY, houseGridX(), houseGridY(), cellGrid) == PathRequestStatus::Unreachable) {
 				// Can't reach house, give up
 				actionQueue.pop();
 			}
@@ -207,20 +337,26 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	}
 	case ActionType::BuildHouse: {
 		int gridX, gridY;
-		cellGrid.pixelToGrid(x, y, gridX, gridY);
-		if (gridX != houseGridX || gridY != houseGridY) {
+		cellGrid.pixelToGrid(x(), y(), gridX, gridY);
+		if (gridX != houseGridX() || gridY != houseGridY()) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(gridX, gridY, houseGridX, houseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(gridX, gridY, houseGridX(), houseGridY(), cellGrid);
 			}
 			// Wait for movement to finish
 			break;
 		}
+		// Already built (spawning queues BuildHouse more than once)
+		if (house()) {
+			actionQueue.pop();
+			break;
+		}
 		// Build house: add to HouseManager without marking cells as non-walkable
 		if (g_HouseManager) {
-			g_HouseManager->addHouse(House(id, houseGridX, houseGridY));
+			g_HouseManager->addHouse(House(id, houseGridX(), houseGridY()));
+			houseIndex() = static_cast<int>(g_HouseManager->houses.size()) - 1;
+			cellGrid.addBuildingFootprint(BuildingKind::House, houseIndex(), houseGridX(), houseGridY());
 		}
-		std::cout << "Unit " << name << " built a house at (" << houseGridX << ", " << houseGridY << ")\n";
+		std::cout << "Unit " << name << " built a house at (" << houseGridX() << ", " << houseGridY() << ")\n";
 		actionQueue.pop();
 		break;
 	}
@@ -228,92 +364,74 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
     // Only support "food" for now, but extensible
     if (current.itemType == "food") {
         // 1. If not carrying food, path to closest food
-        if (carriedFoodId == -1) {
+        if (carriedFoodId() == -1) {
             // Not carrying food
-            int foodGridX = -1, foodGridY = -1;
-            int closestIdx = findClosestFoodIndex(*this, foods, cellGrid, foodGridX, foodGridY);
+            if (!path.empty()) {
+                // Still walking to the food
+                break;
+            }
+            int unitGridX, unitGridY;
+            cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+            std::vector<std::pair<int, int>> foodPath;
+            int closestIdx = findNearestReachableItem(unitGridX, unitGridY, foods, cellGrid, isFreeFood, -1, foodPath);
             if (closestIdx == -1) {
-                // No food found, give up
+                // No reachable food, give up
                 actionQueue.pop();
                 break;
             }
-            int unitGridX, unitGridY;
-            cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
             // If not at food, path to it
-            if (unitGridX != foodGridX || unitGridY != foodGridY) {
-                if (path.empty()) {
-                    auto newPath = aStarFindPath(unitGridX, unitGridY, foodGridX, foodGridY, cellGrid);
-                    if (!newPath.empty()) path = newPath;
-                }
+            if (foodPath.size() > 1) {
+                path = UnitPath(foodPath);
                 break;
             }
             // At food, pick it up (don't delete, just mark as carried)
-            auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-                int fx, fy;
-                cellGrid.pixelToGrid(food.x, food.y, fx, fy);
-                return fx == foodGridX && fy == foodGridY && food.carriedByUnitId == -1;
-            });
-            if (it != foods.end()) {
-                carriedFoodId = it->foodId;
-                it->carriedByUnitId = id;
-                it->x = x;  // Synchronize carried item to unit position
-                it->y = y;
-                inventory.push_back("food"); // Keep for backward compatibility
-                std::cout << "Unit " << name << " picked up food (id " << it->foodId << ") to bring home.\n";
-            } else {
-                // Food was taken by someone else
-                actionQueue.pop();
-            }
+            Food& food = foodManager.get(foods[closestIdx].foodId);
+            cellGrid.removeOccupantAtPixel(CellOccupant::Food, food.foodId, food.x, food.y);
+            carriedFoodId() = food.foodId;
+            foodManager.setCarriedBy(food, id);
+            food.x = x();  // Synchronize carried item to unit position
+            food.y = y();
+            inventory.push_back("food"); // Keep for backward compatibility
+            std::cout << "Unit " << name << " picked up food (id " << food.foodId << ") to bring home.\n";
             break;
         }
 
         // 2. If carrying food, path to house
         int unitGridX, unitGridY;
-        cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-        if (unitGridX != houseGridX || unitGridY != houseGridY) {
+        cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+        if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
             if (path.empty()) {
-                auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-                if (!newPath.empty()) path = newPath;
+                requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
             }
             break;
         }
 
         // 3. At house, deposit food if house has space
-        House* myHouse = nullptr;
-        if (g_HouseManager) {
-            for (auto& house : g_HouseManager->houses) {
-                if (house.ownerUnitId == id &&
-                    house.gridX == houseGridX && house.gridY == houseGridY) {
-                    myHouse = &house;
-                    break;
-                }
-            }
-        }
-        if (myHouse && myHouse->hasSpace() && carriedFoodId != -1) {
+        House* myHouse = house();
+        if (myHouse && myHouse->hasSpace() && carriedFoodId() != -1) {
             // Find the food object and mark it as owned by house
-            auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-                return food.foodId == carriedFoodId;
-            });
-            if (it != foods.end()) {
-                if (myHouse->addFood(carriedFoodId)) {
-                    it->carriedByUnitId = -1;
-                    it->ownedByHouseId = myHouse->ownerUnitId; // Mark as owned by house owner
+            Food* food = foodManager.tryGet(carriedFoodId());
+            if (food) {
+                if (myHouse->addFood(carriedFoodId())) {
+                    foodManager.setCarriedBy(*food, -1);
+                    foodManager.setOwnedBy(*food, myHouse->ownerUnitId); // Mark as owned by house owner
                     // Position food in house storage (find which slot it was placed in)
                     bool positioned = false;
                     for (int dx = 0; dx < 3 && !positioned; ++dx) {
                         for (int dy = 0; dy < 3 && !positioned; ++dy) {
-                            if (myHouse->foodIds[dx][dy] == carriedFoodId) {
-                                cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, it->x, it->y);
+                            if (myHouse->foodIds[dx][dy] == carriedFoodId()) {
+                                cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, food->x, food->y);
                                 positioned = true;
                             }
                         }
                     }
-                    carriedFoodId = -1;
+                    cellGrid.addOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
+                    carriedFoodId() = -1;
                     auto invIt = std::find(inventory.begin(), inventory.end(), "food");
                     if (invIt != inventory.end()) {
                         inventory.erase(invIt);
                     }
-                    std::cout << "Unit " << name << " delivered food (id " << it->foodId << ") to house storage.\n";
+                    std::cout << "Unit " << name << " delivered food (id " << food->foodId << ") to house storage.\n";
                 }
             }
         } else {
@@ -329,37 +447,25 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::EatFromHouse: {
 		// Navigate to house and eat food from storage
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 
 		// First, navigate to house if not there
-		if (unitGridX != houseGridX || unitGridY != houseGridY) {
+		if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 			}
 			break;
 		}
 
 		// At house, try to eat food from storage
-		House* myHouse = nullptr;
-		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.ownerUnitId == id &&
-					house.gridX == houseGridX && house.gridY == houseGridY) {
-					myHouse = &house;
-					break;
-				}
-			}
-		}
+		House* myHouse = house();
 
 		if (myHouse && myHouse->hasFood()) {
 			int foodId = myHouse->getFirstFoodId();
 			if (foodId != -1) {
 				// Find and remove the food from world
-				auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-					return food.foodId == foodId;
-				});
-				if (it != foods.end()) {
+				Food* food = foodManager.tryGet(foodId);
+				if (food) {
 					// Drop seeds before eating the food
 					std::random_device rd;
 					std::mt19937 gen(rd());
@@ -371,18 +477,19 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 					
 					for (int i = 0; i < numSeeds; ++i) {
 						// Create new seed at eating location (in home)
-						Seed newSeed(pixelX, pixelY, "seed", g_nextSeedId++);
+						Seed& newSeed = seedManager.addSeed(pixelX, pixelY, "seed");
 						
 						// Seed dropped in home, owned by homeowner
-						newSeed.ownedByHouseId = id;
+						seedManager.setOwnedBy(newSeed, id);
 						
-						seeds.push_back(newSeed);
+						cellGrid.addOccupantAtPixel(CellOccupant::Seed, newSeed.seedId, pixelX, pixelY);
 						std::cout << "Dropped seed " << newSeed.seedId << " in house at (" << unitGridX << ", " << unitGridY << ")\n";
 					}
 					
-					hunger = 100;
+					hunger() = 100;
 					myHouse->removeFoodById(foodId);
-					foods.erase(it); // Now we actually delete the food when eaten
+					cellGrid.removeOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
+					foodManager.removeFood(food->foodId); // Now we actually delete the food when eaten
 					std::cout << "Unit " << name << " (id " << id << ") ate food (id " << foodId << ") from house storage\n";
 				}
 			}
@@ -395,122 +502,78 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::CollectSeed: {
 		// Similar to BringItemToHouse but for seeds
 		// 1. If not carrying seed, path to closest seed
-		if (carriedSeedId == -1) {
+		if (carriedSeedId() == -1) {
 			// Not carrying seed - find closest unowned or my-owned seed
+			if (!path.empty()) {
+				// Still walking to the seed
+				break;
+			}
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			
-			int minDist = std::numeric_limits<int>::max();
-			int closestIdx = -1;
-			int seedGridX = -1, seedGridY = -1;
-			
-			for (size_t i = 0; i < seeds.size(); ++i) {
-				// Only consider seeds that are not carried, and either unowned or owned by me
-				if (seeds[i].carriedByUnitId != -1) continue;
-				if (seeds[i].ownedByHouseId != -1 && seeds[i].ownedByHouseId != id) continue;
-				
-				// Skip seeds that are planted in any farm
-				bool isPlantedInFarm = false;
-				if (g_FarmManager) {
-					for (const auto& farm : g_FarmManager->farms) {
-						for (int dx = 0; dx < 3; ++dx) {
-							for (int dy = 0; dy < 3; ++dy) {
-								if (farm.plantIds[dx][dy] == seeds[i].seedId) {
-									isPlantedInFarm = true;
-									break;
-								}
-							}
-							if (isPlantedInFarm) break;
-						}
-						if (isPlantedInFarm) break;
-					}
-				}
-				if (isPlantedInFarm) continue;
-				
-				int sx, sy;
-				cellGrid.pixelToGrid(seeds[i].x, seeds[i].y, sx, sy);
-				int dist = abs(sx - unitGridX) + abs(sy - unitGridY);
-				if (dist < minDist) {
-					minDist = dist;
-					closestIdx = static_cast<int>(i);
-					seedGridX = sx;
-					seedGridY = sy;
-				}
-			}
+			auto isCollectable = [this](const Seed& seed) {
+				// Not carried, not planted, and either unowned or owned by me
+				return SeedManager::isCollectableBy(seed, id);
+			};
+			std::vector<std::pair<int, int>> seedPath;
+			int closestIdx = findNearestReachableItem(unitGridX, unitGridY, seeds, cellGrid, isCollectable, -1, seedPath);
 			
 			if (closestIdx == -1) {
-				// No seed found, give up
+				// No reachable seed, give up
 				actionQueue.pop();
 				break;
 			}
 			
 			// If not at seed, path to it
-			if (unitGridX != seedGridX || unitGridY != seedGridY) {
-				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, seedGridX, seedGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
-				}
+			if (seedPath.size() > 1) {
+				path = UnitPath(seedPath);
 				break;
 			}
 			
 			// At seed, pick it up
-			if (closestIdx >= 0 && closestIdx < static_cast<int>(seeds.size())) {
-				carriedSeedId = seeds[closestIdx].seedId;
-				seeds[closestIdx].carriedByUnitId = id;
-				seeds[closestIdx].x = x;  // Synchronize carried item to unit position
-				seeds[closestIdx].y = y;
-				std::cout << "Unit " << name << " picked up seed (id " << seeds[closestIdx].seedId << ") to bring home.\n";
-			} else {
-				// Seed was taken by someone else
-				actionQueue.pop();
-			}
+			Seed& seed = seedManager.get(seeds[closestIdx].seedId);
+			carriedSeedId() = seed.seedId;
+			cellGrid.removeOccupantAtPixel(CellOccupant::Seed, carriedSeedId(), seed.x, seed.y);
+			seedManager.setCarriedBy(seed, id);
+			seed.x = x();  // Synchronize carried item to unit position
+			seed.y = y();
+			std::cout << "Unit " << name << " picked up seed (id " << seed.seedId << ") to bring home.\n";
 			break;
 		}
 		
 		// 2. If carrying seed, path to house
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-		if (unitGridX != houseGridX || unitGridY != houseGridY) {
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+		if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 			}
 			break;
 		}
 		
 		// 3. At house, deposit seed if house has space
-		House* myHouse = nullptr;
-		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.ownerUnitId == id &&
-					house.gridX == houseGridX && house.gridY == houseGridY) {
-					myHouse = &house;
-					break;
-				}
-			}
-		}
+		House* myHouse = house();
 		
-		if (myHouse && myHouse->hasSpace() && carriedSeedId != -1) {
+		if (myHouse && myHouse->hasSpace() && carriedSeedId() != -1) {
 			// Find the seed object and mark it as owned by house
-			auto it = std::find_if(seeds.begin(), seeds.end(), [&](const Seed& seed) {
-				return seed.seedId == carriedSeedId;
-			});
-			if (it != seeds.end()) {
-				if (myHouse->addSeed(carriedSeedId)) {
-					it->carriedByUnitId = -1;
-					it->ownedByHouseId = myHouse->ownerUnitId;
+			Seed* seed = seedManager.tryGet(carriedSeedId());
+			if (seed) {
+				if (myHouse->addSeed(carriedSeedId())) {
+					seedManager.setCarriedBy(*seed, -1);
+					seedManager.setOwnedBy(*seed, myHouse->ownerUnitId);
 					// Position seed in house storage (find which slot it was placed in)
 					bool positioned = false;
 					for (int dx = 0; dx < 3 && !positioned; ++dx) {
 						for (int dy = 0; dy < 3 && !positioned; ++dy) {
-							if (myHouse->seedIds[dx][dy] == carriedSeedId) {
-								cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, it->x, it->y);
+							if (myHouse->seedIds[dx][dy] == carriedSeedId()) {
+								cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, seed->x, seed->y);
 								positioned = true;
 							}
 						}
 					}
-					carriedSeedId = -1;
-					std::cout << "Unit " << name << " delivered seed (id " << it->seedId << ") to house storage.\n";
+					cellGrid.addOccupantAtPixel(CellOccupant::Seed, seed->seedId, seed->x, seed->y);
+					carriedSeedId() = -1;
+					std::cout << "Unit " << name << " delivered seed (id " << seed->seedId << ") to house storage.\n";
 				}
 			}
 		} else {
@@ -522,138 +585,99 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::CollectCoin: {
 		// Similar to CollectSeed but for coins
 		// 1. If not carrying coin, path to closest free coin within 20 tiles
-		if (carriedCoinId == -1) {
+		if (carriedCoinId() == -1) {
 			// Not carrying coin - find closest free coin (not carried, not owned) within 20 tiles
+			if (!path.empty()) {
+				// Still walking to the coin
+				break;
+			}
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			
-			int minDist = std::numeric_limits<int>::max();
-			int closestIdx = -1;
-			int coinGridX = -1, coinGridY = -1;
-			
-			for (size_t i = 0; i < coins.size(); ++i) {
-				// Only consider coins that are not carried and not owned by any house
-				if (coins[i].carriedByUnitId != -1) continue;
-				if (coins[i].ownedByHouseId != -1) continue;
-				
-				int cx, cy;
-				cellGrid.pixelToGrid(coins[i].x, coins[i].y, cx, cy);
-				int dist = abs(cx - unitGridX) + abs(cy - unitGridY);
-				
-				// Only consider coins within 20 tiles
-				if (dist > 20) continue;
-				
-				if (dist < minDist) {
-					minDist = dist;
-					closestIdx = static_cast<int>(i);
-					coinGridX = cx;
-					coinGridY = cy;
-				}
-			}
+			// Only consider coins that are not carried and not owned by any house,
+			// and at most 20 steps away
+			auto isFreeCoin = [](const Coin& coin) {
+				return coin.carriedByUnitId == -1 && coin.ownedByHouseId == -1;
+			};
+			std::vector<std::pair<int, int>> coinPath;
+			int closestIdx = findNearestReachableItem(unitGridX, unitGridY, coins, cellGrid, isFreeCoin, 20, coinPath);
 			
 			if (closestIdx == -1) {
-				// No coin found within 20 tiles, give up
+				// No coin reachable within 20 tiles, give up
 				actionQueue.pop();
 				break;
 			}
 			
 			// If not at coin, path to it
-			if (unitGridX != coinGridX || unitGridY != coinGridY) {
-				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, coinGridX, coinGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
-				}
+			if (coinPath.size() > 1) {
+				path = UnitPath(coinPath);
 				break;
 			}
 			
 			// At coin, pick it up
-			if (closestIdx >= 0 && closestIdx < static_cast<int>(coins.size())) {
-				carriedCoinId = coins[closestIdx].coinId;
-				coins[closestIdx].carriedByUnitId = id;
-				coins[closestIdx].x = x;  // Synchronize carried item to unit position
-				coins[closestIdx].y = y;
-				std::cout << "Unit " << name << " picked up coin (id " << coins[closestIdx].coinId << ") to bring home.\n";
-			} else {
-				// Coin was taken by someone else
-				actionQueue.pop();
-			}
+			Coin& coin = coinManager.get(coins[closestIdx].coinId);
+			carriedCoinId() = coin.coinId;
+			cellGrid.removeOccupantAtPixel(CellOccupant::Coin, carriedCoinId(), coin.x, coin.y);
+			coinManager.setCarriedBy(coin, id);
+			coin.x = x();  // Synchronize carried item to unit position
+			coin.y = y();
+			std::cout << "Unit " << name << " picked up coin (id " << coin.coinId << ") to bring home.\n";
 			break;
 		}
 		
 		// 2. If carrying coin, path to house
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-		if (unitGridX != houseGridX || unitGridY != houseGridY) {
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+		if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 			}
 			break;
 		}
 		
 		// 3. At house, deposit coin if house has space
-		House* myHouse = nullptr;
-		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.ownerUnitId == id &&
-					house.gridX == houseGridX && house.gridY == houseGridY) {
-					myHouse = &house;
-					break;
-				}
-			}
-		}
+		House* myHouse = house();
 		
-		if (myHouse && myHouse->hasSpace() && carriedCoinId != -1) {
+		if (myHouse && myHouse->hasSpace() && carriedCoinId() != -1) {
 			// Find the coin object and mark it as owned by house
-			auto it = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-				return coin.coinId == carriedCoinId;
-			});
-			if (it != coins.end()) {
-				if (myHouse->addCoin(carriedCoinId)) {
-					it->carriedByUnitId = -1;
-					it->ownedByHouseId = myHouse->ownerUnitId;
+			Coin* coin = coinManager.tryGet(carriedCoinId());
+			if (coin) {
+				if (myHouse->addCoin(carriedCoinId())) {
+					coinManager.setCarriedBy(*coin, -1);
+					coinManager.setOwnedBy(*coin, myHouse->ownerUnitId);
 					// Position coin in house storage (find which slot it was placed in)
 					bool positioned = false;
 					for (int dx = 0; dx < 3 && !positioned; ++dx) {
 						for (int dy = 0; dy < 3 && !positioned; ++dy) {
-							if (myHouse->coinIds[dx][dy] == carriedCoinId) {
-								cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, it->x, it->y);
+							if (myHouse->coinIds[dx][dy] == carriedCoinId()) {
+								cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, coin->x, coin->y);
 								positioned = true;
 							}
 						}
 					}
-					carriedCoinId = -1;
-					std::cout << "Unit " << name << " delivered coin (id " << it->coinId << ") to house storage.\n";
+					cellGrid.addOccupantAtPixel(CellOccupant::Coin, coin->coinId, coin->x, coin->y);
+					carriedCoinId() = -1;
+					std::cout << "Unit " << name << " delivered coin (id " << coin->coinId << ") to house storage.\n";
 				}
 			}
-		} else if (carriedCoinId != -1) {
+		} else if (carriedCoinId() != -1) {
 			// House full or missing - drop coin at current location
 			std::cout << "Unit " << name << " could not deliver coin: house full or missing. Dropping coin.\n";
-			auto it = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-				return coin.coinId == carriedCoinId;
-			});
-			if (it != coins.end()) {
-				it->carriedByUnitId = -1;
-				it->ownedByHouseId = -1; // Make it free for anyone
+			Coin* coin = coinManager.tryGet(carriedCoinId());
+			if (coin) {
+				coinManager.setCarriedBy(*coin, -1);
+				coinManager.setOwnedBy(*coin, -1); // Make it free for anyone
 				// Leave coin at current unit position
+				cellGrid.addOccupantAtPixel(CellOccupant::Coin, coin->coinId, coin->x, coin->y);
 			}
-			carriedCoinId = -1;
+			carriedCoinId() = -1;
 		}
 		actionQueue.pop();
 		break;
 	}
 	case ActionType::BuildFarm: {
 		// Build farm 1 tile away from house if at least 1 seed in house
-		House* myHouse = nullptr;
-		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.ownerUnitId == id &&
-					house.gridX == houseGridX && house.gridY == houseGridY) {
-					myHouse = &house;
-					break;
-				}
-			}
-		}
+		House* myHouse = house();
 		
 		// Check if house has at least 1 seed
 		if (!myHouse || !myHouse->hasSeed()) {
@@ -662,17 +686,7 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// Check if farm already exists for this unit
-		bool farmExists = false;
-		if (g_FarmManager) {
-			for (const auto& farm : g_FarmManager->farms) {
-				if (farm.ownerUnitId == id) {
-					farmExists = true;
-					break;
-				}
-			}
-		}
-		
-		if (farmExists) {
+		if (farm()) {
 			actionQueue.pop();
 			break;
 		}
@@ -680,25 +694,21 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// Find a suitable location exactly 1 space away from house
 		int farmGridX = -1, farmGridY = -1;
 		bool found = false;
+		int unitGridX, unitGridY;
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 		
 		// Try positions 1 space away from house (4 cardinal directions)
 		int offsets[4][2] = {{-4, 0}, {4, 0}, {0, -4}, {0, 4}};
 		
 		for (int i = 0; i < 4 && !found; ++i) {
-			int testX = houseGridX + offsets[i][0];
-			int testY = houseGridY + offsets[i][1];
+			int testX = houseGridX() + offsets[i][0];
+			int testY = houseGridY() + offsets[i][1];
 			
 			// Check if 3x3 area is walkable
-			bool areaWalkable = true;
-			for (int dx = 0; dx < 3 && areaWalkable; ++dx) {
-				for (int dy = 0; dy < 3 && areaWalkable; ++dy) {
-					if (!cellGrid.isCellWalkable(testX + dx, testY + dy)) {
-						areaWalkable = false;
-					}
-				}
-			}
+			bool areaWalkable = cellGrid.isAreaWalkable(testX, testY, 3, 3);
 			
-			if (areaWalkable) {
+			// Skip spots the unit could never walk to
+			if (areaWalkable && cellGrid.canReach(unitGridX, unitGridY, testX, testY)) {
 				farmGridX = testX;
 				farmGridY = testY;
 				found = true;
@@ -712,12 +722,9 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// Navigate to farm location
-		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
 		if (unitGridX != farmGridX || unitGridY != farmGridY) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
 			}
 			break;
 		}
@@ -725,6 +732,8 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// Build farm
 		if (g_FarmManager) {
 			g_FarmManager->addFarm(Farm(id, farmGridX, farmGridY));
+			farmIndex() = static_cast<int>(g_FarmManager->farms.size()) - 1;
+			cellGrid.addBuildingFootprint(BuildingKind::Farm, farmIndex(), farmGridX, farmGridY);
 			std::cout << "Unit " << name << " built a farm at (" << farmGridX << ", " << farmGridY << ")\n";
 		}
 		actionQueue.pop();
@@ -733,17 +742,8 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::PlantSeed: {
 		// Plant seed from house to farm
 		// 1. If not carrying seed, get seed from house
-		if (carriedSeedId == -1) {
-			House* myHouse = nullptr;
-			if (g_HouseManager) {
-				for (auto& house : g_HouseManager->houses) {
-					if (house.ownerUnitId == id &&
-						house.gridX == houseGridX && house.gridY == houseGridY) {
-						myHouse = &house;
-						break;
-					}
-				}
-			}
+		if (carriedSeedId() == -1) {
+			House* myHouse = house();
 			
 			if (!myHouse || !myHouse->hasSeed()) {
 				actionQueue.pop();
@@ -752,11 +752,10 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			
 			// Navigate to house
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-			if (unitGridX != houseGridX || unitGridY != houseGridY) {
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+			if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 				}
 				break;
 			}
@@ -765,15 +764,14 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			int seedId = myHouse->getFirstSeedId();
 			if (seedId != -1) {
 				myHouse->removeSeedById(seedId);
-				carriedSeedId = seedId;
+				carriedSeedId() = seedId;
 				// Mark seed as carried
-				auto it = std::find_if(seeds.begin(), seeds.end(), [&](const Seed& seed) {
-					return seed.seedId == seedId;
-				});
-				if (it != seeds.end()) {
-					it->carriedByUnitId = id;
-					it->x = x;  // Synchronize carried item to unit position
-					it->y = y;
+				Seed* seed = seedManager.tryGet(seedId);
+				if (seed) {
+					cellGrid.removeOccupantAtPixel(CellOccupant::Seed, seedId, seed->x, seed->y);
+					seedManager.setCarriedBy(*seed, id);
+					seed->x = x();  // Synchronize carried item to unit position
+					seed->y = y();
 					std::cout << "Unit " << name << " picked up seed (id " << seedId << ") from house to plant.\n";
 				}
 			}
@@ -781,17 +779,11 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// 2. If carrying seed, navigate to farm and plant it
-		Farm* myFarm = nullptr;
+		Farm* myFarm = farm();
 		int farmGridX = -1, farmGridY = -1;
-		if (g_FarmManager) {
-			for (auto& farm : g_FarmManager->farms) {
-				if (farm.ownerUnitId == id) {
-					myFarm = &farm;
-					farmGridX = farm.gridX;
-					farmGridY = farm.gridY;
-					break;
-				}
-			}
+		if (myFarm) {
+			farmGridX = myFarm->gridX;
+			farmGridY = myFarm->gridY;
 		}
 		
 		if (!myFarm) {
@@ -808,37 +800,36 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		
 		// Navigate to farm
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 		if (unitGridX != farmGridX || unitGridY != farmGridY) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
 			}
 			break;
 		}
 		
 		// Plant seed in farm
 		Uint32 currentTime = SDL_GetTicks();
-		if (myFarm->plantSeed(carriedSeedId, currentTime)) {
+		if (myFarm->plantSeed(carriedSeedId(), currentTime)) {
 			// Find the seed object and update its position
-			auto it = std::find_if(seeds.begin(), seeds.end(), [&](const Seed& seed) {
-				return seed.seedId == carriedSeedId;
-			});
-			if (it != seeds.end()) {
-				it->carriedByUnitId = -1;
+			Seed* seed = seedManager.tryGet(carriedSeedId());
+			if (seed) {
+				seedManager.setPlantedInFarm(*seed, farmIndex());
+				seedManager.setCarriedBy(*seed, -1);
 				// Position seed in farm (find which slot it was placed in)
 				bool positioned = false;
 				for (int dx = 0; dx < 3 && !positioned; ++dx) {
 					for (int dy = 0; dy < 3 && !positioned; ++dy) {
-						if (myFarm->plantIds[dx][dy] == carriedSeedId) {
-							cellGrid.gridToPixel(farmGridX + dx, farmGridY + dy, it->x, it->y);
+						if (myFarm->plantIds[dx][dy] == carriedSeedId()) {
+							cellGrid.gridToPixel(farmGridX + dx, farmGridY + dy, seed->x, seed->y);
 							positioned = true;
 						}
 					}
 				}
-				std::cout << "Unit " << name << " planted seed (id " << carriedSeedId << ") in farm.\n";
+				cellGrid.addOccupantAtPixel(CellOccupant::Seed, seed->seedId, seed->x, seed->y);
+				std::cout << "Unit " << name << " planted seed (id " << carriedSeedId() << ") in farm.\n";
 			}
-			carriedSeedId = -1;
+			carriedSeedId() = -1;
 		}
 		actionQueue.pop();
 		break;
@@ -846,18 +837,12 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::HarvestFood: {
 		// Harvest grown food from farm and bring to house
 		// 1. If not carrying food, get grown food from farm
-		if (carriedFoodId == -1) {
-			Farm* myFarm = nullptr;
+		if (carriedFoodId() == -1) {
+			Farm* myFarm = farm();
 			int farmGridX = -1, farmGridY = -1;
-			if (g_FarmManager) {
-				for (auto& farm : g_FarmManager->farms) {
-					if (farm.ownerUnitId == id) {
-						myFarm = &farm;
-						farmGridX = farm.gridX;
-						farmGridY = farm.gridY;
-						break;
-					}
-				}
+			if (myFarm) {
+				farmGridX = myFarm->gridX;
+				farmGridY = myFarm->gridY;
 			}
 			
 			if (!myFarm) {
@@ -874,31 +859,27 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			
 			// Navigate to farm
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			if (unitGridX != farmGridX || unitGridY != farmGridY) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, farmGridX, farmGridY, cellGrid);
 				}
 				break;
 			}
 			
 			// Pick up the grown food
 			// First, convert the seed to food object
-			auto seedIt = std::find_if(seeds.begin(), seeds.end(), [&](const Seed& seed) {
-				return seed.seedId == grownFoodId;
-			});
-			if (seedIt != seeds.end()) {
+			Seed* seed = seedManager.tryGet(grownFoodId);
+			if (seed) {
 				// Create food at unit location (being picked up immediately)
-				static int nextFoodId = 10000; // Start from high number to avoid conflicts
-				Food newFood(x, y, 'f', "farmfood", 100, nextFoodId++);
-				newFood.carriedByUnitId = id;
-				newFood.ownedByHouseId = id;
-				foods.push_back(newFood);
-				carriedFoodId = newFood.foodId;
+				Food& newFood = foodManager.addFood(x(), y(), "farmfood");
+				foodManager.setCarriedBy(newFood, id);
+				foodManager.setOwnedBy(newFood, id);
+				carriedFoodId() = newFood.foodId;
 				
 				// Remove seed from world
-				seeds.erase(seedIt);
+				cellGrid.removeOccupantAtPixel(CellOccupant::Seed, seed->seedId, seed->x, seed->y);
+				seedManager.removeSeed(seed->seedId);
 				
 				// Remove from farm
 				myFarm->removePlantById(grownFoodId);
@@ -910,47 +891,36 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		
 		// 2. If carrying food, bring to house
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-		if (unitGridX != houseGridX || unitGridY != houseGridY) {
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+		if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 			}
 			break;
 		}
 		
 		// At house, deposit food
-		House* myHouse = nullptr;
-		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.ownerUnitId == id &&
-					house.gridX == houseGridX && house.gridY == houseGridY) {
-					myHouse = &house;
-					break;
-				}
-			}
-		}
+		House* myHouse = house();
 		
-		if (myHouse && myHouse->hasSpace() && carriedFoodId != -1) {
-			auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-				return food.foodId == carriedFoodId;
-			});
-			if (it != foods.end()) {
-				if (myHouse->addFood(carriedFoodId)) {
-					it->carriedByUnitId = -1;
-					it->ownedByHouseId = myHouse->ownerUnitId;
+		if (myHouse && myHouse->hasSpace() && carriedFoodId() != -1) {
+			Food* food = foodManager.tryGet(carriedFoodId());
+			if (food) {
+				if (myHouse->addFood(carriedFoodId())) {
+					foodManager.setCarriedBy(*food, -1);
+					foodManager.setOwnedBy(*food, myHouse->ownerUnitId);
 					// Position food in house storage
 					bool positioned = false;
 					for (int dx = 0; dx < 3 && !positioned; ++dx) {
 						for (int dy = 0; dy < 3 && !positioned; ++dy) {
-							if (myHouse->foodIds[dx][dy] == carriedFoodId) {
-								cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, it->x, it->y);
+							if (myHouse->foodIds[dx][dy] == carriedFoodId()) {
+								cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, food->x, food->y);
 								positioned = true;
 							}
 						}
 					}
-					carriedFoodId = -1;
-					std::cout << "Unit " << name << " delivered harvested food (id " << it->foodId << ") to house.\n";
+					cellGrid.addOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
+					carriedFoodId() = -1;
+					std::cout << "Unit " << name << " delivered harvested food (id " << food->foodId << ") to house.\n";
 				}
 			}
 		}
@@ -961,24 +931,20 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// Steal food from the nearest house with food
 		// 1. Find the nearest house with food
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 		
-		int minDist = std::numeric_limits<int>::max();
 		House* targetHouse = nullptr;
 		int targetHouseGridX = -1, targetHouseGridY = -1;
 		
 		if (g_HouseManager) {
-			for (auto& house : g_HouseManager->houses) {
-				if (house.hasFood()) {
-					// Calculate distance to house
-					int dist = abs(house.gridX - unitGridX) + abs(house.gridY - unitGridY);
-					if (dist < minDist) {
-						minDist = dist;
-						targetHouse = &house;
-						targetHouseGridX = house.gridX;
-						targetHouseGridY = house.gridY;
-					}
-				}
+			// Search outward over house footprints; the first house with food found is the nearest
+			int houseIndex = cellGrid.findNearest(CellOccupant::House, unitGridX, unitGridY, -1, [&](int index, int, int) {
+				return g_HouseManager->houses[index].hasFood();
+			});
+			if (houseIndex != -1) {
+				targetHouse = &g_HouseManager->houses[houseIndex];
+				targetHouseGridX = targetHouse->gridX;
+				targetHouseGridY = targetHouse->gridY;
 			}
 		}
 		
@@ -991,8 +957,7 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// 2. Navigate to the target house if not there
 		if (unitGridX != targetHouseGridX || unitGridY != targetHouseGridY) {
 			if (path.empty()) {
-				auto newPath = aStarFindPath(unitGridX, unitGridY, targetHouseGridX, targetHouseGridY, cellGrid);
-				if (!newPath.empty()) path = newPath;
+				requestPath(unitGridX, unitGridY, targetHouseGridX, targetHouseGridY, cellGrid);
 			}
 			break;
 		}
@@ -1002,10 +967,8 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			int foodId = targetHouse->getFirstFoodId();
 			if (foodId != -1) {
 				// Find and remove the food from world
-				auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-					return food.foodId == foodId;
-				});
-				if (it != foods.end()) {
+				Food* food = foodManager.tryGet(foodId);
+				if (food) {
 					// Drop seeds before eating the food
 					std::random_device rd;
 					std::mt19937 gen(rd());
@@ -1018,22 +981,23 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 					// Seed drops are owned by the house owner (not the thief)
 					for (int i = 0; i < numSeeds; ++i) {
 						// Create new seed at eating location (in the victim's home)
-						Seed newSeed(pixelX, pixelY, "seed", g_nextSeedId++);
+						Seed& newSeed = seedManager.addSeed(pixelX, pixelY, "seed");
 						
 						// Seed dropped in home, owned by the home owner (victim)
-						newSeed.ownedByHouseId = targetHouse->ownerUnitId;
+						seedManager.setOwnedBy(newSeed, targetHouse->ownerUnitId);
 						
-						seeds.push_back(newSeed);
+						cellGrid.addOccupantAtPixel(CellOccupant::Seed, newSeed.seedId, pixelX, pixelY);
 						std::cout << "Dropped seed " << newSeed.seedId << " in house at (" << unitGridX << ", " << unitGridY << ") owned by unit " << targetHouse->ownerUnitId << "\n";
 					}
 					
 					// Eat the stolen food
-					hunger = 100;
+					hunger() = 100;
 					targetHouse->removeFoodById(foodId);
-					foods.erase(it);
+					cellGrid.removeOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
+					foodManager.removeFood(food->foodId);
 					
 					// Record who was stolen from
-					justStoleFromUnitId = targetHouse->ownerUnitId;
+					justStoleFromUnitId() = targetHouse->ownerUnitId;
 					
 					// Print the stealing message
 					std::cout << "Food stolen from home (" << targetHouseGridX << ", " << targetHouseGridY << ") by " << name << "\n";
@@ -1050,7 +1014,7 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// The actual fighting logic is in GameLoop.cpp
 		
 		// If stolenFromByUnitId is -1, the fight is over, so remove this action
-		if (stolenFromByUnitId == -1) {
+		if (stolenFromByUnitId() == -1) {
 			actionQueue.pop();
 		}
 		break;
@@ -1058,33 +1022,23 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::SellAtMarket: {
 		// Sell food at a market stall
 		// 1. If not carrying food, go to house and pick up food
-		if (carriedFoodId == -1) {
-			House* myHouse = nullptr;
-			if (g_HouseManager) {
-				for (auto& house : g_HouseManager->houses) {
-					if (house.ownerUnitId == id &&
-						house.gridX == houseGridX && house.gridY == houseGridY) {
-						myHouse = &house;
-						break;
-					}
-				}
-			}
+		if (carriedFoodId() == -1) {
+			House* myHouse = house();
 			
 			if (!myHouse || !myHouse->hasFood()) {
 				// No house or no food to sell
 				std::cout << "Unit " << name << " cancelling SellAtMarket - no house or no food available.\n";
-				isSelling = false;
+				leaveStall();
 				actionQueue.pop();
 				break;
 			}
 			
 			// Navigate to house
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-			if (unitGridX != houseGridX || unitGridY != houseGridY) {
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+			if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 				}
 				break;
 			}
@@ -1093,16 +1047,15 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			int foodId = myHouse->getFirstFoodId();
 			if (foodId != -1) {
 				myHouse->removeFoodById(foodId);
-				carriedFoodId = foodId;
+				carriedFoodId() = foodId;
 				// Mark food as carried
-				auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-					return food.foodId == foodId;
-				});
-				if (it != foods.end()) {
-					it->carriedByUnitId = id;
-					it->ownedByHouseId = -1; // No longer owned by house
-					it->x = x;
-					it->y = y;
+				Food* food = foodManager.tryGet(foodId);
+				if (food) {
+					cellGrid.removeOccupantAtPixel(CellOccupant::Food, foodId, food->x, food->y);
+					foodManager.setCarriedBy(*food, id);
+					foodManager.setOwnedBy(*food, -1); // No longer owned by house
+					food->x = x();
+					food->y = y();
 					std::cout << "Unit " << name << " picked up food (id " << foodId << ") to sell at market.\n";
 				}
 			}
@@ -1110,23 +1063,31 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// 2. If carrying food but not yet at a stall, find a market and navigate to empty stall
-		if (!isSelling || sellingStallX == -1 || sellingStallY == -1) {
+		if (!isSelling() || sellingStallX() == -1 || sellingStallY() == -1) {
 			Market* targetMarket = nullptr;
 			int stallX = -1, stallY = -1;
 			
 			if (g_MarketManager) {
-				for (auto& market : g_MarketManager->markets) {
-					if (market.findEmptyStall(stallX, stallY)) {
-						targetMarket = &market;
-						break;
-					}
+				// Search outward over market footprints for the nearest empty stall
+				int unitGridX, unitGridY;
+				cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+				int stallGridX, stallGridY;
+				int marketIndex = cellGrid.findNearest(CellOccupant::Market, unitGridX, unitGridY, -1, [&](int index, int gx, int gy) {
+					BuildingSlot stall = cellGrid.getBuildingAt(gx, gy);
+					return g_MarketManager->markets[index].stallFoodIds[stall.dx][stall.dy] == -1;
+				}, &stallGridX, &stallGridY);
+				if (marketIndex != -1) {
+					BuildingSlot stall = cellGrid.getBuildingAt(stallGridX, stallGridY);
+					targetMarket = &g_MarketManager->markets[marketIndex];
+					stallX = stall.dx;
+					stallY = stall.dy;
 				}
 			}
 			
 			if (!targetMarket) {
 				// No empty stall available, give up
 				std::cout << "Unit " << name << " couldn't find empty market stall.\n";
-				isSelling = false;
+				leaveStall();
 				actionQueue.pop();
 				break;
 			}
@@ -1135,37 +1096,36 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			int targetGridX = targetMarket->gridX + stallX;
 			int targetGridY = targetMarket->gridY + stallY;
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			
 			if (unitGridX != targetGridX || unitGridY != targetGridY) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, targetGridX, targetGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, targetGridX, targetGridY, cellGrid);
 				}
 				break;
 			}
 			
 			// Arrived at stall, set up shop
-			targetMarket->stallFoodIds[stallX][stallY] = carriedFoodId;
+			targetMarket->stallFoodIds[stallX][stallY] = carriedFoodId();
 			targetMarket->stallSellerIds[stallX][stallY] = id;
 			targetMarket->stallAbandonTimes[stallX][stallY] = 0; // Seller is present
-			isSelling = true;
-			sellingStallX = targetGridX;
-			sellingStallY = targetGridY;
+			isSelling() = true;
+			sellingStallX() = targetGridX;
+			sellingStallY() = targetGridY;
+			stallMarketIndex() = static_cast<int>(targetMarket - g_MarketManager->markets.data());
 			lastAtStallTime = SDL_GetTicks();
 			
 			// Update food position to stall
-			auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-				return food.foodId == carriedFoodId;
-			});
-			if (it != foods.end()) {
+			Food* food = foodManager.tryGet(carriedFoodId());
+			if (food) {
 				int px, py;
 				cellGrid.gridToPixel(targetGridX, targetGridY, px, py);
-				it->x = px;
-				it->y = py;
-				it->carriedByUnitId = -1; // Not carried anymore, it's at the stall
+				food->x = px;
+				food->y = py;
+				foodManager.setCarriedBy(*food, -1); // Not carried anymore, it's at the stall
+				cellGrid.addOccupantAtPixel(CellOccupant::Food, food->foodId, px, py);
 			}
-			carriedFoodId = -1; // Not carrying anymore
+			carriedFoodId() = -1; // Not carrying anymore
 			
 			std::cout << "Unit " << name << " is now selling at market stall (" << targetGridX << ", " << targetGridY << ").\n";
 			break;
@@ -1174,8 +1134,8 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		// 3. At stall, wait for buyer (this action stays active)
 		// Update last at stall time
 		int unitGridX, unitGridY;
-		cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-		if (unitGridX == sellingStallX && unitGridY == sellingStallY) {
+		cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+		if (unitGridX == sellingStallX() && unitGridY == sellingStallY()) {
 			lastAtStallTime = SDL_GetTicks();
 		}
 		// Don't pop the action, seller stays here until a higher priority action comes
@@ -1184,17 +1144,8 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::BuyAtMarket: {
 		// Buy food from a market stall
 		// 1. If not carrying coin, go to house and pick up coin
-		if (carriedCoinId == -1 && coinInventory.empty()) {
-			House* myHouse = nullptr;
-			if (g_HouseManager) {
-				for (auto& house : g_HouseManager->houses) {
-					if (house.ownerUnitId == id &&
-						house.gridX == houseGridX && house.gridY == houseGridY) {
-						myHouse = &house;
-						break;
-					}
-				}
-			}
+		if (carriedCoinId() == -1 && coinInventory.empty()) {
+			House* myHouse = house();
 			
 			if (!myHouse || !myHouse->hasCoin()) {
 				// No house or no coin to buy with
@@ -1204,11 +1155,10 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			
 			// Navigate to house
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-			if (unitGridX != houseGridX || unitGridY != houseGridY) {
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+			if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 				}
 				break;
 			}
@@ -1224,16 +1174,25 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// 2. If carrying coin, find a stall with a seller and navigate there
-		if (carriedFoodId == -1) {
+		if (carriedFoodId() == -1) {
 			Market* targetMarket = nullptr;
 			int stallX = -1, stallY = -1;
 			
 			if (g_MarketManager) {
-				for (auto& market : g_MarketManager->markets) {
-					if (market.findActiveSellerStall(stallX, stallY)) {
-						targetMarket = &market;
-						break;
-					}
+				// Search outward over market footprints for the nearest stall with a seller and food
+				int unitGridX, unitGridY;
+				cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+				int stallGridX, stallGridY;
+				int marketIndex = cellGrid.findNearest(CellOccupant::Market, unitGridX, unitGridY, -1, [&](int index, int gx, int gy) {
+					BuildingSlot stall = cellGrid.getBuildingAt(gx, gy);
+					const Market& market = g_MarketManager->markets[index];
+					return market.stallSellerIds[stall.dx][stall.dy] != -1 && market.stallFoodIds[stall.dx][stall.dy] != -1;
+				}, &stallGridX, &stallGridY);
+				if (marketIndex != -1) {
+					BuildingSlot stall = cellGrid.getBuildingAt(stallGridX, stallGridY);
+					targetMarket = &g_MarketManager->markets[marketIndex];
+					stallX = stall.dx;
+					stallY = stall.dy;
 				}
 			}
 			
@@ -1248,12 +1207,11 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			int targetGridX = targetMarket->gridX + stallX;
 			int targetGridY = targetMarket->gridY + stallY;
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			
 			if (unitGridX != targetGridX || unitGridY != targetGridY) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, targetGridX, targetGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, targetGridX, targetGridY, cellGrid);
 				}
 				break;
 			}
@@ -1276,14 +1234,13 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			// The coin's ownedByHouseId field is set below to trigger this mechanism
 			
 			// Pick up the food
-			auto foodIt = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-				return food.foodId == foodId;
-			});
-			if (foodIt != foods.end()) {
-				carriedFoodId = foodId;
-				foodIt->carriedByUnitId = id;
-				foodIt->x = x;
-				foodIt->y = y;
+			Food* food = foodManager.tryGet(foodId);
+			if (food) {
+				cellGrid.removeOccupantAtPixel(CellOccupant::Food, foodId, food->x, food->y);
+				carriedFoodId() = foodId;
+				foodManager.setCarriedBy(*food, id);
+				food->x = x();
+				food->y = y();
 			}
 			
 			// Clear the stall
@@ -1294,16 +1251,16 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			targetMarket->stallAbandonTimes[stallX][stallY] = 0;
 			
 			// Place coin at stall for GameLoop to handle
-			auto coinIt = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-				return coin.coinId == coinId;
-			});
-			if (coinIt != coins.end()) {
+			Coin* coin = coinManager.tryGet(coinId);
+			if (coin) {
 				int px, py;
 				cellGrid.gridToPixel(targetGridX, targetGridY, px, py);
-				coinIt->x = px;
-				coinIt->y = py;
-				coinIt->carriedByUnitId = -1;
-				coinIt->ownedByHouseId = sellerIdTemp; // Mark as owned by seller
+				// The coin sat in house storage while in the buyer's inventory
+				cellGrid.moveOccupantAtPixel(CellOccupant::Coin, coinId, coin->x, coin->y, px, py);
+				coin->x = px;
+				coin->y = py;
+				coinManager.setCarriedBy(*coin, -1);
+				coinManager.setOwnedBy(*coin, sellerIdTemp); // Mark as owned by seller
 			}
 			
 			std::cout << "Unit " << name << " (buyer) and seller (id " << sellerIdTemp << ") have made a deal.\n";
@@ -1314,12 +1271,12 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 		}
 		
 		// 3. If carrying food from purchase, consume or bring home
-		if (carriedFoodId != -1) {
+		if (carriedFoodId() != -1) {
 			// Check hunger level
-			if (hunger < 50) {
+			if (hunger() < 50) {
 				// Consume on the spot
 				int unitGridX, unitGridY;
-				cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+				cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 				
 				// Drop seeds before eating
 				std::random_device rd;
@@ -1331,63 +1288,50 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 				cellGrid.gridToPixel(unitGridX, unitGridY, pixelX, pixelY);
 				
 				for (int i = 0; i < numSeeds; ++i) {
-					Seed newSeed(pixelX, pixelY, "seed", g_nextSeedId++);
-					seeds.push_back(newSeed);
+					Seed& newSeed = seedManager.addSeed(pixelX, pixelY, "seed");
+					cellGrid.addOccupantAtPixel(CellOccupant::Seed, newSeed.seedId, pixelX, pixelY);
 				}
 				
 				// Eat the food
-				hunger = 100;
-				auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-					return food.foodId == carriedFoodId;
-				});
-				if (it != foods.end()) {
-					foods.erase(it);
+				hunger() = 100;
+				Food* food = foodManager.tryGet(carriedFoodId());
+				if (food) {
+					foodManager.removeFood(food->foodId);
 				}
-				carriedFoodId = -1;
+				carriedFoodId() = -1;
 				std::cout << "Unit " << name << " consumed purchased food on the spot.\n";
 				actionQueue.pop();
 			} else {
 				// Bring food to house
 				int unitGridX, unitGridY;
-				cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-				if (unitGridX != houseGridX || unitGridY != houseGridY) {
+				cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+				if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 					if (path.empty()) {
-						auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-						if (!newPath.empty()) path = newPath;
+						requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 					}
 					break;
 				}
 				
 				// At house, store the food
-				House* myHouse = nullptr;
-				if (g_HouseManager) {
-					for (auto& house : g_HouseManager->houses) {
-						if (house.ownerUnitId == id &&
-							house.gridX == houseGridX && house.gridY == houseGridY) {
-							myHouse = &house;
-							break;
-						}
-					}
-				}
+				House* myHouse = house();
 				
 				if (myHouse && myHouse->hasSpace()) {
-					auto it = std::find_if(foods.begin(), foods.end(), [&](const Food& food) {
-						return food.foodId == carriedFoodId;
-					});
-					if (it != foods.end()) {
-						if (myHouse->addFood(carriedFoodId)) {
-							it->carriedByUnitId = -1;
-							it->ownedByHouseId = id;
+					Food* food = foodManager.tryGet(carriedFoodId());
+					if (food) {
+						if (myHouse->addFood(carriedFoodId())) {
+							foodManager.setCarriedBy(*food, -1);
+							foodManager.setOwnedBy(*food, id);
 							// Position food in house
 							for (int dx = 0; dx < 3; ++dx) {
 								for (int dy = 0; dy < 3; ++dy) {
-									if (myHouse->foodIds[dx][dy] == carriedFoodId) {
-										cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, it->x, it->y);
+									if (myHouse->foodIds[dx][dy] == carriedFoodId()) {
+										cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, food->x, food->y);
 										break;
 									}
 								}
 							}
-							carriedFoodId = -1;
+							cellGrid.addOccupantAtPixel(CellOccupant::Food, food->foodId, food->x, food->y);
+							carriedFoodId() = -1;
 							std::cout << "Unit " << name << " stored purchased food at home.\n";
 						}
 					}
@@ -1400,14 +1344,11 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	case ActionType::BringCoinToHouse: {
 		// Bring coin from stall to house after selling
 		// 1. If not carrying coin, navigate to coin location and pick it up
-		if (carriedCoinId == -1 && !receivedCoins.empty()) {
+		if (carriedCoinId() == -1 && !receivedCoins.empty()) {
 			// Find a coin that's owned by this seller
 			int coinId = receivedCoins.front();
-			auto coinIt = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-				return coin.coinId == coinId && coin.ownedByHouseId == id;
-			});
-			
-			if (coinIt == coins.end()) {
+			Coin* coin = coinManager.tryGet(coinId);
+			if (!coin || coin->ownedByHouseId != id) {
 				// Coin not found or already picked up
 				receivedCoins.erase(receivedCoins.begin());
 				if (receivedCoins.empty()) {
@@ -1418,89 +1359,77 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 			
 			// Navigate to coin
 			int coinGridX, coinGridY;
-			cellGrid.pixelToGrid(coinIt->x, coinIt->y, coinGridX, coinGridY);
+			cellGrid.pixelToGrid(coin->x, coin->y, coinGridX, coinGridY);
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
 			
 			if (unitGridX != coinGridX || unitGridY != coinGridY) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, coinGridX, coinGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, coinGridX, coinGridY, cellGrid);
 				}
 				break;
 			}
 			
 			// Pick up the coin
-			carriedCoinId = coinId;
-			coinIt->carriedByUnitId = id;
-			coinIt->x = x;
-			coinIt->y = y;
+			carriedCoinId() = coinId;
+			cellGrid.removeOccupantAtPixel(CellOccupant::Coin, coinId, coin->x, coin->y);
+			coinManager.setCarriedBy(*coin, id);
+			coin->x = x();
+			coin->y = y();
 			receivedCoins.erase(receivedCoins.begin());
 			std::cout << "Unit " << name << " picked up coin (id " << coinId << ") from sale to bring home.\n";
 			break;
 		}
 		
 		// 2. If carrying coin, navigate to house
-		if (carriedCoinId != -1) {
+		if (carriedCoinId() != -1) {
 			int unitGridX, unitGridY;
-			cellGrid.pixelToGrid(x, y, unitGridX, unitGridY);
-			if (unitGridX != houseGridX || unitGridY != houseGridY) {
+			cellGrid.pixelToGrid(x(), y(), unitGridX, unitGridY);
+			if (unitGridX != houseGridX() || unitGridY != houseGridY()) {
 				if (path.empty()) {
-					auto newPath = aStarFindPath(unitGridX, unitGridY, houseGridX, houseGridY, cellGrid);
-					if (!newPath.empty()) path = newPath;
+					requestPath(unitGridX, unitGridY, houseGridX(), houseGridY(), cellGrid);
 				}
 				break;
 			}
 			
 			// At house, store the coin
-			House* myHouse = nullptr;
-			if (g_HouseManager) {
-				for (auto& house : g_HouseManager->houses) {
-					if (house.ownerUnitId == id &&
-						house.gridX == houseGridX && house.gridY == houseGridY) {
-						myHouse = &house;
-						break;
-					}
-				}
-			}
+			House* myHouse = house();
 			
 			if (myHouse && myHouse->hasSpace()) {
-				auto coinIt = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-					return coin.coinId == carriedCoinId;
-				});
-				if (coinIt != coins.end()) {
-					if (myHouse->addCoin(carriedCoinId)) {
-						coinIt->carriedByUnitId = -1;
-						coinIt->ownedByHouseId = id;
+				Coin* coin = coinManager.tryGet(carriedCoinId());
+				if (coin) {
+					if (myHouse->addCoin(carriedCoinId())) {
+						coinManager.setCarriedBy(*coin, -1);
+						coinManager.setOwnedBy(*coin, id);
 						// Position coin in house
 						for (int dx = 0; dx < 3; ++dx) {
 							for (int dy = 0; dy < 3; ++dy) {
-								if (myHouse->coinIds[dx][dy] == carriedCoinId) {
-									cellGrid.gridToPixel(houseGridX + dx, houseGridY + dy, coinIt->x, coinIt->y);
+								if (myHouse->coinIds[dx][dy] == carriedCoinId()) {
+									cellGrid.gridToPixel(houseGridX() + dx, houseGridY() + dy, coin->x, coin->y);
 									break;
 								}
 							}
 						}
-						carriedCoinId = -1;
+						cellGrid.addOccupantAtPixel(CellOccupant::Coin, coin->coinId, coin->x, coin->y);
+						carriedCoinId() = -1;
 						std::cout << "Unit " << name << " stored coin at home.\n";
 					}
 				}
 			} else if (myHouse && !myHouse->hasSpace()) {
 				// House is full, drop coin at current location (outside house)
 				std::cout << "Unit " << name << " couldn't store coin - house is full. Dropping coin at house entrance.\n";
-				auto coinIt = std::find_if(coins.begin(), coins.end(), [&](const Coin& coin) {
-					return coin.coinId == carriedCoinId;
-				});
-				if (coinIt != coins.end()) {
-					coinIt->carriedByUnitId = -1;
-					coinIt->ownedByHouseId = -1; // Make it free for anyone to pick up
+				Coin* coin = coinManager.tryGet(carriedCoinId());
+				if (coin) {
+					coinManager.setCarriedBy(*coin, -1);
+					coinManager.setOwnedBy(*coin, -1); // Make it free for anyone to pick up
 					// Leave coin at current unit position
+					cellGrid.addOccupantAtPixel(CellOccupant::Coin, coin->coinId, coin->x, coin->y);
 				}
-				carriedCoinId = -1;
+				carriedCoinId() = -1;
 			}
 			
 			// Check if there are more coins to bring
-			if (receivedCoins.empty() && carriedCoinId == -1) {
+			if (receivedCoins.empty() && carriedCoinId() == -1) {
 				actionQueue.pop();
 			}
 		}
@@ -1515,41 +1444,21 @@ void Unit::processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vect
 	}
 }
 
-void Unit::tryFindAndPathToFood(CellGrid& cellGrid, std::vector<Food>& foods) {
+void Unit::tryFindAndPathToFood(CellGrid& cellGrid, const std::vector<Food>& foods) {
     if (foods.empty()) return;
 
-    // Find nearest food using cell grid for accuracy
+    // Find nearest reachable food; the search also gives the path to it
     int gridX, gridY;
-    cellGrid.pixelToGrid(x, y, gridX, gridY);
+    cellGrid.pixelToGrid(x(), y(), gridX, gridY);
 
-    int minDist = std::numeric_limits<int>::max();
-    int nearestFoodIdx = -1;
-    int foodGridX = 0, foodGridY = 0;
-
-    for (size_t i = 0; i < foods.size(); ++i) {
-        // Only consider food that is not carried and not owned by any house
-        if (foods[i].carriedByUnitId != -1 || foods[i].ownedByHouseId != -1) {
-            continue;
-        }
-        int fx, fy;
-        cellGrid.pixelToGrid(foods[i].x, foods[i].y, fx, fy);
-        int dist = abs(fx - gridX) + abs(fy - gridY);
-        if (dist < minDist) {
-            minDist = dist;
-            nearestFoodIdx = static_cast<int>(i);
-            foodGridX = fx;
-            foodGridY = fy;
-        }
-    }
+    std::vector<std::pair<int, int>> newPath;
+    int nearestFoodIdx = findNearestReachableItem(gridX, gridY, foods, cellGrid, isFreeFood, -1, newPath);
 
     if (nearestFoodIdx != -1) {
         // Path to the food to bring it home
-        auto newPath = aStarFindPath(gridX, gridY, foodGridX, foodGridY, cellGrid);
-        if (!newPath.empty()) {
-            path = newPath;
-            // Add BringFoodToHouse action with priority 9
-            addAction(Action(ActionType::BringFoodToHouse, 9));
-        }
+        path = UnitPath(newPath);
+        // Add BringFoodToHouse action with priority 9
+        addAction(Action(ActionType::BringFoodToHouse, 9));
     }
 }
 
@@ -1568,6 +1477,6 @@ void Unit::tryEatFromHouse() {
 
 bool Unit::isAtHouse(int gridX, int gridY) const {
     // Check if unit is within their house (3x3 area)
-    return (gridX >= houseGridX && gridX < houseGridX + 3 &&
-            gridY >= houseGridY && gridY < houseGridY + 3);
+    return (gridX >= houseGridX() && gridX < houseGridX() + 3 &&
+            gridY >= houseGridY() && gridY < houseGridY() + 3);
 }
\ No newline at end of file
@@ -6,63 +6,137 @@
 #include "Actions.h"
 #include <SDL.h>
 #include "Food.h"
+#include "UnitPath.h"
+#include "UnitComponents.h"
 
 class CellGrid; // Forward declaration
+struct House;
+struct Farm;
+struct Market;
+
+// Outcome of Unit::requestPath
+enum class PathRequestStatus {
+	Pending,     // Search still running on the path service; keep waiting
+	Found,       // Unit::path now holds the route
+	Unreachable  // No route to the goal
+};
 
 class Unit {
 public:
 	std::string name;   // Name of the unit
-    int x, y;           // Position on the grid
     char symbol;        // Character to display (e.g., '@')
-    int health;
-	int hunger = 100;
-	int morality = 100; // Morality starts at 100, minimum 0
 	std::vector<std::string> inventory;
-	int carriedFoodId = -1; // ID of food being carried, -1 if none
-	int carriedSeedId = -1; // ID of seed being carried, -1 if none
-	int carriedCoinId = -1; // ID of coin being carried, -1 if none
 	std::vector<int> coinInventory; // IDs of coins in unit's inventory
 	std::vector<int> receivedCoins; // IDs of coins received from sales (to be picked up)
-	Uint32 lastHungerUpdate = 0;
-	Uint32 lastHungerDebugPrint = 0;
-	Uint32 lastMoralityUpdate = 0;
     int id;
     unsigned int moveDelay;      // Delay in milliseconds between moves
     unsigned int lastMoveTime;   // Last time the unit moved (in SDL ticks)
-	int houseGridX = -1; // Grid X of assigned house location
-	int houseGridY = -1; // Grid Y of assigned house location
-	int stolenFromByUnitId = -1; // ID of unit who stole from this unit, -1 if none
-	int justStoleFromUnitId = -1; // ID of unit this unit just stole from (cleared after processing)
-	int fightingTargetId = -1; // ID of unit currently being fought, -1 if none
-	Uint32 fightStartTime = 0; // Time when fight started (for 2-second clamp)
-	bool isClamped = false; // Whether unit is clamped during fight
-	bool isSelling = false; // Whether unit is currently selling at a market stall
-	int sellingStallX = -1; // Grid X of market stall where unit is selling
-	int sellingStallY = -1; // Grid Y of market stall where unit is selling
 	Uint32 lastAtStallTime = 0; // Last time unit was at their stall
 	int justSoldToUnitId = -1; // ID of buyer unit who just bought from this seller (for coin transfer)
 	int coinToReceive = -1; // Coin ID to receive from last sale
 
-	std::vector<std::pair<int, int>> path;
+	// Hot state lives in the unit manager's component arrays (see
+	// UnitComponents.h); these look up this unit's row by id.
+	int& x() { return position().x; }
+	int& y() { return position().y; }
+	int& health() { return needs().health; }
+	int& hunger() { return needs().hunger; }
+	int& morality() { return needs().morality; }
+	Uint32& lastHungerUpdate() { return timers().lastHungerUpdate; }
+	Uint32& lastHungerDebugPrint() { return timers().lastHungerDebugPrint; }
+	Uint32& lastMoralityUpdate() { return timers().lastMoralityUpdate; }
+	int& houseGridX() { return ownership().houseGridX; }
+	int& houseGridY() { return ownership().houseGridY; }
+	int& carriedFoodId() { return ownership().carriedFoodId; }
+	int& carriedSeedId() { return ownership().carriedSeedId; }
+	int& carriedCoinId() { return ownership().carriedCoinId; }
+	bool& isSelling() { return ownership().isSelling; }
+	int& sellingStallX() { return ownership().sellingStallX; }
+	int& sellingStallY() { return ownership().sellingStallY; }
+	int& houseIndex() { return ownership().houseIndex; }
+	int& farmIndex() { return ownership().farmIndex; }
+	int& stallMarketIndex() { return ownership().stallMarketIndex; }
+	int& stolenFromByUnitId() { return combat().stolenFromByUnitId; }
+	int& justStoleFromUnitId() { return combat().justStoleFromUnitId; }
+	int& fightingTargetId() { return combat().fightingTargetId; }
+	Uint32& fightStartTime() { return combat().fightStartTime; }
+	bool& isClamped() { return combat().isClamped; }
+
+	int x() const { return position().x; }
+	int y() const { return position().y; }
+	int health() const { return needs().health; }
+	int hunger() const { return needs().hunger; }
+	int morality() const { return needs().morality; }
+	int houseGridX() const { return ownership().houseGridX; }
+	int houseGridY() const { return ownership().houseGridY; }
+	int carriedFoodId() const { return ownership().carriedFoodId; }
+	int carriedSeedId() const { return ownership().carriedSeedId; }
+	int carriedCoinId() const { return ownership().carriedCoinId; }
+	bool isSelling() const { return ownership().isSelling; }
+	int sellingStallX() const { return ownership().sellingStallX; }
+	int sellingStallY() const { return ownership().sellingStallY; }
+	int stolenFromByUnitId() const { return combat().stolenFromByUnitId; }
+	int fightingTargetId() const { return combat().fightingTargetId; }
+	bool isClamped() const { return combat().isClamped; }
+
+	// The unit's own buildings, nullptr until built (or while not selling)
+	House* house();
+	Farm* farm();
+	Market* stallMarket();
+
+	UnitPosition& position() { return components->positions[components->rowOf(id)]; }
+	UnitNeeds& needs() { return components->needs[components->rowOf(id)]; }
+	UnitTimers& timers() { return components->timers[components->rowOf(id)]; }
+	UnitOwnership& ownership() { return components->ownership[components->rowOf(id)]; }
+	UnitCombat& combat() { return components->combat[components->rowOf(id)]; }
+	const UnitPosition& position() const { return components->positions[components->rowOf(id)]; }
+	const UnitNeeds& needs() const { return components->needs[components->rowOf(id)]; }
+	const UnitOwnership& ownership() const { return components->ownership[components->rowOf(id)]; }
+	const UnitCombat& combat() const { return components->combat[components->rowOf(id)]; }
+
+	UnitPath path;               // Cells still to walk, consumed from the front
+	Uint32 pathTicket = 0;       // Outstanding async path request, 0 if none
+	int pathTicketGoalX = -1;    // Goal of the outstanding request
+	int pathTicketGoalY = -1;
 	std::priority_queue<Action, std::vector<Action>, ActionComparator> actionQueue;
 
 	  void addAction(const Action& action);
-	  void processAction(CellGrid& cellGrid, std::vector<Food>& foods, std::vector<Seed>& seeds, std::vector<Coin>& coins);
-	  void tryFindAndPathToFood(CellGrid& cellGrid, std::vector<Food>& foods);
+	  void processAction(CellGrid& cellGrid, FoodManager& foodManager, SeedManager& seedManager, CoinManager& coinManager);
+	  // Path from (startX, startY) to the goal without blocking the tick: cached
+	  // routes are set at once, anything else goes to the async path service (or,
+	  // without one, a budgeted main-thread search that may set a partial path
+	  // first) and is picked up by calling again with the same goal later.
+	  PathRequestStatus requestPath(int startX, int startY, int goalX, int goalY, const CellGrid& cellGrid);
+	  void tryFindAndPathToFood(CellGrid& cellGrid, const std::vector<Food>& foods);
 	  void bringItemToHouse(const std::string& itemType) {
 		  addAction(Action(ActionType::BringItemToHouse, 5, itemType));
 	  }
 	  void eatFromHouse() {
 		  addAction(Action(ActionType::EatFromHouse, 8));
 	  }
+	  // Stop selling and forget the stall
+	  void leaveStall() {
+		  UnitOwnership& owned = ownership();
+		  owned.isSelling = false;
+		  owned.sellingStallX = -1;
+		  owned.sellingStallY = -1;
+		  owned.stallMarketIndex = -1;
+	  }
 
 	
 
-	  Unit(int x, int y, char symbol, const std::string& name, int health = 100, int id = 0)
-		  : x(x), y(y), symbol(symbol), name(name), health(health), hunger(100), morality(100), lastHungerUpdate(0), lastHungerDebugPrint(0), lastMoralityUpdate(0), id(id), moveDelay(200), lastMoveTime(0) {
+	  // The unit's row must already exist in components (UnitManager::spawnUnit)
+	  Unit(UnitComponents& components, char symbol, const std::string& name, int id)
+		  : name(name), symbol(symbol), id(id), moveDelay(200), lastMoveTime(0), components(&components) {
 	  }
+
+private:
+	  UnitComponents* components;
 };
 
+// Drop the main-thread path search workspace of a unit that is being removed
+void releaseUnitPathSearch(int unitId);
+
 
 
 
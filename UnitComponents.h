@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <SDL.h>
+
+// Hot per-unit state, one struct per component. Everything a unit carries
+// around that no per-tick system reads (name, inventory, action queue,
+// path) stays on Unit itself.
+
+struct UnitPosition {
+    int x = 0; // Pixel position
+    int y = 0;
+};
+
+struct UnitNeeds {
+    int hunger = 100;
+    int morality = 100; // Minimum 0
+    int health = 100;
+};
+
+struct UnitTimers {
+    Uint32 lastHungerUpdate = 0;
+    Uint32 lastHungerDebugPrint = 0;
+    Uint32 lastMoralityUpdate = 0;
+};
+
+struct UnitOwnership {
+    int houseGridX = -1;    // Grid position of the unit's house, -1 if none
+    int houseGridY = -1;
+    int carriedFoodId = -1; // Item being carried, -1 if none
+    int carriedSeedId = -1;
+    int carriedCoinId = -1;
+    bool isSelling = false; // Standing at a market stall with food for sale
+    int sellingStallX = -1; // Grid position of that stall
+    int sellingStallY = -1;
+    // Buildings the unit owns or uses, as indices into the building managers'
+    // vectors (buildings are never removed, so these stay valid), -1 if none
+    int houseIndex = -1;
+    int farmIndex = -1;
+    int stallMarketIndex = -1; // Market of the stall the unit is selling at
+};
+
+struct UnitCombat {
+    int stolenFromByUnitId = -1;  // Unit who stole from this one, -1 if none
+    int justStoleFromUnitId = -1; // Victim of this tick's theft (cleared after processing)
+    int fightingTargetId = -1;    // Unit being fought, -1 if none
+    Uint32 fightStartTime = 0;    // When the 2-second fight clamp started
+    bool isClamped = false;       // Held in place by a fight
+};
+
+// Entity-component storage for units.
+//
+// Each component has its own dense array, and row i of every array belongs
+// to the same unit, so a system that needs only hunger and its timers walks
+// two small arrays instead of striding through whole Unit objects. Units are
+// named by their id, which never changes; removing units shifts the rows
+// after them down, so rows are not stable and are looked up by id on demand.
+// UnitManager keeps its Unit vector in the same row order.
+class UnitComponents {
+public:
+    // Give a unit a row of default components; returns the row
+    int add(int entity) {
+        if (entity >= static_cast<int>(rows.size())) {
+            rows.resize(entity + 1, -1);
+        }
+        int row = static_cast<int>(entities.size());
+        rows[entity] = row;
+        entities.push_back(entity);
+        positions.emplace_back();
+        needs.emplace_back();
+        timers.emplace_back();
+        ownership.emplace_back();
+        combat.emplace_back();
+        return row;
+    }
+
+    // Drop every row whose keep flag is 0 in one pass. Survivors keep their
+    // order and move down over the gaps.
+    void compact(const std::vector<char>& keep) {
+        size_t write = 0;
+        for (size_t row = 0; row < entities.size(); ++row) {
+            if (!keep[row]) {
+                rows[entities[row]] = -1;
+                continue;
+            }
+            if (write != row) {
+                entities[write] = entities[row];
+                positions[write] = positions[row];
+                needs[write] = needs[row];
+                timers[write] = timers[row];
+                ownership[write] = ownership[row];
+                combat[write] = combat[row];
+            }
+            rows[entities[write]] = static_cast<int>(write);
+            ++write;
+        }
+        entities.resize(write);
+        positions.resize(write);
+        needs.resize(write);
+        timers.resize(write);
+        ownership.resize(write);
+        combat.resize(write);
+    }
+
+    bool contains(int entity) const {
+        return entity >= 0 && entity < static_cast<int>(rows.size()) && rows[entity] != -1;
+    }
+
+    // Row of a unit that has one
+    int rowOf(int entity) const { return rows[entity]; }
+
+    size_t size() const { return entities.size(); }
+
+    // Dense arrays, all in row order
+    std::vector<int> entities; // Row -> unit id
+    std::vector<UnitPosition> positions;
+    std::vector<UnitNeeds> needs;
+    std::vector<UnitTimers> timers;
+    std::vector<UnitOwnership> ownership;
+    std::vector<UnitCombat> combat;
+
+private:
+    std::vector<int> rows; // Unit id -> row, -1 if none
+};
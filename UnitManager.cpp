@@ -3,9 +3,14 @@
 #include <SDL_ttf.h>
 #include <iostream>
 #include <random>
+#include <algorithm>
+#include <cstdlib>
 #include "CellGrid.h"
 #include "Buildings.h"
 #include "Unit.h"
+#include "FlowField.h"
+#include "CooperativePlanner.h"
+#include "MovingTargetPlanner.h"
 
 // Market initialization constants
 const int DEFAULT_MARKET_STOCK = 10;      // Initial food stock in market
@@ -45,13 +50,19 @@ bool UnitManager::initializeFont(const char* fontPath, int fontSize) {
 }
 
 void UnitManager::spawnUnit(int x, int y, const std::string& name, CellGrid* cellGrid) {
-    static int nextId = 1; // Static to ensure unique IDs
-    units.emplace_back(x, y, '@', name, 100, nextId++);
+    int id = nextId++;
+    lastSpawnedId = id;
+    int row = components.add(id);
+    components.positions[row].x = x;
+    components.positions[row].y = y;
+    components.timers[row].lastHungerUpdate = SDL_GetTicks();
+    components.timers[row].lastHungerDebugPrint = SDL_GetTicks();
+    units.emplace_back(components, '@', name, id);
 	Unit& unit = units.back();
-    unit.hunger = 100;
-	unit.lastHungerUpdate = SDL_GetTicks();
-	unit.lastHungerDebugPrint = SDL_GetTicks();
-    std::cout << "Spawned unit '" << name << "' at (" << x << ", " << y << ") with id " << (nextId-1) << std::endl;
+    std::cout << "Spawned unit '" << name << "' at (" << x << ", " << y << ") with id " << id << std::endl;
+	if (cellGrid) {
+		cellGrid->addOccupantAtPixel(CellOccupant::Unit, unit.id, x, y);
+	}
 
 	// Generate random house location
 	if (cellGrid) {
@@ -66,8 +77,8 @@ void UnitManager::spawnUnit(int x, int y, const std::string& name, CellGrid* cel
 		int randomX = distX(gen);
 		int randomY = distY(gen);
 
-		unit.houseGridX = randomX;
-		unit.houseGridY = randomY;
+		unit.houseGridX() = randomX;
+		unit.houseGridY() = randomY;
 		unit.addAction(Action(ActionType::BuildHouse, 8));
 	}
 	unit.addAction(Action(ActionType::BuildHouse, 8));
@@ -76,38 +87,78 @@ void UnitManager::spawnUnit(int x, int y, const std::string& name, CellGrid* cel
 
 }
 
-bool UnitManager::deleteUnitAt(int x, int y) {
+bool UnitManager::deleteUnitAt(int x, int y, CellGrid* cellGrid) {
     // Use a larger click area to make it easier to select units
     // Assuming characters are roughly 20x20 pixels (this can be adjusted)
     const int clickRadius = 20;
     
     for (auto it = units.begin(); it != units.end(); ++it) {
         // Check if click is within the unit's bounding box
-        if (x >= it->x - clickRadius && x <= it->x + clickRadius &&
-            y >= it->y - clickRadius && y <= it->y + clickRadius) {
-            std::cout << "Deleted unit '" << it->name << "' (id " << it->id << ") at (" << it->x << ", " << it->y << ")" << std::endl;
+        if (x >= it->x() - clickRadius && x <= it->x() + clickRadius &&
+            y >= it->y() - clickRadius && y <= it->y() + clickRadius) {
+            std::cout << "Deleted unit '" << it->name << "' (id " << it->id << ") at (" << it->x() << ", " << it->y() << ")" << std::endl;
             
-            // Clean up any references to this unit before deletion
             int deletedId = it->id;
-            
-            // Clear any theft tracking involving this unit
-            for (auto& otherUnit : units) {
-                if (otherUnit.stolenFromByUnitId == deletedId) {
-                    otherUnit.stolenFromByUnitId = -1;
-                    otherUnit.fightingTargetId = -1;
-                }
-                if (otherUnit.fightingTargetId == deletedId) {
-                    otherUnit.fightingTargetId = -1;
-                }
-            }
-            
-            units.erase(it);
+            removeUnitsIf([deletedId](Unit& unit) { return unit.id == deletedId; }, cellGrid);
             return true;
         }
     }
     return false;
 }
 
+void UnitManager::removeUnitsIf(const std::function<bool(Unit&)>& isDead, CellGrid* cellGrid) {
+    std::vector<char> keep(units.size(), 1);
+    bool anyDead = false;
+    for (size_t row = 0; row < units.size(); ++row) {
+        Unit& unit = units[row];
+        if (!isDead(unit)) {
+            continue;
+        }
+        keep[row] = 0;
+        anyDead = true;
+        if (g_CooperativePlanner) {
+            g_CooperativePlanner->release(unit.id);
+        }
+        releasePursuitPlanner(unit.id);
+        releaseUnitPathSearch(unit.id);
+        if (cellGrid) {
+            cellGrid->removeOccupantAtPixel(CellOccupant::Unit, unit.id, unit.x(), unit.y());
+        }
+    }
+    if (!anyDead) {
+        return;
+    }
+
+    // Clear any theft tracking involving the removed units; a pursuer whose
+    // thief is gone never reaches the Fight code that would drop its planner
+    auto isRemoved = [&](int id) {
+        return id != -1 && components.contains(id) && !keep[components.rowOf(id)];
+    };
+    for (size_t row = 0; row < components.size(); ++row) {
+        UnitCombat& combat = components.combat[row];
+        if (isRemoved(combat.stolenFromByUnitId)) {
+            combat.stolenFromByUnitId = -1;
+            combat.fightingTargetId = -1;
+            releasePursuitPlanner(components.entities[row]);
+        }
+        if (isRemoved(combat.fightingTargetId)) {
+            combat.fightingTargetId = -1;
+        }
+    }
+
+    // Compact units and their component rows together
+    size_t write = 0;
+    for (size_t row = 0; row < units.size(); ++row) {
+        if (keep[row]) {
+            if (write != row) {
+                units[write] = std::move(units[row]);
+            }
+            ++write;
+        }
+    }
+    units.erase(units.begin() + write, units.end());
+    components.compact(keep);
+}
 
 void UnitManager::renderUnits(SDL_Renderer* renderer) {
     if (!font) {
@@ -127,7 +178,7 @@ void UnitManager::renderUnits(SDL_Renderer* renderer) {
         // Create texture from surface
         SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
         if (texture) {
-            SDL_Rect dstRect = {unit.x, unit.y, surface->w, surface->h};
+            SDL_Rect dstRect = {unit.x(), unit.y(), surface->w, surface->h};
             SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
             SDL_DestroyTexture(texture);
         }
@@ -156,6 +207,13 @@ void initializeGameUnits(UnitManager* unitManager, CellGrid* cellGrid) {
 		int marketX = 10;  // Grid coordinates
 		int marketY = 10;
 		g_MarketManager->addMarket(Market(marketX, marketY));
+		cellGrid->addBuildingFootprint(BuildingKind::Market, static_cast<int>(g_MarketManager->markets.size()) - 1, marketX, marketY);
+		// Every trader heads for a stall, so give each stall its flow field up front
+		if (g_FlowFieldService) {
+			for (int dx = 0; dx < 3; ++dx)
+				for (int dy = 0; dy < 3; ++dy)
+					g_FlowFieldService->addDestination(marketX + dx, marketY + dy);
+		}
 		std::cout << "Initialized market at grid (" << marketX << ", " << marketY << ")\n";
 	}
 }
@@ -167,12 +225,15 @@ void UnitManager::renderUnitPaths(SDL_Renderer* renderer, const CellGrid& cellGr
     int cellHeight = cellGrid.getHeightInPixels() / cellGrid.getHeightInCells();
 
     for (const auto& unit : units) {
-        for (const auto& cell : unit.path) {
+        // Each straight run is one rectangle, no need to visit every cell
+        unit.path.forEachRun([&](int fromX, int fromY, int toX, int toY) {
             int px, py;
-            cellGrid.gridToPixel(cell.first, cell.second, px, py);
-            SDL_Rect rect = { px, py, cellWidth, cellHeight };
+            cellGrid.gridToPixel(std::min(fromX, toX), std::min(fromY, toY), px, py);
+            SDL_Rect rect = { px, py,
+                              (std::abs(toX - fromX) + 1) * cellWidth,
+                              (std::abs(toY - fromY) + 1) * cellHeight };
             SDL_RenderFillRect(renderer, &rect);
-        }
+        });
     }
 }
 
@@ -1,20 +1,37 @@
 #pragma once
 #include <vector>
+#include <functional>
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include "Unit.h"
 #include <iostream>
 
-// UnitManager handles spawning and rendering units
+// UnitManager handles spawning and rendering units.
+//
+// units[i] is the unit whose components are in row i, so the components'
+// id -> row map finds either in O(1). A unit's id is its stable handle:
+// removing other units moves units around in the vector (references and
+// pointers go stale) but the id keeps naming the same unit, so hold ids and
+// call find() rather than keeping Unit pointers across a tick.
 class UnitManager {
 private:
     std::vector<Unit> units;
+    UnitComponents components; // Hot state of every unit in units, same rows
+    int nextId = 1;
+    int lastSpawnedId = -1;
     TTF_Font* font;
 
 public:
     UnitManager();
     ~UnitManager();
 
+    // Every Unit points at this manager's components, so a copied or moved
+    // manager would leave its units reading the other one's arrays
+    UnitManager(const UnitManager&) = delete;
+    UnitManager& operator=(const UnitManager&) = delete;
+    UnitManager(UnitManager&&) = delete;
+    UnitManager& operator=(UnitManager&&) = delete;
+
     // Initialize font for rendering
     bool initializeFont(const char* fontPath, int fontSize);
 
@@ -22,7 +39,20 @@ public:
     void spawnUnit(int x, int y, const std::string& name, CellGrid* cellGrid);
 
     // Delete unit at given pixel position (returns true if unit was deleted)
-    bool deleteUnitAt(int x, int y);
+    bool deleteUnitAt(int x, int y, CellGrid* cellGrid = nullptr);
+
+    // Remove every unit isDead returns true for, along with everything that
+    // refers to it (planner reservations, its grid cell, other units' theft
+    // and fight tracking). One pass over the units, whatever the number
+    // removed; survivors keep their order.
+    void removeUnitsIf(const std::function<bool(Unit&)>& isDead, CellGrid* cellGrid);
+
+    // Unit with the given id, nullptr if there is none
+    Unit* find(int id) { return components.contains(id) ? &units[components.rowOf(id)] : nullptr; }
+    const Unit* find(int id) const { return components.contains(id) ? &units[components.rowOf(id)] : nullptr; }
+
+    // The most recently spawned unit, nullptr if it has been removed
+    Unit* getLastSpawned() { return find(lastSpawnedId); }
 
     // Render all units
     void renderUnits(SDL_Renderer* renderer);
@@ -32,6 +62,10 @@ public:
     std::vector<Unit>& getUnits();
     const std::vector<Unit>& getUnits() const;
 
+    // Component arrays, for systems that update every unit at once
+    UnitComponents& getComponents() { return components; }
+    const UnitComponents& getComponents() const { return components; }
+
 };
 
 
@@ -0,0 +1,40 @@
+#include "UnitPath.h"
+
+namespace {
+    int signOf(int v) { return (v > 0) - (v < 0); }
+}
+
+UnitPath::UnitPath(const std::vector<std::pair<int, int>>& cells) {
+    if (cells.empty()) return;
+
+    auto built = std::make_shared<Storage>();
+    built->waypoints.push_back(cells.front());
+    built->offsets.push_back(0);
+    for (size_t i = 1; i < cells.size(); ++i) {
+        bool turns = i + 1 == cells.size() ||
+            signOf(cells[i].first - cells[i - 1].first) != signOf(cells[i + 1].first - cells[i].first) ||
+            signOf(cells[i].second - cells[i - 1].second) != signOf(cells[i + 1].second - cells[i].second);
+        if (turns) {
+            built->waypoints.push_back(cells[i]);
+            built->offsets.push_back(static_cast<int>(i));
+        }
+    }
+    storage = std::move(built);
+}
+
+std::pair<int, int> UnitPath::cellAt(int index, int seg) const {
+    const auto& waypoints = storage->waypoints;
+    const auto& from = waypoints[seg];
+    if (seg + 1 >= static_cast<int>(waypoints.size())) return from;
+    const auto& to = waypoints[seg + 1];
+    int step = index - storage->offsets[seg];
+    return { from.first + signOf(to.first - from.first) * step,
+             from.second + signOf(to.second - from.second) * step };
+}
+
+std::vector<std::pair<int, int>> UnitPath::toCells(int maxCells) const {
+    std::vector<std::pair<int, int>> cells;
+    cells.reserve((maxCells < 0 || maxCells > size()) ? size() : maxCells);
+    forEachCell([&cells](int x, int y) { cells.emplace_back(x, y); }, maxCells);
+    return cells;
+}
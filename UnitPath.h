@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <memory>
+
+// A path a unit is walking, stored as straight-line runs.
+//
+// Only the cells where the path turns (plus both ends) are kept, each with
+// the number of cells walked to reach it. A cursor counts the cells already
+// consumed, so looking at the next cell and stepping past it are O(1) instead
+// of erasing from the front of a cell vector.
+//
+// The waypoint storage is immutable and reference counted. Copying a UnitPath
+// just shares it: the path cache hands the same storage to every unit that
+// takes a cached route, and each unit only owns its cursor.
+class UnitPath {
+public:
+    UnitPath() = default;
+
+    // Compress a cell-by-cell path (as returned by the pathfinders)
+    explicit UnitPath(const std::vector<std::pair<int, int>>& cells);
+
+    bool empty() const { return remaining() == 0; }
+    // Cells still to walk, including the next one
+    int size() const { return remaining(); }
+
+    std::pair<int, int> front() const { return cellAt(consumed, segment); }
+    std::pair<int, int> back() const { return storage->waypoints.back(); }
+
+    // Step past the front cell
+    void popFront() {
+        ++consumed;
+        int lastSegment = static_cast<int>(storage->waypoints.size()) - 2;
+        if (segment < lastSegment && consumed >= storage->offsets[segment + 1]) {
+            ++segment;
+        }
+    }
+
+    void clear() {
+        storage.reset();
+        consumed = 0;
+        segment = 0;
+    }
+
+    // Visit the remaining path as straight runs, fn(fromX, fromY, toX, toY),
+    // both ends inclusive. A one-cell path is a single run with from == to.
+    template <typename Fn>
+    void forEachRun(Fn&& fn) const {
+        if (empty()) return;
+        auto from = front();
+        const auto& waypoints = storage->waypoints;
+        for (size_t i = segment + 1; i < waypoints.size(); ++i) {
+            fn(from.first, from.second, waypoints[i].first, waypoints[i].second);
+            from = waypoints[i];
+        }
+        if (waypoints.size() == 1) {
+            fn(from.first, from.second, from.first, from.second);
+        }
+    }
+
+    // Visit every remaining cell (or the first maxCells), fn(x, y)
+    template <typename Fn>
+    void forEachCell(Fn&& fn, int maxCells = -1) const {
+        int end = (maxCells < 0 || maxCells > remaining()) ? totalCells() : consumed + maxCells;
+        for (int i = consumed, s = segment; i < end; ++i) {
+            if (s + 2 < static_cast<int>(storage->waypoints.size()) && i >= storage->offsets[s + 1]) ++s;
+            auto cell = cellAt(i, s);
+            fn(cell.first, cell.second);
+        }
+    }
+
+    // Expand the remaining cells (for code that still wants a vector), or
+    // only the first maxCells of them
+    std::vector<std::pair<int, int>> toCells(int maxCells = -1) const;
+
+    // True if both were copied from the same path (cursors may differ)
+    bool sharesStorageWith(const UnitPath& other) const { return storage == other.storage; }
+
+private:
+    struct Storage {
+        std::vector<std::pair<int, int>> waypoints; // First cell, every turn, last cell
+        std::vector<int> offsets;                   // Cells walked from the start to each waypoint
+    };
+
+    int totalCells() const { return storage ? storage->offsets.back() + 1 : 0; }
+    int remaining() const { return totalCells() - consumed; }
+    std::pair<int, int> cellAt(int index, int seg) const;
+
+    std::shared_ptr<const Storage> storage;
+    int consumed = 0; // Cells already walked
+    int segment = 0;  // Run holding the front cell
+};
@@ -0,0 +1,31 @@
+#include "WalkabilityPlane.h"
+
+void WalkabilityPlane::reset(int w, int h, bool open) {
+    width = w;
+    height = h;
+    // Border column on each side, plus the spare word for windowed reads
+    stride = (width + 2 + 63) / 64 + 1;
+    words.assign(static_cast<size_t>(height + 2) * stride, 0);
+    if (!open) return;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            set(x, y, true);
+        }
+    }
+}
+
+bool WalkabilityPlane::isAreaOpen(int x, int y, int w, int h) const {
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > width || y + h > height) {
+        return false;
+    }
+    for (int row = y; row < y + h; ++row) {
+        for (int column = x; column < x + w; column += 64) {
+            int count = x + w - column;
+            uint64_t mask = count >= 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+            if ((rowBitsFrom(column, row) & mask) != mask) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One bit per cell walkability, for the searches' inner loops.
+//
+// Rows are packed into 64-bit words with a one-cell blocked border all
+// around, so (x, y) may be anything from -1 to width / height inclusive
+// without a bounds check: stepping off the grid just reads a blocked cell.
+// Each row also carries a spare trailing word so a 64-cell window can be
+// read from any column without running into the next row.
+//
+// CellGrid owns the plane, which is its only record of walkability, and
+// writes it in setCellWalkable; nothing else should modify it.
+class WalkabilityPlane {
+public:
+    // Size the plane to the grid with every cell open (or blocked)
+    void reset(int width, int height, bool open);
+
+    void set(int x, int y, bool open) {
+        int bit = x + 1;
+        uint64_t& word = words[(y + 1) * stride + (bit >> 6)];
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        word = open ? (word | mask) : (word & ~mask);
+    }
+
+    bool isOpen(int x, int y) const {
+        int bit = x + 1;
+        return (words[(y + 1) * stride + (bit >> 6)] >> (bit & 63)) & 1;
+    }
+
+    // 64 cells of row y starting at column x (bit 0 = x). Columns off the
+    // grid read as blocked. x must be between -1 and width.
+    uint64_t rowBitsFrom(int x, int y) const {
+        return bitsAt((y + 1) * stride, x + 1);
+    }
+
+    // 64 cells of row y ending at column x (bit 63 = x, bit 62 = x - 1, ...)
+    uint64_t rowBitsUpTo(int x, int y) const {
+        int first = x + 1 - 63;
+        if (first >= 0) return bitsAt((y + 1) * stride, first);
+        // Window starts left of the border: those cells read as blocked
+        return bitsAt((y + 1) * stride, 0) << -first;
+    }
+
+    // True if every cell of the w x h area at (x, y) is on the grid and open.
+    // Tests up to 64 cells of a row per word operation.
+    bool isAreaOpen(int x, int y, int w, int h) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    static int lowestBit(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, v);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(v);
+#endif
+    }
+
+    static int highestBit(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, v);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(v);
+#endif
+    }
+
+private:
+    // 64 bits starting at padded column bit of the row beginning at rowStart
+    uint64_t bitsAt(int rowStart, int bit) const {
+        int index = rowStart + (bit >> 6);
+        int shift = bit & 63;
+        uint64_t low = words[index] >> shift;
+        return shift == 0 ? low : (low | (words[index + 1] << (64 - shift)));
+    }
+
+    int width = 0;
+    int height = 0;
+    int stride = 0;               // Words per padded row
+    std::vector<uint64_t> words;  // (height + 2) rows of stride words
+};
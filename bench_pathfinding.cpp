@@ -0,0 +1,164 @@
+// Pathfinding benchmark: legacy node-allocating A* vs the pooled PathSearchContext (A* and JPS)
+// Build: g++ -std=c++17 -O2 bench_pathfinding.cpp Pathfinding.cpp CellGrid.cpp WalkabilityPlane.cpp -lSDL2 -o bench_pathfinding
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "CellGrid.h"
+#include "Pathfinding.h"
+
+// Copy of the original aStarFindPath, kept here only as the "before" baseline
+namespace legacy {
+    struct Node {
+        int x, y;
+        float g, f;
+        Node* parent;
+        Node(int x, int y, float g, float f, Node* parent)
+            : x(x), y(y), g(g), f(f), parent(parent) {}
+    };
+
+    struct NodeCmp {
+        bool operator()(const Node* a, const Node* b) const {
+            return a->f > b->f;
+        }
+    };
+
+    std::vector<std::pair<int, int>> aStarFindPath(int startX, int startY, int goalX, int goalY, const CellGrid& grid) {
+        int w = grid.getWidthInCells();
+        int h = grid.getHeightInCells();
+        auto heuristic = [](int x1, int y1, int x2, int y2) {
+            return static_cast<float>(std::abs(x1 - x2) + std::abs(y1 - y2));
+        };
+        std::priority_queue<Node*, std::vector<Node*>, NodeCmp> open;
+        std::unordered_map<int, Node*> allNodes;
+        auto hash = [w](int x, int y) { return y * w + x; };
+        Node* start = new Node(startX, startY, 0.0f, heuristic(startX, startY, goalX, goalY), nullptr);
+        open.push(start);
+        allNodes[hash(startX, startY)] = start;
+        std::vector<std::pair<int, int>> path;
+        bool found = false;
+        while (!open.empty()) {
+            Node* current = open.top();
+            open.pop();
+            if (current->x == goalX && current->y == goalY) {
+                while (current) {
+                    path.emplace_back(current->x, current->y);
+                    current = current->parent;
+                }
+                std::reverse(path.begin(), path.end());
+                found = true;
+                break;
+            }
+            const int dx[4] = { 1, -1, 0, 0 };
+            const int dy[4] = { 0, 0, 1, -1 };
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = current->x + dx[dir];
+                int ny = current->y + dy[dir];
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                if (!grid.isCellWalkable(nx, ny)) continue;
+                float ng = current->g + 1.0f;
+                int nhash = hash(nx, ny);
+                if (!allNodes.count(nhash) || ng < allNodes[nhash]->g) {
+                    Node* neighbor = new Node(nx, ny, ng, ng + heuristic(nx, ny, goalX, goalY), current);
+                    open.push(neighbor);
+                    allNodes[nhash] = neighbor;
+                }
+            }
+        }
+        for (auto& kv : allNodes) delete kv.second;
+        if (!found) path.clear();
+        return path;
+    }
+}
+
+struct Query {
+    int sx, sy, gx, gy;
+};
+
+static void scatterWalls(CellGrid& grid, double density, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            if (roll(gen) < density) {
+                grid.setCellWalkable(x, y, false);
+            }
+        }
+    }
+}
+
+static std::vector<Query> makeQueries(const CellGrid& grid, int count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    std::vector<Query> queries;
+    while (static_cast<int>(queries.size()) < count) {
+        Query q{ distX(gen), distY(gen), distX(gen), distY(gen) };
+        if (grid.isCellWalkable(q.sx, q.sy) && grid.isCellWalkable(q.gx, q.gy)) {
+            queries.push_back(q);
+        }
+    }
+    return queries;
+}
+
+template <typename Fn>
+static double timeQueries(const std::vector<Query>& queries, Fn&& fn, size_t& totalLength) {
+    totalLength = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& q : queries) {
+        totalLength += fn(q).size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+static void runScenario(const char* label, CellGrid& grid, int queryCount) {
+    auto queries = makeQueries(grid, queryCount, 1234);
+    const CellGrid& constGrid = grid;
+
+    size_t legacyLength = 0, pooledLength = 0, jpsLength = 0;
+    double legacyMs = timeQueries(queries, [&](const Query& q) {
+        return legacy::aStarFindPath(q.sx, q.sy, q.gx, q.gy, constGrid);
+    }, legacyLength);
+    double pooledMs = timeQueries(queries, [&](const Query& q) {
+        return aStarFindPath(q.sx, q.sy, q.gx, q.gy, constGrid);
+    }, pooledLength);
+    double jpsMs = timeQueries(queries, [&](const Query& q) {
+        return jpsFindPath(q.sx, q.sy, q.gx, q.gy, constGrid);
+    }, jpsLength);
+
+    std::cout << label << " (" << grid.getWidthInCells() << "x" << grid.getHeightInCells()
+              << ", " << queryCount << " queries)\n";
+    std::cout << "  legacy: " << legacyMs << " ms (" << (legacyMs * 1000.0 / queryCount) << " us/query)\n";
+    std::cout << "  pooled: " << pooledMs << " ms (" << (pooledMs * 1000.0 / queryCount) << " us/query)\n";
+    std::cout << "  jps:    " << jpsMs << " ms (" << (jpsMs * 1000.0 / queryCount) << " us/query)\n";
+    std::cout << "  speedup: " << (pooledMs > 0.0 ? legacyMs / pooledMs : 0.0) << "x pooled, "
+              << (jpsMs > 0.0 ? legacyMs / jpsMs : 0.0) << "x jps\n";
+    if (legacyLength != pooledLength || legacyLength != jpsLength) {
+        std::cout << "  WARNING: total path length differs (" << legacyLength << " / " << pooledLength
+                  << " / " << jpsLength << ")\n";
+    }
+}
+
+int main() {
+    std::cout << "=== Pathfinding Benchmark ===\n\n";
+
+    // Default window-sized world (48x25 cells)
+    CellGrid screenGrid(sdlWindowWidth, sdlWindowHeight);
+    runScenario("Open screen grid", screenGrid, 20000);
+
+    CellGrid screenWalls(sdlWindowWidth, sdlWindowHeight);
+    scatterWalls(screenWalls, 0.25, 42);
+    runScenario("Screen grid, 25% walls", screenWalls, 20000);
+
+    // 3x3 regions worth of world (144x75 cells)
+    CellGrid worldGrid(sdlWindowWidth * 3, sdlWindowHeight * 3);
+    scatterWalls(worldGrid, 0.25, 7);
+    runScenario("9-region world, 25% walls", worldGrid, 2000);
+
+    return 0;
+}
@@ -0,0 +1,1648 @@
+// Pathfinding tests: Jump Point Search must return paths as short as A*,
+// HPA* must find valid paths across regions and follow walkability changes,
+// flow fields must trace A*-length paths and rebuild and evict as promised,
+// the async path service must hand back A*'s paths and drop what it should,
+// the moving-target planner must keep up with A* while the target wanders,
+// a resumable search must start over when walkability changes between slices,
+// the path cache must drop exactly the entries a walkability change breaks,
+// CellGrid's connected-component labels must agree with a fresh flood fill,
+// the multi-target search must find the target nearest by walking distance,
+// UnitPath must walk exactly the cells it was built from, units walking
+// under the cooperative planner must keep out of each other's way, the
+// cell grid occupancy must follow units and items as they move, and the
+// radius / nearest queries over them must match a scan of every item, a
+// huge chunked grid must keep only the chunks that hold something and report
+// which of them changed, building footprints must name the building and slot
+// under each cell, the items' slot map must tell stale handles from live
+// ones, and the item managers' ownership indexes must match a scan of the
+// items
+// Build: g++ -std=c++17 test_pathfinding.cpp Pathfinding.cpp CellGrid.cpp WalkabilityPlane.cpp UnitPath.cpp CooperativePlanner.cpp PathCache.cpp HierarchicalPathfinding.cpp FlowField.cpp AsyncPathService.cpp MovingTargetPlanner.cpp Food.cpp -lSDL2 -lSDL2_ttf -pthread -o test_pathfinding
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <queue>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <list>
+#include <unordered_set>
+#include <iterator>
+#include "CellGrid.h"
+#include "Pathfinding.h"
+#include "UnitPath.h"
+#include "CooperativePlanner.h"
+#include "PathCache.h"
+#include "SlotMap.h"
+#include "HierarchicalPathfinding.h"
+#include "FlowField.h"
+#include "AsyncPathService.h"
+#include "MovingTargetPlanner.h"
+#include "Food.h"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cout << "  ✗ FAIL: " << message << "\n";
+        ++failures;
+    }
+}
+
+// Every step must move exactly one cell onto a walkable cell
+static bool isValidPath(const std::vector<std::pair<int, int>>& path, const CellGrid& grid,
+                        int startX, int startY, int goalX, int goalY) {
+    if (path.empty()) return false;
+    if (path.front() != std::make_pair(startX, startY)) return false;
+    if (path.back() != std::make_pair(goalX, goalY)) return false;
+    for (size_t i = 1; i < path.size(); ++i) {
+        int step = std::abs(path[i].first - path[i - 1].first) + std::abs(path[i].second - path[i - 1].second);
+        if (step != 1) return false;
+        if (!grid.isCellWalkable(path[i].first, path[i].second)) return false;
+    }
+    return true;
+}
+
+static void runParity(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    int compared = 0, unreachable = 0;
+    long long aStarExpanded = 0, jpsExpanded = 0;
+    PathSearchContext context;
+
+    for (int q = 0; q < queries; ++q) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        if (!grid.isCellWalkable(sx, sy)) continue;
+
+        auto aStarPath = context.findPath(sx, sy, gx, gy, grid);
+        aStarExpanded += context.getLastExpandedCount();
+        auto jpsPath = context.findPathJPS(sx, sy, gx, gy, grid);
+        jpsExpanded += context.getLastExpandedCount();
+
+        if (aStarPath.empty()) {
+            check(jpsPath.empty(), std::string(label) + ": JPS found a path A* could not");
+            ++unreachable;
+            continue;
+        }
+        check(isValidPath(jpsPath, grid, sx, sy, gx, gy), std::string(label) + ": JPS path is not a valid cell-by-cell path");
+        check(jpsPath.size() == aStarPath.size(), std::string(label) + ": JPS length " + std::to_string(jpsPath.size()) +
+              " != A* length " + std::to_string(aStarPath.size()));
+        ++compared;
+    }
+
+    std::cout << "  ✓ " << label << ": " << compared << " paths compared, " << unreachable
+              << " unreachable (expansions A* " << aStarExpanded << " vs JPS " << jpsExpanded << ")\n";
+}
+
+// HPA*: cross-region paths must be valid and exist exactly when A* finds
+// one, also right after cells on the last path are blocked (which must
+// rebuild only the regions involved), a planner moved from one walkability
+// snapshot to the next must agree with one on the live grid, and replanning
+// from the end of each partial refinement must still arrive at the goal
+static void runHierarchical(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    HierarchicalPathfinder planner(grid);
+    // A second planner follows walkability snapshots, as the path workers' do
+    auto snapshot = std::make_unique<CellGrid>(grid.makeWalkabilitySnapshot());
+    HierarchicalPathfinder follower(*snapshot);
+
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    int compared = 0, crossRegion = 0, reachabilityErrors = 0, invalid = 0, stepwiseErrors = 0, snapshotErrors = 0;
+    double lengthRatio = 0.0;
+
+    for (int q = 0; q < queries; ++q) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        if (!grid.isCellWalkable(sx, sy) || !grid.isCellWalkable(gx, gy)) continue;
+
+        for (int round = 0; round < 2; ++round) {
+            auto reference = aStarFindPath(sx, sy, gx, gy, grid);
+            bool complete = false;
+            auto path = planner.findPath(sx, sy, gx, gy, 1 << 20, &complete);
+            if (reference.empty() != path.empty()) ++reachabilityErrors;
+
+            auto next = std::make_unique<CellGrid>(grid.makeWalkabilitySnapshot());
+            follower.setGrid(*next);
+            snapshot = std::move(next);
+            bool followerComplete = false;
+            auto followed = follower.findPath(sx, sy, gx, gy, 1 << 20, &followerComplete);
+            if (followed != path || followerComplete != complete) ++snapshotErrors;
+            if (reference.empty() || path.empty()) break;
+            if (!complete || !isValidPath(path, grid, sx, sy, gx, gy)) ++invalid;
+            if (path.size() < reference.size()) ++invalid;
+            ++compared;
+            lengthRatio += static_cast<double>(path.size()) / reference.size();
+            if (planner.getRegionIndexAt(sx, sy) != planner.getRegionIndexAt(gx, gy)) ++crossRegion;
+            if (round == 1 || path.size() < 3) break;
+
+            // Block a cell in the middle of that path: the affected regions
+            // must be rebuilt before the next query
+            auto blocked = path[path.size() / 2];
+            grid.setCellWalkable(blocked.first, blocked.second, false);
+        }
+
+        // Refine a few edges at a time, replanning from where each piece ends
+        int x = sx, y = sy;
+        bool arrived = false;
+        for (int leg = 0; leg < 1000 && !arrived; ++leg) {
+            bool complete = false;
+            auto piece = planner.findPath(x, y, gx, gy, 2, &complete);
+            if (piece.empty()) break;
+            if (!isValidPath(piece, grid, x, y, piece.back().first, piece.back().second)) break;
+            x = piece.back().first;
+            y = piece.back().second;
+            arrived = complete;
+        }
+        if (grid.canReach(sx, sy, gx, gy) && (!arrived || x != gx || y != gy)) ++stepwiseErrors;
+    }
+
+    check(reachabilityErrors == 0, std::string(label) + ": HPA* and A* disagree on reachability");
+    check(invalid == 0, std::string(label) + ": HPA* returned an invalid or impossibly short path");
+    check(stepwiseErrors == 0, std::string(label) + ": replanning from partial HPA* paths did not arrive");
+    check(snapshotErrors == 0, std::string(label) + ": planner following snapshots disagrees with the live one");
+    if (reachabilityErrors == 0 && invalid == 0 && stepwiseErrors == 0 && snapshotErrors == 0) {
+        std::cout << "  ✓ " << label << ": " << compared << " paths (" << crossRegion << " cross-region), "
+                  << "length " << (compared ? lengthRatio / compared : 0.0) << "x A* on average\n";
+    }
+}
+
+// Flow fields: traced paths must be valid and as short as A*, a goal gets a
+// field only once it has been asked for often enough, a walkability change
+// rebuilds a field on its next read (not before), and the least recently
+// used fields are evicted to stay under the memory budget
+static void runFlowFields(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int goals, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    auto randomOpenCell = [&](int& x, int& y) {
+        do {
+            x = distX(gen);
+            y = distY(gen);
+        } while (!grid.isCellWalkable(x, y));
+    };
+
+    const size_t fieldBytes = static_cast<size_t>(grid.getWidthInCells()) * grid.getHeightInCells();
+    const int hotThreshold = 3;
+    FlowFieldService service(grid, fieldBytes * 3, hotThreshold);
+    std::vector<std::pair<int, int>> path;
+
+    // Demand counting: only the hotThreshold-th miss builds a field
+    int gx, gy;
+    randomOpenCell(gx, gy);
+    bool coldMisses = true;
+    for (int i = 1; i < hotThreshold; ++i) {
+        coldMisses &= !service.tracePath(gx, gy, gx, gy, path);
+    }
+    bool builtWhenHot = service.tracePath(gx, gy, gx, gy, path) && service.getFieldCount() == 1;
+
+    // Parity with A*, and a lazy rebuild after blocking a cell on a traced path
+    int compared = 0, wrongLength = 0, invalid = 0, eagerRebuilds = 0, missedRebuilds = 0;
+    for (int g = 0; g < goals; ++g) {
+        randomOpenCell(gx, gy);
+        service.addDestination(gx, gy);
+        for (int q = 0; q < queries; ++q) {
+            int sx, sy;
+            randomOpenCell(sx, sy);
+            auto reference = aStarFindPath(sx, sy, gx, gy, grid);
+            if (!service.tracePath(sx, sy, gx, gy, path)) {
+                ++invalid;
+                continue;
+            }
+            if (reference.empty() != path.empty()) ++wrongLength;
+            if (path.empty()) continue;
+            if (!isValidPath(path, grid, sx, sy, gx, gy)) ++invalid;
+            if (path.size() != reference.size()) ++wrongLength;
+            ++compared;
+
+            if (q % 10 == 0 && path.size() > 2) {
+                size_t rebuiltBefore = service.getRebuildCount();
+                auto blocked = path[path.size() / 2];
+                grid.setCellWalkable(blocked.first, blocked.second, false);
+                if (service.getRebuildCount() != rebuiltBefore) ++eagerRebuilds;
+                service.tracePath(sx, sy, gx, gy, path);
+                if (service.getRebuildCount() != rebuiltBefore + 1) ++missedRebuilds;
+                reference = aStarFindPath(sx, sy, gx, gy, grid);
+                if (reference.size() != path.size()) ++wrongLength;
+                if (!path.empty() && !isValidPath(path, grid, sx, sy, gx, gy)) ++invalid;
+            }
+        }
+    }
+
+    // Eviction: a budget of three fields keeps the three most recently used
+    FlowFieldService lru(grid, fieldBytes * 3, hotThreshold);
+    int goalX[4], goalY[4];
+    for (int i = 0; i < 4; ++i) randomOpenCell(goalX[i], goalY[i]);
+    for (int i = 0; i < 3; ++i) lru.addDestination(goalX[i], goalY[i]);
+    int stepX, stepY;
+    lru.getNextStep(goalX[0], goalY[0], goalX[0], goalY[0], stepX, stepY); // Goal 0 is now the most recent
+    lru.addDestination(goalX[3], goalY[3]);                                // Evicts goal 1
+    bool evicted = lru.getFieldCount() == 3 && lru.getMemoryUsage() <= fieldBytes * 3 &&
+                   lru.getNextStep(goalX[0], goalY[0], goalX[0], goalY[0], stepX, stepY) &&
+                   !lru.getNextStep(goalX[1], goalY[1], goalX[1], goalY[1], stepX, stepY) &&
+                   lru.getNextStep(goalX[3], goalY[3], goalX[3], goalY[3], stepX, stepY);
+    bool withinBudget = service.getMemoryUsage() <= fieldBytes * 3;
+
+    check(coldMisses && builtWhenHot, std::string(label) + ": field not built exactly when the goal became hot");
+    check(wrongLength == 0, std::string(label) + ": flow field path length differs from A*");
+    check(invalid == 0, std::string(label) + ": flow field path is not a valid cell-by-cell path");
+    check(eagerRebuilds == 0 && missedRebuilds == 0, std::string(label) + ": field not rebuilt lazily on the next read");
+    check(evicted && withinBudget, std::string(label) + ": eviction did not keep the most recently used fields in budget");
+    if (coldMisses && builtWhenHot && wrongLength == 0 && invalid == 0 && eagerRebuilds == 0 &&
+        missedRebuilds == 0 && evicted && withinBudget) {
+        std::cout << "  ✓ " << label << ": " << compared << " traced paths as short as A*, "
+                  << service.getRebuildCount() << " builds, " << service.getFieldCount() << " fields resident\n";
+    }
+}
+
+// Async path service: every ticket not cancelled comes back through poll
+// with the same path a synchronous A* finds, at most maxResultsPerTick per
+// tick; cancelled tickets (queued or already running) never come back and
+// poll as Unknown; results nobody polls expire and then poll as Unknown, so
+// the owner knows to submit again; and a result reports the walkability
+// version it was searched on
+static void runAsyncService(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int requests) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+
+    const int cap = 4;
+    AsyncPathService service(4, cap);
+    struct Request { PathTicket ticket; int sx, sy, gx, gy; bool cancelled, claimed; };
+    std::vector<Request> submitted;
+    for (int i = 0; i < requests; ++i) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        PathTicket ticket = service.submit(sx, sy, gx, gy, grid);
+        // Every 5th is cancelled right away, most likely still queued
+        bool cancelled = i % 5 == 0;
+        if (cancelled) service.cancel(ticket);
+        submitted.push_back({ ticket, sx, sy, gx, gy, cancelled, false });
+    }
+
+    // Nothing is integrated before the first beginTick, so every live ticket
+    // is still pending and every cancelled one is already unknown
+    int wrongStatus = 0;
+    std::vector<std::pair<int, int>> path;
+    for (const Request& request : submitted) {
+        PathPollStatus expected = request.cancelled ? PathPollStatus::Unknown : PathPollStatus::Pending;
+        if (service.poll(request.ticket, path) != expected) ++wrongStatus;
+    }
+
+    int wrongPaths = 0, cancelledReturned = 0, overCap = 0, tickAtCap = 0, wrongVersion = 0;
+    size_t integratedBefore = 0;
+    auto allClaimed = [&]() {
+        for (const Request& request : submitted) {
+            if (!request.cancelled && !request.claimed) return false;
+        }
+        return true;
+    };
+    for (int tick = 0; tick < 10000 && (tick < 3 || !allClaimed()); ++tick) {
+        service.beginTick();
+        size_t integrated = service.getStats().integrated;
+        if (integrated - integratedBefore > static_cast<size_t>(cap)) ++overCap;
+        if (integrated - integratedBefore == static_cast<size_t>(cap)) ++tickAtCap;
+        integratedBefore = integrated;
+
+        for (size_t i = 0; i < submitted.size(); ++i) {
+            Request& request = submitted[i];
+            // Cancel a few more a couple of ticks in, when they may be running
+            if (tick == 1 && i % 5 == 2) {
+                service.cancel(request.ticket);
+                request.cancelled = true;
+                if (service.poll(request.ticket, path) != PathPollStatus::Unknown) ++wrongStatus;
+            }
+            if (request.claimed) continue;
+            uint64_t version = 0;
+            if (service.poll(request.ticket, path, &version) != PathPollStatus::Ready) continue;
+            request.claimed = true;
+            if (request.cancelled) {
+                ++cancelledReturned;
+                continue;
+            }
+            if (version != grid.getWalkabilityVersion()) ++wrongVersion;
+            if (path != aStarFindPath(request.sx, request.sy, request.gx, request.gy, grid)) ++wrongPaths;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool noneMissing = allClaimed();
+
+    // A collected ticket is unknown from then on, and cancelling it is a no-op
+    size_t cancelledBefore = service.getStats().cancelled;
+    for (const Request& request : submitted) {
+        if (service.poll(request.ticket, path) != PathPollStatus::Unknown) ++wrongStatus;
+        service.cancel(request.ticket);
+    }
+    if (service.getStats().cancelled != cancelledBefore) ++wrongStatus;
+
+    // Results nobody polls are dropped once they have waited long enough
+    AsyncPathService unclaimed(2, cap);
+    const int unclaimedCount = 12;
+    std::vector<PathTicket> unclaimedTickets;
+    for (int i = 0; i < unclaimedCount; ++i) {
+        unclaimedTickets.push_back(unclaimed.submit(distX(gen), distY(gen), distX(gen), distY(gen), grid));
+    }
+    for (int tick = 0; tick < 10000 && unclaimed.getStats().integrated < static_cast<size_t>(unclaimedCount); ++tick) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        unclaimed.beginTick();
+    }
+    for (int tick = 0; tick <= 600; ++tick) unclaimed.beginTick();
+    int unclaimedReturned = 0;
+    for (PathTicket ticket : unclaimedTickets) {
+        if (unclaimed.poll(ticket, path) != PathPollStatus::Unknown) ++unclaimedReturned;
+    }
+    bool expired = unclaimedReturned == 0 && unclaimed.getStats().cancelled == static_cast<size_t>(unclaimedCount);
+
+    // A search submitted before a walkability change reports the older version
+    uint64_t before = grid.getWalkabilityVersion();
+    PathTicket stale = service.submit(0, 0, grid.getWidthInCells() - 1, grid.getHeightInCells() - 1, grid);
+    grid.setCellWalkable(1, 1, !grid.isCellWalkable(1, 1));
+    uint64_t reported = 0;
+    for (int tick = 0; tick < 10000 && service.poll(stale, path, &reported) != PathPollStatus::Ready; ++tick) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        service.beginTick();
+    }
+    bool staleReported = reported == before && reported != grid.getWalkabilityVersion();
+
+    check(wrongPaths == 0 && wrongVersion == 0, std::string(label) + ": async result differs from synchronous A*");
+    check(noneMissing, std::string(label) + ": a ticket never came back");
+    check(wrongStatus == 0, std::string(label) + ": poll reported the wrong status");
+    check(cancelledReturned == 0, std::string(label) + ": a cancelled ticket came back from poll");
+    check(overCap == 0 && tickAtCap > 0, std::string(label) + ": per-tick integration cap not applied");
+    check(expired, std::string(label) + ": unclaimed results were not dropped");
+    check(staleReported, std::string(label) + ": result did not report the version it was searched on");
+    if (wrongPaths == 0 && wrongVersion == 0 && noneMissing && wrongStatus == 0 && cancelledReturned == 0 && overCap == 0 &&
+        tickAtCap > 0 && expired && staleReported) {
+        std::cout << "  ✓ " << label << ": " << requests << " requests on " << service.getWorkerCount()
+                  << " workers match A*, cancelled and expired tickets never returned\n";
+    }
+}
+
+// Moving-target planner: chasing a target that wanders, every replan must be
+// a valid path as short as A*'s; blocking a cell keeps what was learned, and
+// opening one throws it away
+static void runMovingTarget(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int steps) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    std::uniform_int_distribution<> direction(0, 3);
+    const int DX[4] = { 1, -1, 0, 0 };
+    const int DY[4] = { 0, 0, 1, -1 };
+
+    // Start both ends in the same component
+    int px, py, tx, ty;
+    do {
+        px = distX(gen); py = distY(gen); tx = distX(gen); ty = distY(gen);
+    } while (!grid.isCellWalkable(px, py) || !grid.isCellWalkable(tx, ty) || !grid.canReach(px, py, tx, ty));
+
+    MovingTargetPlanner planner(grid);
+    int compared = 0, wrongLength = 0, invalid = 0, resetOnBlock = 0, missedReset = 0;
+    long long plannerExpanded = 0, aStarExpanded = 0;
+    for (int step = 0; step < steps; ++step) {
+        size_t resetsBefore = planner.getResetCount();
+        int change = step % 25 == 10 ? 1 : (step % 25 == 20 ? 2 : 0); // 1 = block a cell, 2 = open one
+        if (change != 0) {
+            int cx, cy;
+            do {
+                cx = distX(gen); cy = distY(gen);
+            } while (grid.isCellWalkable(cx, cy) != (change == 1) || (cx == px && cy == py) || (cx == tx && cy == ty));
+            grid.setCellWalkable(cx, cy, change == 2);
+        }
+
+        auto path = planner.findPath(px, py, tx, ty);
+        plannerExpanded += planner.getLastExpandedCount();
+        auto reference = aStarFindPath(px, py, tx, ty, grid);
+        aStarExpanded += getThreadPathSearchContext().getLastExpandedCount();
+        if (change == 1 && planner.getResetCount() != resetsBefore) ++resetOnBlock;
+        if (change == 2 && planner.getResetCount() != resetsBefore + 1) ++missedReset;
+
+        if (path.size() != reference.size()) ++wrongLength;
+        if (!path.empty() && !isValidPath(path, grid, px, py, tx, ty)) ++invalid;
+        ++compared;
+        if (path.size() > 1) {
+            // The pursuer takes one step; the target wanders off
+            px = path[1].first;
+            py = path[1].second;
+        }
+        int d = direction(gen);
+        if (grid.isCellWalkable(tx + DX[d], ty + DY[d])) {
+            tx += DX[d];
+            ty += DY[d];
+        }
+        if ((px == tx && py == ty) || reference.empty()) {
+            // Caught (or cut off): the target flees to somewhere new, if there is anywhere
+            int tries = 0;
+            do {
+                tx = distX(gen); ty = distY(gen);
+            } while (++tries < 10000 && (!grid.isCellWalkable(tx, ty) || !grid.canReach(px, py, tx, ty)));
+            if (tries == 10000) {
+                tx = px;
+                ty = py;
+            }
+        }
+    }
+
+    check(wrongLength == 0, std::string(label) + ": moving-target path length differs from A*");
+    check(invalid == 0, std::string(label) + ": moving-target path is not a valid cell-by-cell path");
+    check(resetOnBlock == 0, std::string(label) + ": blocking a cell threw away what was learned");
+    check(missedReset == 0, std::string(label) + ": opening a cell did not reset what was learned");
+    if (wrongLength == 0 && invalid == 0 && resetOnBlock == 0 && missedReset == 0) {
+        std::cout << "  ✓ " << label << ": " << compared << " replans as short as A* (expansions "
+                  << plannerExpanded << " vs A* " << aStarExpanded << ")\n";
+    }
+}
+
+// Resumable search: a search continued a slice at a time must end as short
+// as a fresh A*, and when cells are blocked or opened between slices it must
+// start over, never handing back a path through a cell blocked since it began
+static void runResumableSearch(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+
+    PathSearchContext search;
+    std::vector<std::pair<int, int>> path;
+    int finished = 0, changedMidSearch = 0, wrongLength = 0, invalid = 0, wrongStatus = 0;
+    for (int q = 0; q < queries; ++q) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        if (!grid.isCellWalkable(sx, sy) || !grid.isCellWalkable(gx, gy)) continue;
+
+        search.beginSearch(sx, sy, gx, gy, grid);
+        PathSearchStatus status = search.continueSearch(20, path);
+        for (int slice = 0; slice < 10000 && (status == PathSearchStatus::Partial || status == PathSearchStatus::BudgetExhausted); ++slice) {
+            if (status == PathSearchStatus::Partial) {
+                if (!isValidPath(path, grid, sx, sy, path.back().first, path.back().second)) ++invalid;
+                if (slice % 3 == 0 && path.size() > 2) {
+                    // Block the partial path's far end, or open a random cell
+                    auto cell = path.back();
+                    if (slice % 2 == 0 && cell != std::make_pair(gx, gy)) {
+                        grid.setCellWalkable(cell.first, cell.second, false);
+                    } else {
+                        grid.setCellWalkable(distX(gen), distY(gen), true);
+                    }
+                    ++changedMidSearch;
+                }
+            }
+            status = search.continueSearch(20, path);
+        }
+
+        auto reference = aStarFindPath(sx, sy, gx, gy, grid);
+        if (status == PathSearchStatus::Found) {
+            if (!isValidPath(path, grid, sx, sy, gx, gy)) ++invalid;
+            if (path.size() != reference.size()) ++wrongLength;
+        } else if (status != PathSearchStatus::Unreachable || !reference.empty()) {
+            ++wrongStatus;
+        }
+        ++finished;
+    }
+
+    check(invalid == 0, std::string(label) + ": resumed search returned a path through a blocked cell");
+    check(wrongLength == 0, std::string(label) + ": resumed search path longer or shorter than A*");
+    check(wrongStatus == 0, std::string(label) + ": resumed search ended Unreachable while A* finds a path");
+    if (invalid == 0 && wrongLength == 0 && wrongStatus == 0) {
+        std::cout << "  ✓ " << label << ": " << finished << " searches in slices of 20, "
+                  << changedMidSearch << " walkability changes mid-search\n";
+    }
+}
+
+// Path cache: a model of the promised invalidation and LRU order must agree
+// with the cache on every lookup. Blocking a cell drops exactly the paths
+// through it, opening one drops exactly the cached "unreachable" entries,
+// the least recently used entry goes when the cache is full, and hits and
+// misses are counted. Every hit must also hold on the live grid: a path is
+// still walkable and no shorter than a fresh findPath, "unreachable" still is
+static void runPathCache(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int operations) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+
+    // More pairs than the cache holds, so entries get evicted and come back
+    const size_t capacity = 32;
+    const int pairCount = 48;
+    struct Query { int sx, sy, gx, gy; };
+    std::vector<Query> pairs;
+    for (int i = 0; i < pairCount; ++i) pairs.push_back({ distX(gen), distY(gen), distX(gen), distY(gen) });
+    std::uniform_int_distribution<> pickPair(0, pairCount - 1);
+
+    PathCache cache(grid, capacity);
+    struct ModelEntry { int pair; std::vector<std::pair<int, int>> path; };
+    std::list<ModelEntry> model; // Most recently used first
+    std::vector<int> flipped;    // Cells changed since the cache last synced
+    size_t modelHits = 0, modelMisses = 0;
+
+    // The cache syncs on each lookup or store and judges every changed cell
+    // by its walkability at that point, so the model does the same
+    auto syncModel = [&]() {
+        bool anyOpened = false;
+        for (int cell : flipped) {
+            int x = cell % grid.getWidthInCells(), y = cell / grid.getWidthInCells();
+            if (grid.isCellWalkable(x, y)) {
+                anyOpened = true;
+                continue;
+            }
+            model.remove_if([&](const ModelEntry& entry) {
+                return std::find(entry.path.begin(), entry.path.end(), std::make_pair(x, y)) != entry.path.end();
+            });
+        }
+        if (anyOpened) model.remove_if([](const ModelEntry& entry) { return entry.path.empty(); });
+        flipped.clear();
+    };
+
+    int wrongHit = 0, wrongPath = 0, stalePath = 0, overCapacity = 0, flips = 0;
+    for (int op = 0; op < operations; ++op) {
+        if (roll(gen) < 0.3) {
+            // Flip a cell, half the time one a cached path runs through
+            int x = distX(gen), y = distY(gen);
+            if (!model.empty() && roll(gen) < 0.5) {
+                auto entry = model.begin();
+                std::advance(entry, std::uniform_int_distribution<>(0, static_cast<int>(model.size()) - 1)(gen));
+                if (!entry->path.empty()) {
+                    const auto& cell = entry->path[std::uniform_int_distribution<>(0, static_cast<int>(entry->path.size()) - 1)(gen)];
+                    x = cell.first;
+                    y = cell.second;
+                }
+            }
+            grid.setCellWalkable(x, y, !grid.isCellWalkable(x, y));
+            flipped.push_back(y * grid.getWidthInCells() + x);
+            ++flips;
+            continue;
+        }
+
+        int pair = pickPair(gen);
+        const Query& q = pairs[pair];
+        syncModel();
+        auto expected = std::find_if(model.begin(), model.end(), [pair](const ModelEntry& entry) { return entry.pair == pair; });
+
+        std::vector<std::pair<int, int>> cached;
+        bool hit = cache.lookup(q.sx, q.sy, q.gx, q.gy, cached);
+        if (hit != (expected != model.end())) ++wrongHit;
+
+        if (expected != model.end()) {
+            ++modelHits;
+            model.splice(model.begin(), model, expected);
+            if (hit && cached != expected->path) ++wrongPath;
+            std::vector<std::pair<int, int>> fresh = findPath(q.sx, q.sy, q.gx, q.gy, grid);
+            if (hit && cached.empty() != fresh.empty()) ++stalePath;
+            if (hit && !cached.empty() && (!isValidPath(cached, grid, q.sx, q.sy, q.gx, q.gy) || cached.size() < fresh.size())) ++stalePath;
+        } else {
+            ++modelMisses;
+            // Search on the live grid and cache the answer, as units do
+            std::vector<std::pair<int, int>> fresh = findPath(q.sx, q.sy, q.gx, q.gy, grid);
+            cache.store(q.sx, q.sy, q.gx, q.gy, fresh);
+            while (model.size() >= capacity) model.pop_back();
+            model.push_front({ pair, fresh });
+        }
+        if (cache.getSize() > cache.getCapacity() || cache.getSize() != model.size()) ++overCapacity;
+    }
+    bool countsMatch = cache.getHits() == modelHits && cache.getMisses() == modelMisses;
+
+    check(wrongHit == 0, std::string(label) + ": cache kept or dropped the wrong entries");
+    check(wrongPath == 0, std::string(label) + ": cache hit returned a different path than was stored");
+    check(stalePath == 0, std::string(label) + ": cache hit is no longer valid on the live grid");
+    check(overCapacity == 0, std::string(label) + ": cache size went past its capacity or off the LRU model");
+    check(countsMatch, std::string(label) + ": hit / miss counts wrong");
+    if (wrongHit == 0 && wrongPath == 0 && stalePath == 0 && overCapacity == 0 && countsMatch) {
+        std::cout << "  ✓ " << label << ": " << modelHits << " hits, " << modelMisses << " misses over "
+                  << flips << " cell flips, never more than " << capacity << " entries\n";
+    }
+}
+
+// Reference labelling: plain BFS from scratch
+static std::vector<int> floodFillComponents(const CellGrid& grid) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::vector<int> labels(w * h, -1);
+    int next = 0;
+    for (int i = 0; i < w * h; ++i) {
+        if (labels[i] != -1 || !grid.isCellWalkable(i % w, i / w)) continue;
+        std::queue<int> open;
+        open.push(i);
+        labels[i] = next;
+        while (!open.empty()) {
+            int cell = open.front();
+            open.pop();
+            int x = cell % w, y = cell / w;
+            const int dx[4] = { 1, -1, 0, 0 };
+            const int dy[4] = { 0, 0, 1, -1 };
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = x + dx[dir], ny = y + dy[dir];
+                if (!grid.isCellWalkable(nx, ny) || labels[ny * w + nx] != -1) continue;
+                labels[ny * w + nx] = next;
+                open.push(ny * w + nx);
+            }
+        }
+        ++next;
+    }
+    return labels;
+}
+
+// Incremental labels must partition cells exactly like the reference
+static bool componentsMatch(const CellGrid& grid) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::vector<int> reference = floodFillComponents(grid);
+    std::vector<int> toIncremental(w * h, -1);
+    std::vector<int> toReference(w * h + 1, -1);
+    for (int i = 0; i < w * h; ++i) {
+        int a = reference[i];
+        int b = grid.getComponentId(i % w, i / w);
+        if ((a == -1) != (b == -1)) return false;
+        if (a == -1) continue;
+        if (b < 0 || b > w * h) return false;
+        if (toIncremental[a] == -1) toIncremental[a] = b;
+        if (toReference[b] == -1) toReference[b] = a;
+        if (toIncremental[a] != b || toReference[b] != a) return false;
+    }
+    return true;
+}
+
+static void runComponentChurn(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int flips) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            grid.setCellWalkable(x, y, roll(gen) >= wallDensity);
+        }
+    }
+
+    int mismatches = 0;
+    int reachabilityErrors = 0;
+    for (int i = 0; i < flips; ++i) {
+        int x = distX(gen), y = distY(gen);
+        grid.setCellWalkable(x, y, !grid.isCellWalkable(x, y));
+        if (i % 10 == 0 && !componentsMatch(grid)) ++mismatches;
+        if (i % 10 == 0) {
+            // Both ends walkable: canReach must match the reference labels
+            int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+            if (grid.isCellWalkable(sx, sy) && grid.isCellWalkable(gx, gy)) {
+                std::vector<int> reference = floodFillComponents(grid);
+                int w = grid.getWidthInCells();
+                bool expected = reference[sy * w + sx] == reference[gy * w + gx];
+                if (grid.canReach(sx, sy, gx, gy) != expected) ++reachabilityErrors;
+            }
+        }
+    }
+    check(mismatches == 0, std::string(label) + ": incremental components differ from a fresh flood fill");
+    check(reachabilityErrors == 0, std::string(label) + ": canReach disagrees with a fresh flood fill");
+    if (mismatches == 0 && reachabilityErrors == 0) {
+        std::cout << "  ✓ " << label << ": " << flips << " walkability flips, labels stay exact\n";
+    }
+}
+
+// Word-at-a-time area checks must agree with testing each cell
+static void runAreaChecks(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    grid.clearAll();
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            if (roll(gen) < wallDensity) grid.setCellWalkable(x, y, false);
+        }
+    }
+
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> distX(-2, w);
+    std::uniform_int_distribution<> distY(-2, h);
+    std::uniform_int_distribution<> sizeRoll(1, 4);
+    std::uniform_int_distribution<> wideRoll(1, w);
+    int wrong = 0;
+    for (int i = 0; i < queries; ++i) {
+        int x = distX(gen), y = distY(gen);
+        int aw = (i % 8 == 0) ? wideRoll(gen) : sizeRoll(gen);
+        int ah = sizeRoll(gen);
+        bool expected = x >= 0 && y >= 0 && x + aw <= w && y + ah <= h;
+        for (int dy = 0; dy < ah && expected; ++dy) {
+            for (int dx = 0; dx < aw && expected; ++dx) {
+                expected = grid.getCell(x + dx, y + dy).isWalkable;
+            }
+        }
+        if (grid.isAreaWalkable(x, y, aw, ah) != expected) ++wrong;
+    }
+    check(wrong == 0, std::string(label) + ": area check disagrees with the cells");
+    if (wrong == 0) {
+        std::cout << "  ✓ " << label << ": " << queries << " area checks match the per-cell flags\n";
+    }
+}
+
+// Walking distance from one cell to every other (-1 = unreachable)
+static std::vector<int> bfsDistances(const CellGrid& grid, int sx, int sy) {
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::vector<int> dist(static_cast<size_t>(w) * h, -1);
+    std::queue<int> open;
+    dist[sy * w + sx] = 0;
+    open.push(sy * w + sx);
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    while (!open.empty()) {
+        int cell = open.front();
+        open.pop();
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = cell % w + dx[dir];
+            int ny = cell / w + dy[dir];
+            if (nx < 0 || ny < 0 || nx >= w || ny >= h || !grid.isCellWalkable(nx, ny)) continue;
+            if (dist[ny * w + nx] != -1) continue;
+            dist[ny * w + nx] = dist[cell] + 1;
+            open.push(ny * w + nx);
+        }
+    }
+    return dist;
+}
+
+// The nearest target by walking distance must win, with a valid path to it
+static void runNearestTarget(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    grid.clearAll();
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            if (roll(gen) < wallDensity) grid.setCellWalkable(x, y, false);
+        }
+    }
+
+    int w = grid.getWidthInCells();
+    std::uniform_int_distribution<> distX(0, w - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    std::uniform_int_distribution<> targetCount(1, 12);
+    std::uniform_int_distribution<> limitRoll(-1, 30);
+    int wrong = 0;
+    int tested = 0;
+    while (tested < queries) {
+        int sx = distX(gen), sy = distY(gen);
+        if (!grid.isCellWalkable(sx, sy)) continue;
+        ++tested;
+
+        std::vector<std::pair<int, int>> targets;
+        for (int i = targetCount(gen); i > 0; --i) targets.emplace_back(distX(gen), distY(gen));
+        int maxCost = limitRoll(gen);
+
+        auto dist = bfsDistances(grid, sx, sy);
+        int best = -1;
+        for (const auto& t : targets) {
+            int d = dist[t.second * w + t.first];
+            if (d >= 0 && (maxCost < 0 || d <= maxCost) && (best < 0 || d < best)) best = d;
+        }
+
+        std::vector<std::pair<int, int>> path;
+        int reached = nearestTargetFindPath(sx, sy, targets, grid, path, maxCost);
+        if (best < 0) {
+            if (reached != -1 || !path.empty()) ++wrong;
+            continue;
+        }
+        if (reached < 0 || static_cast<int>(path.size()) != best + 1 ||
+            path.back() != targets[reached] || !isValidPath(path, grid, sx, sy, targets[reached].first, targets[reached].second)) {
+            ++wrong;
+        }
+    }
+    check(wrong == 0, std::string(label) + ": multi-target search missed the nearest target");
+    if (wrong == 0) {
+        std::cout << "  ✓ " << label << ": " << tested << " queries, nearest target by walking distance\n";
+    }
+}
+
+// Compressed paths must expand and pop back to the original cells, and
+// copies must keep independent cursors over the shared storage
+static void runUnitPathRoundTrip(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int queries) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    grid.clearAll();
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            if (roll(gen) < wallDensity) grid.setCellWalkable(x, y, false);
+        }
+    }
+
+    std::uniform_int_distribution<> distX(0, grid.getWidthInCells() - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    int mismatches = 0;
+    int tested = 0;
+    size_t cells = 0, waypoints = 0;
+    while (tested < queries) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        auto cellPath = aStarFindPath(sx, sy, gx, gy, grid);
+        if (cellPath.empty()) continue;
+        ++tested;
+
+        UnitPath path(cellPath);
+        bool ok = path.size() == static_cast<int>(cellPath.size()) && path.toCells() == cellPath &&
+                  path.back() == cellPath.back();
+        path.forEachRun([&](int, int, int, int) { ++waypoints; });
+        cells += cellPath.size();
+
+        UnitPath copy = path;
+        for (size_t i = 0; ok && i < cellPath.size(); ++i) {
+            ok = path.front() == cellPath[i];
+            path.popFront();
+            if (i + 1 < cellPath.size()) {
+                std::vector<std::pair<int, int>> rest(cellPath.begin() + i + 1, cellPath.end());
+                ok = ok && path.toCells() == rest;
+            }
+        }
+        ok = ok && path.empty() && copy.size() == static_cast<int>(cellPath.size()) && copy.front() == cellPath.front();
+        if (!ok) ++mismatches;
+    }
+    check(mismatches == 0, std::string(label) + ": UnitPath disagrees with its cell path");
+    if (mismatches == 0) {
+        std::cout << "  ✓ " << label << ": " << tested << " paths, " << cells << " cells stored as " << waypoints << " runs\n";
+    }
+}
+
+// Units wander, food is dropped and picked up: after every change the cell
+// lists must hold exactly what a recount of the entities puts there
+static void runOccupancy(const char* label, CellGrid& grid, unsigned seed, int steps) {
+    std::mt19937 gen(seed);
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> pixelX(0, grid.getWidthInPixels() - 1);
+    std::uniform_int_distribution<> pixelY(0, grid.getHeightInPixels() - 1);
+    std::uniform_int_distribution<> action(0, 9);
+    std::uniform_int_distribution<> direction(0, 3);
+    const int DX[4] = { 1, -1, 0, 0 };
+    const int DY[4] = { 0, 0, 1, -1 };
+
+    struct Thing { int id, x, y; bool listed; };
+    std::vector<Thing> units, foods;
+    for (int i = 0; i < 30; ++i) {
+        units.push_back({ i + 1, pixelX(gen), pixelY(gen), true });
+        grid.addOccupantAtPixel(CellOccupant::Unit, units.back().id, units.back().x, units.back().y);
+    }
+    int nextFoodId = 1;
+    grid.addBuildingFootprint(BuildingKind::House, 7, 2, 3);
+
+    auto matches = [&]() {
+        std::vector<std::vector<int>> wantUnits(w * h), wantFood(w * h);
+        for (const auto& unit : units) wantUnits[(unit.y / GRID_SIZE) * w + unit.x / GRID_SIZE].push_back(unit.id);
+        for (const auto& food : foods) {
+            if (food.listed) wantFood[(food.y / GRID_SIZE) * w + food.x / GRID_SIZE].push_back(food.id);
+        }
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                std::vector<int> haveUnits, haveFood;
+                grid.getOccupants(CellOccupant::Unit, x, y, haveUnits);
+                grid.getOccupants(CellOccupant::Food, x, y, haveFood);
+                std::sort(haveUnits.begin(), haveUnits.end());
+                std::sort(haveFood.begin(), haveFood.end());
+                std::sort(wantUnits[y * w + x].begin(), wantUnits[y * w + x].end());
+                std::sort(wantFood[y * w + x].begin(), wantFood[y * w + x].end());
+                bool inHouse = x >= 2 && x < 5 && y >= 3 && y < 6;
+                BuildingSlot building = grid.getBuildingAt(x, y);
+                if (haveUnits != wantUnits[y * w + x] || haveFood != wantFood[y * w + x] ||
+                    building.isValid() != inHouse ||
+                    (inHouse && (!building.is(BuildingKind::House) || building.index != 7 ||
+                                 building.dx != x - 2 || building.dy != y - 3))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    int mismatches = 0;
+    for (int step = 0; step < steps; ++step) {
+        Thing& unit = units[step % units.size()];
+        int roll = action(gen);
+        if (roll < 6) {
+            // Step to a neighbouring cell (or bump into the edge and stay)
+            int d = direction(gen);
+            int nx = std::min(std::max(unit.x + DX[d] * GRID_SIZE, 0), grid.getWidthInPixels() - 1);
+            int ny = std::min(std::max(unit.y + DY[d] * GRID_SIZE, 0), grid.getHeightInPixels() - 1);
+            grid.moveOccupantAtPixel(CellOccupant::Unit, unit.id, unit.x, unit.y, nx, ny);
+            unit.x = nx;
+            unit.y = ny;
+        } else if (roll < 8) {
+            // Drop a new food item here
+            foods.push_back({ nextFoodId++, unit.x, unit.y, true });
+            grid.addOccupantAtPixel(CellOccupant::Food, foods.back().id, unit.x, unit.y);
+        } else if (!foods.empty()) {
+            // Pick up a listed food item, or put a carried one down here
+            Thing& food = foods[gen() % foods.size()];
+            if (food.listed) {
+                grid.removeOccupantAtPixel(CellOccupant::Food, food.id, food.x, food.y);
+            } else {
+                food.x = unit.x;
+                food.y = unit.y;
+                grid.addOccupantAtPixel(CellOccupant::Food, food.id, food.x, food.y);
+            }
+            food.listed = !food.listed;
+        }
+        if (step % 50 == 0 && !matches()) ++mismatches;
+    }
+    // Delete everything again: the lists must end up empty
+    for (const auto& unit : units) grid.removeOccupantAtPixel(CellOccupant::Unit, unit.id, unit.x, unit.y);
+    for (const auto& food : foods) {
+        if (food.listed) grid.removeOccupantAtPixel(CellOccupant::Food, food.id, food.x, food.y);
+    }
+    units.clear();
+    foods.clear();
+    grid.removeBuildingFootprint(BuildingKind::House, 7, 2, 3);
+    bool emptied = true;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            emptied &= !grid.hasOccupant(CellOccupant::Unit, x, y) && !grid.hasOccupant(CellOccupant::Food, x, y) &&
+                       !grid.getBuildingAt(x, y).isValid();
+        }
+    }
+
+    check(mismatches == 0, std::string(label) + ": cell lists drifted from the entities");
+    check(emptied, std::string(label) + ": cell lists not empty after deleting everything");
+    if (mismatches == 0 && emptied) {
+        std::cout << "  ✓ " << label << ": " << steps << " moves, drops and pickups tracked cell by cell\n";
+    }
+}
+
+// Building footprints: every cell names the first building stamped over it
+// and its slot, queries by building kind see the same, and removing a
+// building clears only the cells it still holds
+static void runBuildingFootprints(const char* label, CellGrid& grid, unsigned seed, int buildingCount) {
+    std::mt19937 gen(seed);
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> distX(-1, w - 2);
+    std::uniform_int_distribution<> distY(-1, h - 2);
+
+    struct Placed { BuildingKind kind; int index, x, y; bool removed; };
+    std::vector<Placed> buildings;
+    int nextIndex[3] = { 0, 0, 0 };
+    for (int i = 0; i < buildingCount; ++i) {
+        BuildingKind kind = static_cast<BuildingKind>(i % 3);
+        buildings.push_back({ kind, nextIndex[i % 3]++, distX(gen), distY(gen), false });
+        grid.addBuildingFootprint(kind, buildings.back().index, buildings.back().x, buildings.back().y);
+    }
+
+    // Reference: the first building placed over each cell, until it is removed
+    std::vector<int> owner(w * h, -1);
+    for (int i = 0; i < static_cast<int>(buildings.size()); ++i) {
+        for (int dx = 0; dx < 3; ++dx) {
+            for (int dy = 0; dy < 3; ++dy) {
+                int x = buildings[i].x + dx, y = buildings[i].y + dy;
+                if (x >= 0 && x < w && y >= 0 && y < h && owner[y * w + x] == -1) owner[y * w + x] = i;
+            }
+        }
+    }
+    const CellOccupant queryKind[3] = { CellOccupant::House, CellOccupant::Farm, CellOccupant::Market };
+    auto matches = [&]() {
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                BuildingSlot slot = grid.getBuildingAt(x, y);
+                int i = owner[y * w + x];
+                if (i != -1 && buildings[i].removed) i = -1;
+                if (i == -1) {
+                    if (slot.isValid()) return false;
+                    continue;
+                }
+                const Placed& want = buildings[i];
+                if (!slot.is(want.kind) || slot.index != want.index || slot.dx != x - want.x || slot.dy != y - want.y) {
+                    return false;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    std::vector<int> ids;
+                    grid.getOccupants(queryKind[k], x, y, ids);
+                    bool listed = ids.size() == 1 && ids[0] == want.index;
+                    if (listed != (k == static_cast<int>(want.kind)) || (!listed && !ids.empty())) return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    bool placedMatch = matches();
+    std::vector<int> removalOrder(buildings.size());
+    for (int i = 0; i < static_cast<int>(removalOrder.size()); ++i) removalOrder[i] = i;
+    std::shuffle(removalOrder.begin(), removalOrder.end(), gen);
+    for (size_t i = 0; i < removalOrder.size() / 2; ++i) {
+        Placed& building = buildings[removalOrder[i]];
+        grid.removeBuildingFootprint(building.kind, building.index, building.x, building.y);
+        building.removed = true;
+    }
+    bool removedMatch = matches();
+    for (auto& building : buildings) {
+        grid.removeBuildingFootprint(building.kind, building.index, building.x, building.y);
+        building.removed = true;
+    }
+
+    check(placedMatch, std::string(label) + ": building plane disagrees with the placed footprints");
+    check(removedMatch, std::string(label) + ": removing buildings cleared the wrong cells");
+    check(grid.getResidentChunkCount() == 0, std::string(label) + ": chunks still resident after removing every building");
+    if (placedMatch && removedMatch && grid.getResidentChunkCount() == 0) {
+        std::cout << "  ✓ " << label << ": " << buildingCount << " overlapping footprints stamped and removed\n";
+    }
+}
+
+// Random inserts and erases against a map of what should be live: every
+// live handle resolves to its value, every erased one reads as missing even
+// after its slot is reused, and the dense items are exactly the live values
+static void runSlotMap(const char* label, unsigned seed, int operations) {
+    std::mt19937 gen(seed);
+    SlotMap<int> slots;
+    std::vector<std::pair<int, int>> live; // (handle, value)
+    std::vector<int> erased;
+    int nextValue = 0;
+    bool valid = true;
+    for (int i = 0; i < operations && valid; ++i) {
+        if (live.empty() || gen() % 5 < 3) {
+            int handle = slots.insert(nextValue);
+            valid &= handle > 0;
+            live.emplace_back(handle, nextValue++);
+        } else {
+            size_t pick = gen() % live.size();
+            valid &= slots.erase(live[pick].first) && !slots.erase(live[pick].first);
+            erased.push_back(live[pick].first);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        if (i % 100 == 0) {
+            for (const auto& entry : live) {
+                const int* value = slots.tryGet(entry.first);
+                valid &= value && *value == entry.second;
+            }
+            for (int handle : erased) valid &= !slots.contains(handle) && slots.tryGet(handle) == nullptr;
+            std::vector<int> dense(slots.getItems().begin(), slots.getItems().end());
+            std::vector<int> want;
+            for (const auto& entry : live) want.push_back(entry.second);
+            std::sort(dense.begin(), dense.end());
+            std::sort(want.begin(), want.end());
+            valid &= dense == want;
+        }
+    }
+    valid &= !slots.contains(-1) && !slots.contains(0);
+
+    // Filling every index is fine; one more must fail instead of aliasing a live handle
+    SlotMap<char> full;
+    std::vector<char> seen(SlotMap<char>::INDEX_MASK + 1, 0);
+    bool distinct = true;
+    int firstHandle = 0;
+    for (uint32_t i = 0; i <= SlotMap<char>::INDEX_MASK; ++i) {
+        int handle = full.insert(0);
+        if (i == 0) firstHandle = handle;
+        char& mark = seen[static_cast<uint32_t>(handle) & SlotMap<char>::INDEX_MASK];
+        distinct &= mark == 0;
+        mark = 1;
+    }
+    bool refused = false;
+    try {
+        full.insert(0);
+    } catch (const std::length_error&) {
+        refused = true;
+    }
+    // A freed slot can still be handed out
+    full.erase(firstHandle);
+    bool reusesFreed = true;
+    try {
+        reusesFreed = full.insert(0) > 0;
+    } catch (const std::length_error&) {
+        reusesFreed = false;
+    }
+
+    check(valid, std::string(label) + ": a handle resolved to the wrong item");
+    bool limited = distinct && refused && reusesFreed;
+    check(limited, std::string(label) + ": slot map did not stop at its index limit");
+    if (valid && limited) {
+        std::cout << "  ✓ " << label << ": " << operations << " inserts and erases, " << erased.size()
+                  << " stale handles rejected\n";
+    }
+}
+
+// The managers' ownership indexes must agree with a scan of every item after
+// any sequence of adds, removes and ownership changes: FoodManager's free
+// food set, and SeedManager's collectable seeds per owner
+static void runItemIndexes(const char* label, unsigned seed, int operations) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> pickOp(0, 6);
+    std::uniform_int_distribution<> pickOwner(-1, 3); // A few units, so owners collide
+    std::uniform_int_distribution<> pickFarm(-1, 2);
+
+    FoodManager foodManager;
+    SeedManager seedManager;
+    auto pickIndex = [&](size_t size) {
+        return std::uniform_int_distribution<size_t>(0, size - 1)(gen);
+    };
+
+    int freeFoodWrong = 0, collectableWrong = 0;
+    for (int op = 0; op < operations; ++op) {
+        const std::vector<Food>& foods = foodManager.getFood();
+        const std::vector<Seed>& seeds = seedManager.getSeeds();
+        switch (pickOp(gen)) {
+        case 0:
+            foodManager.addFood(op, op, "apple");
+            seedManager.addSeed(op, op, "wheat");
+            break;
+        case 1:
+            if (!foods.empty()) foodManager.removeFood(foods[pickIndex(foods.size())].foodId);
+            if (!seeds.empty()) seedManager.removeSeed(seeds[pickIndex(seeds.size())].seedId);
+            break;
+        case 2:
+            if (!foods.empty()) foodManager.setCarriedBy(foodManager.get(foods[pickIndex(foods.size())].foodId), pickOwner(gen));
+            break;
+        case 3:
+            if (!foods.empty()) foodManager.setOwnedBy(foodManager.get(foods[pickIndex(foods.size())].foodId), pickOwner(gen));
+            break;
+        case 4:
+            if (!seeds.empty()) seedManager.setCarriedBy(seedManager.get(seeds[pickIndex(seeds.size())].seedId), pickOwner(gen));
+            break;
+        case 5:
+            if (!seeds.empty()) seedManager.setOwnedBy(seedManager.get(seeds[pickIndex(seeds.size())].seedId), pickOwner(gen));
+            break;
+        default:
+            if (!seeds.empty()) seedManager.setPlantedInFarm(seedManager.get(seeds[pickIndex(seeds.size())].seedId), pickFarm(gen));
+            break;
+        }
+
+        // Reference: scan every item
+        std::unordered_set<int> wantFree;
+        for (const Food& food : foodManager.getFood()) {
+            if (food.carriedByUnitId == -1 && food.ownedByHouseId == -1) wantFree.insert(food.foodId);
+        }
+        if (foodManager.getFreeFood() != wantFree || foodManager.hasFreeFood() != !wantFree.empty()) ++freeFoodWrong;
+        for (int unitId = -1; unitId <= 4; ++unitId) {
+            bool want = false;
+            for (const Seed& s : seedManager.getSeeds()) {
+                want = want || SeedManager::isCollectableBy(s, unitId);
+            }
+            if (seedManager.hasCollectableSeed(unitId) != want) ++collectableWrong;
+        }
+    }
+
+    check(freeFoodWrong == 0, std::string(label) + ": free food set disagrees with a scan of the food");
+    check(collectableWrong == 0, std::string(label) + ": collectable seed index disagrees with a scan of the seeds");
+    if (freeFoodWrong == 0 && collectableWrong == 0) {
+        std::cout << "  ✓ " << label << ": " << operations << " adds, removes and ownership changes, "
+                  << foodManager.getFood().size() << " food and " << seedManager.getSeeds().size() << " seeds left\n";
+    }
+}
+
+// Radius, nearest and k-nearest queries must agree with a scan of every item
+static void runSpatialQueries(const char* label, CellGrid& grid, unsigned seed, int itemCount, int queries) {
+    std::mt19937 gen(seed);
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> distX(0, w - 1);
+    std::uniform_int_distribution<> distY(0, h - 1);
+    std::uniform_int_distribution<> distRadius(-1, 12);
+
+    struct Item { int id, x, y; };
+    std::vector<Item> items;
+    for (int i = 0; i < itemCount; ++i) {
+        items.push_back({ i + 1, distX(gen), distY(gen) });
+        grid.addOccupant(CellOccupant::Coin, items.back().id, items.back().x, items.back().y);
+    }
+    auto isEven = [](int id, int, int) { return id % 2 == 0; };
+
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        int cx = distX(gen), cy = distY(gen), radius = distRadius(gen);
+        auto distance = [&](const Item& item) { return std::abs(item.x - cx) + std::abs(item.y - cy); };
+        auto inRange = [&](const Item& item) { return radius < 0 || distance(item) <= radius; };
+
+        std::vector<int> expected, found;
+        for (const auto& item : items) {
+            if (inRange(item)) expected.push_back(item.id);
+        }
+        int lastDistance = 0;
+        bool ordered = true;
+        grid.forEachInRadius(CellOccupant::Coin, cx, cy, radius, [&](int id, int x, int y) {
+            int d = std::abs(x - cx) + std::abs(y - cy);
+            ordered &= d >= lastDistance;
+            lastDistance = d;
+            found.push_back(id);
+        });
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        if (found != expected || !ordered) ++mismatches;
+
+        // Nearest even id: any item at the smallest distance will do
+        int best = -1;
+        for (const auto& item : items) {
+            if (inRange(item) && item.id % 2 == 0 && (best == -1 || distance(item) < best)) best = distance(item);
+        }
+        int nearestX = -1, nearestY = -1;
+        int nearest = grid.findNearest(CellOccupant::Coin, cx, cy, radius, isEven, &nearestX, &nearestY);
+        if (best == -1 ? nearest != -1 : (nearest == -1 || nearest % 2 != 0 ||
+            std::abs(nearestX - cx) + std::abs(nearestY - cy) != best)) {
+            ++mismatches;
+        }
+
+        // The k nearest even ids must have the k smallest distances, in order
+        std::vector<int> evenDistances;
+        for (const auto& item : items) {
+            if (inRange(item) && item.id % 2 == 0) evenDistances.push_back(distance(item));
+        }
+        std::sort(evenDistances.begin(), evenDistances.end());
+        const size_t k = 5;
+        std::vector<int> nearestIds;
+        grid.nearestK(CellOccupant::Coin, cx, cy, static_cast<int>(k), radius, isEven, nearestIds);
+        bool kMatches = nearestIds.size() == std::min(k, evenDistances.size());
+        for (size_t i = 0; kMatches && i < nearestIds.size(); ++i) {
+            const Item& item = items[nearestIds[i] - 1];
+            kMatches = item.id % 2 == 0 && distance(item) == evenDistances[i];
+        }
+        if (!kMatches) ++mismatches;
+    }
+
+    for (const auto& item : items) grid.removeOccupant(CellOccupant::Coin, item.id, item.x, item.y);
+    check(mismatches == 0, std::string(label) + ": " + std::to_string(mismatches) + " queries disagree with a full scan");
+    if (mismatches == 0) {
+        std::cout << "  ✓ " << label << ": " << queries << " radius / nearest / k-nearest queries match a full scan\n";
+    }
+}
+
+struct CrowdResult {
+    int conflicts = 0; // Walking units on one cell, or swapping places
+    int badSteps = 0;  // Moves longer than one cell
+    int arrived = 0;
+    int ticks = 0;
+};
+
+// Walk a crowd one step per tick, through the cooperative planner if given
+static CrowdResult walkCrowd(std::vector<std::pair<std::pair<int, int>, UnitPath>> walkers, CooperativePlanner* planner) {
+    CrowdResult result;
+    std::vector<std::pair<int, int>> goals;
+    for (const auto& walker : walkers) goals.push_back(walker.second.back());
+
+    for (; result.ticks < 1000; ++result.ticks) {
+        if (planner) {
+            planner->beginTick();
+            for (size_t i = 0; i < walkers.size(); ++i) {
+                auto& position = walkers[i].first;
+                planner->update(static_cast<int>(i) + 1, position.first, position.second, 1, walkers[i].second);
+            }
+        }
+
+        std::vector<std::pair<int, int>> before;
+        bool anyWalking = false;
+        for (auto& walker : walkers) {
+            before.push_back(walker.first);
+            if (walker.second.empty()) continue;
+            anyWalking = true;
+            auto next = walker.second.front();
+            walker.second.popFront();
+            if (std::abs(next.first - walker.first.first) + std::abs(next.second - walker.first.second) > 1) ++result.badSteps;
+            walker.first = next;
+        }
+        if (!anyWalking) break;
+
+        for (size_t i = 0; i < walkers.size(); ++i) {
+            for (size_t j = i + 1; j < walkers.size(); ++j) {
+                // Units that have arrived stand aside; only walkers must keep apart
+                if (walkers[i].second.empty() || walkers[j].second.empty()) continue;
+                bool sameCell = walkers[i].first == walkers[j].first;
+                bool swapped = before[i] != before[j] && before[i] == walkers[j].first && before[j] == walkers[i].first;
+                if (sameCell || swapped) ++result.conflicts;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < walkers.size(); ++i) {
+        if (walkers[i].first == goals[i]) ++result.arrived;
+    }
+    return result;
+}
+
+// A crowd crossing the grid. On an open grid the planner must keep walking
+// units from ever sharing a cell or swapping places; among walls a unit can
+// still get boxed into a corridor, so there it must only cut the conflicts
+// of the same crowd walking blind by a wide margin. Every unit must arrive.
+static void runCrowd(const char* label, CellGrid& grid, double wallDensity, unsigned seed, int unitCount) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> roll(0.0, 1.0);
+    grid.clearAll();
+    for (int y = 0; y < grid.getHeightInCells(); ++y) {
+        for (int x = 0; x < grid.getWidthInCells(); ++x) {
+            if (roll(gen) < wallDensity) grid.setCellWalkable(x, y, false);
+        }
+    }
+
+    int w = grid.getWidthInCells();
+    std::uniform_int_distribution<> distX(0, w - 1);
+    std::uniform_int_distribution<> distY(0, grid.getHeightInCells() - 1);
+    std::vector<std::pair<std::pair<int, int>, UnitPath>> walkers;
+    std::vector<bool> taken(static_cast<size_t>(w) * grid.getHeightInCells(), false);
+    while (static_cast<int>(walkers.size()) < unitCount) {
+        int sx = distX(gen), sy = distY(gen), gx = distX(gen), gy = distY(gen);
+        if (taken[sy * w + sx]) continue;
+        auto path = aStarFindPath(sx, sy, gx, gy, grid);
+        if (path.size() < 5) continue;
+        taken[sy * w + sx] = true;
+        walkers.emplace_back(std::make_pair(sx, sy), UnitPath(path));
+    }
+
+    CrowdResult blind = walkCrowd(walkers, nullptr);
+    CooperativePlanner planner(grid, 8, 4, unitCount / 8);
+    CrowdResult planned = walkCrowd(walkers, &planner);
+    CooperativeStats stats = planner.getStats();
+
+    bool fewConflicts = wallDensity == 0.0 ? planned.conflicts == 0 : planned.conflicts * 10 <= blind.conflicts;
+    check(fewConflicts, std::string(label) + ": walking units collided or swapped places " + std::to_string(planned.conflicts) + " times");
+    check(planned.badSteps == 0, std::string(label) + ": a rerouted path skipped a cell");
+    check(planned.arrived == unitCount, std::string(label) + ": not every unit reached its goal");
+    check(stats.deferred > 0, std::string(label) + ": the per-tick replan cap never deferred a window");
+    if (fewConflicts && planned.badSteps == 0 && planned.arrived == unitCount && stats.deferred > 0) {
+        std::cout << "  ✓ " << label << ": " << unitCount << " units arrived in " << planned.ticks << " ticks (" << blind.ticks
+                  << " blind), " << planned.conflicts << " conflicts (" << blind.conflicts << " blind), "
+                  << stats.rerouted << " windows rerouted\n";
+    }
+}
+
+// A huge mostly empty grid: chunks must come and go with their contents,
+// reads of empty chunks must see defaults, and whole-grid queries must still
+// find the nearest item
+static void runChunkedGrid(const char* label, CellGrid& grid, unsigned seed, int itemCount, int queries) {
+    std::mt19937 gen(seed);
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> distX(0, w - 1);
+    std::uniform_int_distribution<> distY(0, h - 1);
+
+    struct Item { int id, x, y; };
+    std::vector<Item> coins, walls, tiles;
+    std::set<std::pair<int, int>> touched;
+    for (int i = 0; i < itemCount; ++i) {
+        Item item{ i + 1, distX(gen), distY(gen) };
+        touched.insert({ item.x / CellGrid::CHUNK_SIZE, item.y / CellGrid::CHUNK_SIZE });
+        if (i % 3 == 0) {
+            coins.push_back(item);
+            grid.addOccupant(CellOccupant::Coin, item.id, item.x, item.y);
+        } else if (i % 3 == 1 && grid.isCellWalkable(item.x, item.y)) {
+            walls.push_back(item);
+            grid.setCellWalkable(item.x, item.y, false);
+        } else if (!grid.hasTile(item.x, item.y)) {
+            tiles.push_back(item);
+            grid.setCellTile(item.x, item.y, true);
+        }
+    }
+
+    std::set<std::pair<int, int>> resident;
+    grid.forEachResidentChunk([&](const CellGrid::ChunkArea& area) { resident.insert({ area.chunkX, area.chunkY }); });
+    bool chunksMatch = resident == touched && grid.getResidentChunkCount() == static_cast<int>(touched.size());
+
+    // Cells in chunks nothing was put into read as open and empty
+    bool defaultsHold = true;
+    for (int i = 0; i < queries; ++i) {
+        int x = distX(gen), y = distY(gen);
+        if (touched.count({ x / CellGrid::CHUNK_SIZE, y / CellGrid::CHUNK_SIZE })) continue;
+        MapCell cell = grid.getCell(x, y);
+        defaultsHold &= cell.isWalkable && !cell.hasTile && !cell.hasBuilding() && !grid.hasOccupant(CellOccupant::Coin, x, y);
+    }
+
+    int mismatches = 0;
+    for (int q = 0; q < queries / 10; ++q) {
+        int cx = distX(gen), cy = distY(gen);
+        int best = -1;
+        for (const auto& coin : coins) {
+            int d = std::abs(coin.x - cx) + std::abs(coin.y - cy);
+            if (best == -1 || d < best) best = d;
+        }
+        int foundX = -1, foundY = -1;
+        int found = grid.findNearest(CellOccupant::Coin, cx, cy, -1, [](int, int, int) { return true; }, &foundX, &foundY);
+        if ((found == -1) != (best == -1) || (found != -1 && std::abs(foundX - cx) + std::abs(foundY - cy) != best)) ++mismatches;
+    }
+
+    // Take the coins and walls away and clear the tiles: every chunk goes
+    // back, while a copy taken beforehand keeps its own view
+    CellGrid snapshot(grid);
+    for (const auto& coin : coins) grid.removeOccupant(CellOccupant::Coin, coin.id, coin.x, coin.y);
+    for (const auto& wall : walls) grid.setCellWalkable(wall.x, wall.y, true);
+    grid.clearAll();
+    bool released = grid.getResidentChunkCount() == 0 && grid.findNearest(CellOccupant::Coin, 0, 0, -1, [](int, int, int) { return true; }) == -1;
+    bool snapshotKept = snapshot.getResidentChunkCount() == static_cast<int>(touched.size());
+    for (const auto& coin : coins) snapshotKept &= snapshot.hasOccupant(CellOccupant::Coin, coin.x, coin.y);
+    for (const auto& tile : tiles) snapshotKept &= snapshot.hasTile(tile.x, tile.y);
+
+    check(chunksMatch, std::string(label) + ": resident chunks differ from the chunks written to");
+    check(defaultsHold, std::string(label) + ": an untouched cell does not read as empty");
+    check(mismatches == 0, std::string(label) + ": whole-grid nearest query missed the nearest coin");
+    check(released, std::string(label) + ": chunks still resident after emptying the grid");
+    check(snapshotKept, std::string(label) + ": emptying the grid changed a copy of it");
+    if (chunksMatch && defaultsHold && mismatches == 0 && released && snapshotKept) {
+        std::cout << "  ✓ " << label << ": " << w << "x" << h << " cells, " << touched.size() << " of "
+                  << grid.getWidthInChunks() * grid.getHeightInChunks() << " chunks resident, " << queries / 10
+                  << " whole-grid queries\n";
+    }
+}
+
+// Subscribers must see exactly the chunks changed in their layers, and the
+// path cache must keep paths away from the changes once the cell log has
+// run out
+static void runChangeTracking(const char* label, CellGrid& grid, unsigned seed, int changes) {
+    std::mt19937 gen(seed);
+    int w = grid.getWidthInCells();
+    int h = grid.getHeightInCells();
+    std::uniform_int_distribution<> distX(0, w - 1);
+    std::uniform_int_distribution<> distY(0, h - 1);
+    std::uniform_int_distribution<> action(0, 3);
+    int widthInChunks = grid.getWidthInChunks();
+    auto chunkOf = [&](int x, int y) { return (y / CellGrid::CHUNK_SIZE) * widthInChunks + x / CellGrid::CHUNK_SIZE; };
+
+    GridChangeSubscriber walls(grid, { GridLayer::Walkability });
+    GridChangeSubscriber contents(grid, { GridLayer::Occupancy, GridLayer::Buildings });
+    std::set<int> wantWalls, wantContents;
+    uint64_t walkabilityBefore = grid.getWalkabilityVersion();
+    int mismatches = 0;
+    int nextId = 1;
+    for (int i = 0; i < changes; ++i) {
+        int x = distX(gen), y = distY(gen);
+        switch (action(gen)) {
+        case 0:
+            grid.setCellWalkable(x, y, !grid.isCellWalkable(x, y));
+            wantWalls.insert(chunkOf(x, y));
+            break;
+        case 1:
+            grid.addOccupant(CellOccupant::Food, nextId++, x, y);
+            wantContents.insert(chunkOf(x, y));
+            break;
+        case 2:
+            // Only the cells no earlier building covers change
+            for (int dx = 0; dx < 3; ++dx) {
+                for (int dy = 0; dy < 3; ++dy) {
+                    if (x + dx < w && y + dy < h && !grid.getBuildingAt(x + dx, y + dy).isValid()) {
+                        wantContents.insert(chunkOf(x + dx, y + dy));
+                    }
+                }
+            }
+            grid.addBuildingFootprint(BuildingKind::House, nextId++, x, y);
+            break;
+        default:
+            grid.setCellTile(x, y, true); // Tiles: neither subscriber cares
+            break;
+        }
+        if (i % 100 == 99) {
+            std::vector<int> haveWalls, haveContents;
+            walls.takeChangedChunks(haveWalls);
+            contents.takeChangedChunks(haveContents);
+            if (std::set<int>(haveWalls.begin(), haveWalls.end()) != wantWalls || haveWalls.size() != wantWalls.size()) ++mismatches;
+            if (std::set<int>(haveContents.begin(), haveContents.end()) != wantContents || haveContents.size() != wantContents.size()) ++mismatches;
+            wantWalls.clear();
+            wantContents.clear();
+        }
+    }
+    std::vector<int> sinceStart;
+    grid.getChangedChunksSince(GridLayer::Walkability, walkabilityBefore, sinceStart);
+    bool historyKept = !sinceStart.empty() && !walls.hasChanges() && !contents.hasChanges();
+
+    // Cache a path in the top row, then flip more cells than the cell log
+    // holds, all below the top chunk row: the path must survive, and one
+    // through a changed chunk must not
+    grid.clearAll();
+    PathCache cache(grid, 16);
+    std::vector<std::pair<int, int>> topRow, crossing;
+    for (int x = 0; x < CellGrid::CHUNK_SIZE; ++x) topRow.push_back({ x, 0 });
+    for (int y = 0; y < h; ++y) crossing.push_back({ 0, y });
+    cache.store(0, 0, CellGrid::CHUNK_SIZE - 1, 0, topRow);
+    cache.store(0, 0, 0, h - 1, crossing);
+    for (int i = 0; i < 5000; ++i) {
+        int x = 1 + i % (w - 1);
+        int y = CellGrid::CHUNK_SIZE + (i / (w - 1)) % (h - CellGrid::CHUNK_SIZE);
+        grid.setCellWalkable(x, y, !grid.isCellWalkable(x, y));
+    }
+    std::vector<std::pair<int, int>> cached;
+    std::vector<int> cells;
+    bool logRanOut = !grid.getWalkabilityChangesSince(0, cells);
+    bool kept = cache.lookup(0, 0, CellGrid::CHUNK_SIZE - 1, 0, cached) && cached == topRow;
+    bool dropped = !cache.lookup(0, 0, 0, h - 1, cached);
+
+    check(mismatches == 0, std::string(label) + ": a subscriber saw the wrong chunks");
+    check(historyKept, std::string(label) + ": changed chunks since the start were lost");
+    check(logRanOut && kept && dropped, std::string(label) + ": path cache fallback dropped the wrong paths");
+    if (mismatches == 0 && historyKept && logRanOut && kept && dropped) {
+        std::cout << "  ✓ " << label << ": " << changes << " changes seen chunk by chunk, path cache kept what the cell log lost\n";
+    }
+}
+
+int main() {
+    std::cout << "=== Pathfinding Tests ===\n";
+
+    CellGrid grid(sdlWindowWidth, sdlWindowHeight);
+    runParity("Open grid", grid, 0.0, 1, 2000);
+    runParity("10% walls", grid, 0.10, 2, 2000);
+    runParity("30% walls", grid, 0.30, 3, 2000);
+    runParity("45% walls", grid, 0.45, 4, 2000);
+
+    CellGrid world(sdlWindowWidth * 3, sdlWindowHeight * 3);
+    runParity("9-region world, 20% walls", world, 0.20, 5, 500);
+    runHierarchical("HPA*, 9-region world, 20% walls", world, 0.20, 24, 300);
+    runHierarchical("HPA*, 9-region world, 35% walls", world, 0.35, 25, 300);
+
+    CellGrid fields(sdlWindowWidth, sdlWindowHeight);
+    runFlowFields("Flow fields, 15% walls", fields, 0.15, 26, 12, 60);
+    runFlowFields("Flow fields, 35% walls", fields, 0.35, 27, 12, 60);
+
+    // One region, so every request goes through findPath() like the reference
+    CellGrid async(sdlWindowWidth, sdlWindowHeight);
+    runAsyncService("Async path service, 25% walls", async, 0.25, 28, 200);
+
+    CellGrid resumable(sdlWindowWidth, sdlWindowHeight);
+    runResumableSearch("Resumable search, 20% walls", resumable, 0.20, 31, 400);
+    runResumableSearch("Resumable search, 35% walls", resumable, 0.35, 32, 400);
+
+    CellGrid chase(sdlWindowWidth, sdlWindowHeight);
+    runMovingTarget("Moving target, 15% walls", chase, 0.15, 29, 2000);
+    runMovingTarget("Moving target, 30% walls", chase, 0.30, 30, 2000);
+
+    CellGrid cached(sdlWindowWidth, sdlWindowHeight);
+    runPathCache("Path cache, 20% walls", cached, 0.20, 33, 4000);
+    runPathCache("Path cache, 40% walls", cached, 0.40, 34, 4000);
+
+    // Start == goal returns the single start cell from both backends
+    CellGrid small(GRID_SIZE * 4, GRID_SIZE * 4);
+    check(findPath(1, 1, 1, 1, small).size() == 1, "start == goal should give a one-cell path");
+
+    // Walled-off goal is unreachable for both
+    small.setCellWalkable(2, 3, false);
+    small.setCellWalkable(3, 2, false);
+    check(aStarFindPath(0, 0, 3, 3, small).empty(), "A* should not reach an enclosed corner");
+    check(jpsFindPath(0, 0, 3, 3, small).empty(), "JPS should not reach an enclosed corner");
+    check(getThreadPathSearchContext().getLastExpandedCount() == 0,
+          "an unreachable goal should be rejected without expanding any node");
+
+    // Component labels under random walkability churn
+    CellGrid churn(sdlWindowWidth, sdlWindowHeight);
+    runComponentChurn("Components, 35% walls", churn, 0.35, 6, 5000);
+    runComponentChurn("Components, 55% walls", churn, 0.55, 7, 5000);
+    runComponentChurn("Components, 9-region world", world, 0.40, 8, 3000);
+
+    CellGrid areas(sdlWindowWidth * 3, sdlWindowHeight);
+    runAreaChecks("Area checks, 10% walls", areas, 0.10, 13, 5000);
+    runAreaChecks("Area checks, 2% walls", areas, 0.02, 14, 5000);
+
+    CellGrid targets(sdlWindowWidth, sdlWindowHeight);
+    runNearestTarget("Nearest target, 25% walls", targets, 0.25, 11, 1000);
+    runNearestTarget("Nearest target, 45% walls", targets, 0.45, 12, 1000);
+
+    CellGrid paths(sdlWindowWidth, sdlWindowHeight);
+    runUnitPathRoundTrip("UnitPath, open grid", paths, 0.0, 9, 500);
+    runUnitPathRoundTrip("UnitPath, 30% walls", paths, 0.30, 10, 500);
+
+    CellGrid occupancy(sdlWindowWidth, sdlWindowHeight);
+    runOccupancy("Occupancy lists", occupancy, 18, 5000);
+    runSpatialQueries("Spatial queries", occupancy, 19, 400, 2000);
+
+    CellGrid footprints(sdlWindowWidth, sdlWindowHeight);
+    runBuildingFootprints("Building footprints", footprints, 22, 300);
+    runSlotMap("Item slot map", 23, 20000);
+    runItemIndexes("Item ownership indexes", 35, 20000);
+
+    CellGrid changes(sdlWindowWidth * 2, sdlWindowHeight * 2);
+    runChangeTracking("Change tracking", changes, 21, 3000);
+
+    CellGrid huge(4096 * GRID_SIZE, 4096 * GRID_SIZE);
+    runChunkedGrid("Chunked 4096x4096 grid", huge, 20, 3000, 5000);
+
+    CellGrid crowd(sdlWindowWidth, sdlWindowHeight);
+    runCrowd("Crowd, open grid", crowd, 0.0, 15, 120);
+    runCrowd("Crowd, 15% walls", crowd, 0.15, 16, 120);
+    runCrowd("Crowd, 30% walls", crowd, 0.30, 17, 120);
+
+    if (failures == 0) {
+        std::cout << "All pathfinding tests passed\n";
+        return 0;
+    }
+    std::cout << failures << " pathfinding check(s) failed\n";
+    return 1;
+}